@@ -24,6 +24,7 @@
 #include <DirectXMath.h>
 
 #include "../utility/log.h"
+#include "../utility/resource_state_tracker.h"
 
 namespace Takoyaki
 {
@@ -42,6 +43,24 @@ namespace Takoyaki
         }
     }
 
+    void ResourceBarriers(ID3D12GraphicsCommandList* commands, const std::vector<ResourceTransition>& transitions)
+    {
+        if (transitions.empty())
+            return;
+
+        std::vector<D3D12_RESOURCE_BARRIER> barriers;
+
+        barriers.reserve(transitions.size());
+
+        for (auto& transition : transitions) {
+            auto resource = static_cast<ID3D12Resource*>(transition.resource);
+
+            barriers.push_back(TransitionBarrier(resource, static_cast<D3D12_RESOURCE_STATES>(transition.before), static_cast<D3D12_RESOURCE_STATES>(transition.after)));
+        }
+
+        commands->ResourceBarrier(static_cast<uint_fast32_t>(barriers.size()), &barriers.front());
+    }
+
     D3D12_RESOURCE_BARRIER TransitionBarrier(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after)
     {
         D3D12_RESOURCE_BARRIER res;
@@ -163,6 +182,25 @@ namespace Takoyaki
         return D3D12_FILL_MODE_WIREFRAME;
     }
 
+    D3D12_FILTER FilterToDX(EFilter filter)
+    {
+        // https://msdn.microsoft.com/en-us/library/windows/desktop/dn770367(v=vs.85).aspx
+        switch (filter) {
+            case EFilter::POINT:
+                return D3D12_FILTER_MIN_MAG_MIP_POINT;
+            case EFilter::ANISOTROPIC:
+                return D3D12_FILTER_ANISOTROPIC;
+            case EFilter::COMPARISON_POINT:
+                return D3D12_FILTER_COMPARISON_MIN_MAG_MIP_POINT;
+            case EFilter::COMPARISON_LINEAR:
+                return D3D12_FILTER_COMPARISON_MIN_MAG_MIP_LINEAR;
+            case EFilter::COMPARISON_ANISOTROPIC:
+                return D3D12_FILTER_COMPARISON_ANISOTROPIC;
+        }
+
+        return D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    }
+
     DXGI_FORMAT FormatToDX(EFormat format)
     {
         // https://msdn.microsoft.com/en-us/library/windows/desktop/bb173059(v=vs.85).aspx
@@ -180,6 +218,23 @@ namespace Takoyaki
         return DXGI_FORMAT_UNKNOWN;
     }
 
+    uint_fast32_t GetFormatSize(EFormat format)
+    {
+        // bytes per texel or element
+        switch (format) {
+            case EFormat::B8G8R8A8_UNORM:
+                return 4;
+
+            case EFormat::R16_UINT:
+                return 2;
+
+            case EFormat::R32G32B32_FLOAT:
+                return 12;
+        }
+
+        return 0;
+    }
+
     std::string GetDXError(HRESULT code)
     {
         // https://msdn.microsoft.com/en-us/library/windows/desktop/ff476174(v=vs.85).aspx
@@ -272,6 +327,35 @@ namespace Takoyaki
         return res;
     }
 
+    D3D12_RESOURCE_STATES ResourceStateToDX(EResourceState state)
+    {
+        switch (state) {
+            case EResourceState::COPY_DEST:
+                return D3D12_RESOURCE_STATE_COPY_DEST;
+            case EResourceState::COPY_SOURCE:
+                return D3D12_RESOURCE_STATE_COPY_SOURCE;
+            case EResourceState::RENDER_TARGET:
+                return D3D12_RESOURCE_STATE_RENDER_TARGET;
+            case EResourceState::SHADER_READ:
+                return D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        }
+
+        return D3D12_RESOURCE_STATE_COMMON;
+    }
+
+    D3D12_STATIC_BORDER_COLOR StaticBorderColorToDX(EBorderColor color)
+    {
+        // https://msdn.microsoft.com/en-us/library/windows/desktop/dn903816(v=vs.85).aspx
+        switch (color) {
+            case EBorderColor::TRANSPARENT_BLACK:
+                return D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+            case EBorderColor::OPAQUE_BLACK:
+                return D3D12_STATIC_BORDER_COLOR_OPAQUE_BLACK;
+        }
+
+        return D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE;
+    }
+
     D3D12_STENCIL_OP StencilOpToDX(EStencilOp op)
     {
         // https://msdn.microsoft.com/en-us/library/windows/desktop/dn770409(v=vs.85).aspx
@@ -295,6 +379,23 @@ namespace Takoyaki
         return D3D12_STENCIL_OP_KEEP;
     }
 
+    D3D12_TEXTURE_ADDRESS_MODE TextureAddressModeToDX(ETextureAddressMode mode)
+    {
+        // https://msdn.microsoft.com/en-us/library/windows/desktop/dn770441(v=vs.85).aspx
+        switch (mode) {
+            case ETextureAddressMode::WRAP:
+                return D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+            case ETextureAddressMode::MIRROR:
+                return D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
+            case ETextureAddressMode::BORDER:
+                return D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+            case ETextureAddressMode::MIRROR_ONCE:
+                return D3D12_TEXTURE_ADDRESS_MODE_MIRROR_ONCE;
+        }
+
+        return D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    }
+
     D3D12_PRIMITIVE_TOPOLOGY TopologyToDX(ETopology value)
     {
         // https://msdn.microsoft.com/en-us/library/windows/desktop/ff728726(v=vs.85).aspx
@@ -408,6 +509,53 @@ namespace Takoyaki
         return res;
     }
 
+    D3D12_SAMPLER_DESC SamplerDescToDX(const SamplerDesc& desc)
+    {
+        D3D12_SAMPLER_DESC res;
+
+        res.AddressU = TextureAddressModeToDX(desc.addressU);
+        res.AddressV = TextureAddressModeToDX(desc.addressV);
+        res.AddressW = TextureAddressModeToDX(desc.addressW);
+        res.ComparisonFunc = CompFuncToDX(desc.comparisonFunc);
+        res.Filter = FilterToDX(desc.filter);
+        res.MaxAnisotropy = desc.maxAnisotropy;
+        res.MaxLOD = desc.maxLOD;
+        res.MinLOD = desc.minLOD;
+        res.MipLODBias = desc.mipLODBias;
+
+        // same colors as the static ones so both kinds of samplers behave the same
+        float alpha = (desc.borderColor == EBorderColor::TRANSPARENT_BLACK) ? 0.f : 1.f;
+        float color = (desc.borderColor == EBorderColor::OPAQUE_WHITE) ? 1.f : 0.f;
+
+        res.BorderColor[0] = color;
+        res.BorderColor[1] = color;
+        res.BorderColor[2] = color;
+        res.BorderColor[3] = alpha;
+
+        return res;
+    }
+
+    D3D12_STATIC_SAMPLER_DESC StaticSamplerDescToDX(const SamplerDesc& desc, uint_fast32_t shaderRegister)
+    {
+        D3D12_STATIC_SAMPLER_DESC res;
+
+        res.AddressU = TextureAddressModeToDX(desc.addressU);
+        res.AddressV = TextureAddressModeToDX(desc.addressV);
+        res.AddressW = TextureAddressModeToDX(desc.addressW);
+        res.BorderColor = StaticBorderColorToDX(desc.borderColor);
+        res.ComparisonFunc = CompFuncToDX(desc.comparisonFunc);
+        res.Filter = FilterToDX(desc.filter);
+        res.MaxAnisotropy = desc.maxAnisotropy;
+        res.MaxLOD = desc.maxLOD;
+        res.MinLOD = desc.minLOD;
+        res.MipLODBias = desc.mipLODBias;
+        res.RegisterSpace = 0;
+        res.ShaderRegister = shaderRegister;
+        res.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+        return res;
+    }
+
     D3D12_DEPTH_STENCILOP_DESC StencilOpDescToDX(const StencilOpDesc& desc)
     {
         D3D12_DEPTH_STENCILOP_DESC res;
@@ -24,8 +24,11 @@
 
 namespace Takoyaki
 {
+    struct ResourceTransition;
+
     float ConvertDipsToPixels(float dips, float dpi);
     void DXCheckThrow(HRESULT);
+    void ResourceBarriers(ID3D12GraphicsCommandList*, const std::vector<ResourceTransition>&);
     D3D12_RESOURCE_BARRIER TransitionBarrier(ID3D12Resource*, D3D12_RESOURCE_STATES, D3D12_RESOURCE_STATES);
 
     // enum conversions
@@ -36,10 +39,15 @@ namespace Takoyaki
     D3D12_DESCRIPTOR_RANGE_TYPE DescriptorTypeToDX(EDescriptorType);
     DXGI_FORMAT FormatToDX(EFormat);
     D3D12_FILL_MODE FillModeToDX(EFillMode);
+    D3D12_FILTER FilterToDX(EFilter);
     std::string GetDXError(HRESULT);
+    uint_fast32_t GetFormatSize(EFormat);
     D3D12_LOGIC_OP LogicOpToDX(ELogicOp);
     D3D12_RESOURCE_FLAGS ResourceFlagsToDX(uint_fast32_t);
+    D3D12_RESOURCE_STATES ResourceStateToDX(EResourceState);
+    D3D12_STATIC_BORDER_COLOR StaticBorderColorToDX(EBorderColor);
     D3D12_STENCIL_OP StencilOpToDX(EStencilOp);
+    D3D12_TEXTURE_ADDRESS_MODE TextureAddressModeToDX(ETextureAddressMode);
     D3D12_PRIMITIVE_TOPOLOGY TopologyToDX(ETopology);
     D3D12_PRIMITIVE_TOPOLOGY_TYPE TopologyTypeToDX(ETopologyType);
     D3D12_HEAP_TYPE UsageTypeToDX(EUsageType);
@@ -49,5 +57,7 @@ namespace Takoyaki
     D3D12_DEPTH_STENCIL_DESC DepthStencilDescToDX(const DepthStencilDesc&);
     DXGI_SAMPLE_DESC  MultiSampleDescToDX(const MultiSampleDesc&);
     D3D12_RASTERIZER_DESC RasterizerDescToDX(const RasterizerDesc&);
+    D3D12_SAMPLER_DESC SamplerDescToDX(const SamplerDesc&);
+    D3D12_STATIC_SAMPLER_DESC StaticSamplerDescToDX(const SamplerDesc&, uint_fast32_t);
     D3D12_DEPTH_STENCILOP_DESC StencilOpDescToDX(const StencilOpDesc&);
 } // namespace Takoyaki
\ No newline at end of file
@@ -21,8 +21,6 @@
 #include "pch.h"
 #include "descriptor_heap.h"
 
-#include <numeric>
-
 namespace Takoyaki
 {
     // Instance template here and use them elsewhere as extern
@@ -34,13 +32,14 @@ namespace Takoyaki
     // Specializations
     boost::wformat DX12DescriptorHeapCollection<D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV >::getFormatString()
     {
-        return boost::wformat{ L"Shader Resource View Heap %1%" };
+        return boost::wformat{ L"Shader Resource View Staging Heap %1%" };
     }
 
+    // CPU only, tables are copied to DX12ShaderVisibleHeap
     template <>
     D3D12_DESCRIPTOR_HEAP_FLAGS DX12DescriptorHeapCollection<D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV>::getFlags() const
     {
-        return D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        return D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
     }
 
     template <>
@@ -22,25 +22,75 @@
 
 #include "dx12_device.h"
 #include "dxutility.h"
+#include "../utility/bitmap_allocator.h"
+#include "../utility/range_allocator.h"
+#include "../utility/thread_slot_cache.h"
 
 namespace Takoyaki
 {
     class DX12Device;
 
-    constexpr size_t MAX_DESCRIPTOR_HEAP_SIZE = 128;
+    // global descriptor index is (heap << DESCRIPTOR_SLOT_BITS) | slot, 2^20 is the D3D12 tier 1 heap limit
+    constexpr uint_fast32_t DESCRIPTOR_SLOT_BITS = 20;
+    constexpr uint_fast32_t MAX_DESCRIPTOR_HEAP_SIZE = 1 << DESCRIPTOR_SLOT_BITS;
+    constexpr uint_fast32_t MAX_DESCRIPTOR_HEAPS = 1 << (32 - DESCRIPTOR_SLOT_BITS);
+    constexpr uint_fast32_t DESCRIPTOR_INVALID = UINT_FAST32_MAX;
+    constexpr size_t DESCRIPTOR_CACHE_BATCH = 16;
 
     struct DX12DescriptorHeap
     {
+        // the allocator not used by this heap kind is kept at a single slot
+        DX12DescriptorHeap(uint_fast32_t heapCapacity, bool isRanged)
+            : slots{ static_cast<uint32_t>(isRanged ? 1 : heapCapacity) }
+            , ranges{ static_cast<uint32_t>(isRanged ? heapCapacity : 1) }
+            , capacity{ heapCapacity }
+            , ranged{ isRanged }
+            , available{ true }
+        {
+        }
+
         Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptor;
         D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle;
         D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle;
-        std::vector<uint_fast32_t> freelist;
+        BitmapAllocator slots;      // single descriptors
+        RangeAllocator ranges;      // contiguous ranges
+        uint_fast32_t capacity;
+        bool ranged;                // which one of the two allocators this heap uses
+        bool available;             // currently in the available_ stack
     };
 
-    // Heap descriptor with a pool of MAX_DESCRIPTORS
-    // BENCHMARK: Is it better to create a pool here or just one per resource, use small pool for now
+    // Contiguous descriptors inside one heap, can be bound as a single descriptor table
+    struct DX12DescriptorRange
+    {
+        DX12DescriptorRange()
+            : heap{ nullptr }
+            , index{ DESCRIPTOR_INVALID }
+            , count{ 0 }
+            , descriptorSize{ 0 }
+        {
+            cpuHandle.ptr = 0;
+            gpuHandle.ptr = 0;
+        }
+
+        inline D3D12_CPU_DESCRIPTOR_HANDLE getCPU(uint_fast32_t i) const { return D3D12_CPU_DESCRIPTOR_HANDLE{ cpuHandle.ptr + i * descriptorSize }; }
+        inline D3D12_GPU_DESCRIPTOR_HANDLE getGPU(uint_fast32_t i) const { return D3D12_GPU_DESCRIPTOR_HANDLE{ gpuHandle.ptr + i * descriptorSize }; }
+        inline bool isValid() const { return count > 0; }
+
+        D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle;
+        D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle;
+        DX12DescriptorHeap* heap;
+        uint_fast32_t index;        // index of the first descriptor, to use for release
+        uint_fast32_t count;
+        uint_fast32_t descriptorSize;
+    };
+
+    // Pool of descriptor heaps, sized by DescriptorHeapDesc from FrameworkDesc
     // https://msdn.microsoft.com/en-us/library/windows/desktop/Dn899211(v=VS.85).aspx
     // Thread-safe when used via DeviceContext
+    // Descriptors are identified by a global index encoding heap and slot so release doesn't need
+    // any lookup, heaps with free slots are kept in a stack
+    // Ranges come from separate heaps using best-fit so that single descriptors don't fragment them
+    // Single descriptors go through per thread caches so loader threads don't serialize on mutex_
 
     template <D3D12_DESCRIPTOR_HEAP_TYPE T>
     class DX12DescriptorHeapCollection
@@ -51,109 +101,224 @@ namespace Takoyaki
         DX12DescriptorHeapCollection& operator=(DX12DescriptorHeapCollection&&) = delete;
 
     public:
-        using HandleTuple = std::tuple<D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_GPU_DESCRIPTOR_HANDLE, DX12DescriptorHeap*>;
+        // cpu, gpu, owning heap, index to use for release
+        using HandleTuple = std::tuple<D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_GPU_DESCRIPTOR_HANDLE, DX12DescriptorHeap*, uint_fast32_t>;
 
-        DX12DescriptorHeapCollection(std::weak_ptr<DX12Device> device) noexcept
+        DX12DescriptorHeapCollection(std::weak_ptr<DX12Device> device, const DescriptorHeapDesc& desc)
             : device_{ device }
+            , caches_{ DESCRIPTOR_CACHE_BATCH }
+            , desc_{ desc }
+            , nextCapacity_{ desc.capacity }
             , descriptorSize_{ UINT_FAST32_MAX }
+            , used_{ 0 }
+            , peak_{ 0 }
         {
+            if ((desc.capacity == 0) || (desc.capacity > MAX_DESCRIPTOR_HEAP_SIZE)) {
+                auto fmt = boost::format{ "DX12DescriptorHeapCollection, capacity %1% must be between 1 and %2%" } % desc.capacity % MAX_DESCRIPTOR_HEAP_SIZE;
+
+                throw std::runtime_error{ boost::str(fmt) };
+            }
         }
 
         ~DX12DescriptorHeapCollection() = default;
 
-        std::vector<HandleTuple> createRange(uint_fast32_t count)
+        DX12DescriptorRange createRange(uint_fast32_t count)
         {
+            if ((count == 0) || (count > MAX_DESCRIPTOR_HEAP_SIZE)) {
+                auto fmt = boost::format{ "DX12DescriptorHeapCollection::createRange, count %1% must be between 1 and %2%" } % count % MAX_DESCRIPTOR_HEAP_SIZE;
+
+                throw std::runtime_error{ boost::str(fmt) };
+            }
+
             std::lock_guard<std::mutex> lock{ mutex_ };
-            std::vector<HandleTuple> res;
+            DX12DescriptorRange res;
+            uint32_t offset = RANGE_INVALID;
+            size_t heapIndex = 0;
 
-            res.reserve(count);
+            // only a few ranged heaps are expected so try them in order
+            for (auto i : rangedHeaps_) {
+                offset = heaps_[i].ranges.allocate(count);
 
-            // use create one since descriptors might end on different heaps
-            for (uint_fast32_t i = 0; i < count; ++i)
-                res.push_back(createOneInternal());
+                if (offset != RANGE_INVALID) {
+                    heapIndex = i;
+                    break;
+                }
+            }
+
+            if (offset == RANGE_INVALID) {
+                heapIndex = allocateHeap(true, count);
+                offset = heaps_[heapIndex].ranges.allocate(count);
+            }
+
+            auto& heap = heaps_[heapIndex];
+
+            res.cpuHandle.ptr = heap.cpuHandle.ptr + offset * descriptorSize_;
+            res.gpuHandle.ptr = heap.gpuHandle.ptr + offset * descriptorSize_;
+            res.heap = &heap;
+            res.index = makeIndex(heapIndex, offset);
+            res.count = count;
+            res.descriptorSize = descriptorSize_;
+            addUsed(count);
 
             return res;
         }
 
         HandleTuple createOne()
         {
-            std::lock_guard<std::mutex> lock{ mutex_ };
+            return caches_.acquire([this](std::vector<HandleTuple>& out, size_t count)
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
 
-            return createOneInternal();
+                for (size_t i = 0; i < count; ++i)
+                    out.push_back(createOneInternal());
+            });
         }
 
-        void releaseOne(D3D12_CPU_DESCRIPTOR_HANDLE handle)
+        // actual release is deferred until the calling thread has released a batch or flushReleased is called
+        void releaseOne(uint_fast32_t index)
+        {
+            caches_.release(index, [this](const std::vector<uint_fast32_t>& released) { releaseBatch(released); });
+        }
+
+        // once per frame so that threads releasing less than a batch don't keep slots forever
+        void flushReleased()
+        {
+            caches_.flushAll([this](const std::vector<uint_fast32_t>& released) { releaseBatch(released); });
+        }
+
+        void releaseRange(const DX12DescriptorRange& range)
         {
             std::lock_guard<std::mutex> lock{ mutex_ };
-            auto container = containerMap_[handle.ptr];
+            auto heapIndex = getHeapIndex(range.index);
 
-            if (containerMap_.erase(handle.ptr) != 1)
-                throw std::runtime_error{ "DX12DescriptorHeapCollection::releaseOne, containerMap_ nothing erased" };
+            if ((heapIndex >= heaps_.size()) || !heaps_[heapIndex].ranged) {
+                auto fmt = boost::format{ "DX12DescriptorHeapCollection::releaseRange, invalid range index %1%" } % range.index;
+
+                throw std::runtime_error{ boost::str(fmt) };
+            }
 
-            heaps_[container].freelist.push_back((uint_fast32_t)(handle.ptr - heaps_[container].cpuHandle.ptr) / descriptorSize_);
+            heaps_[heapIndex].ranges.free(getSlot(range.index), static_cast<uint32_t>(range.count));
+            used_ -= range.count;
         }
 
-        template<typename Iter>
-        void releaseRange(Iter begin, Iter end)
+        DescriptorHeapStats getStats()
         {
+            DescriptorHeapStats res;
+
+            // before mutex_, cache flushes take the locks in the other order
+            res.reserved = static_cast<uint_fast32_t>(caches_.getNumReserved());
+
             std::lock_guard<std::mutex> lock{ mutex_ };
+            uint_fast32_t rangeFree = 0;
 
-            for (Iter i = begin; i != end; ++i) {
-                auto container = containerMap_[i->ptr];
+            res.numHeaps = static_cast<uint_fast32_t>(heaps_.size());
+            res.used = used_;
+            res.peak = peak_;
 
-                if (containerMap_.erase(i->ptr) != 1)
-                    throw std::runtime_error{ "DX12DescriptorHeapCollection::releaseRange, containerMap_ item not erased" };
+            for (auto& heap : heaps_) {
+                res.capacity += heap.capacity;
 
-                heaps_[container].freelist.push_back((uint_fast32_t)(i->ptr - heaps_[container].cpuHandle.ptr) / descriptorSize_);
+                if (heap.ranged) {
+                    rangeFree += heap.ranges.getNumFree();
+                    res.numFreeBlocks += heap.ranges.getNumFreeBlocks();
+                    res.largestFreeBlock = (std::max)(res.largestFreeBlock, static_cast<uint_fast32_t>(heap.ranges.getLargestFree()));
+                }
             }
+
+            if (rangeFree > 0)
+                res.fragmentation = 1.f - static_cast<float>(res.largestFreeBlock) / rangeFree;
+
+            return res;
         }
 
     private:
+        inline uint_fast32_t makeIndex(size_t heap, uint32_t slot) const { return static_cast<uint_fast32_t>((heap << DESCRIPTOR_SLOT_BITS) | slot); }
+        inline size_t getHeapIndex(uint_fast32_t index) const { return index >> DESCRIPTOR_SLOT_BITS; }
+        inline uint32_t getSlot(uint_fast32_t index) const { return static_cast<uint32_t>(index & (MAX_DESCRIPTOR_HEAP_SIZE - 1)); }
+
+        inline void addUsed(uint_fast32_t count)
+        {
+            used_ += count;
+            peak_ = (std::max)(peak_, used_);
+        }
+
         HandleTuple createOneInternal()
         {
+            if (available_.empty())
+                allocateHeap(false, 1);
+
+            auto heapIndex = available_.back();
+            auto& heap = heaps_[heapIndex];
+            auto slot = heap.slots.allocate();
+
+            if (heap.slots.getNumFree() == 0) {
+                available_.pop_back();
+                heap.available = false;
+            }
+
             D3D12_CPU_DESCRIPTOR_HANDLE cpu;
             D3D12_GPU_DESCRIPTOR_HANDLE gpu;
-            bool found = false;
-            size_t i = 0;
 
-            while (!found) {
-                for (i; i < heaps_.size(); ++i) {
-                    auto& heap = heaps_[i];
+            cpu.ptr = heap.cpuHandle.ptr + slot * descriptorSize_;
+            gpu.ptr = heap.gpuHandle.ptr + slot * descriptorSize_;
+            addUsed(1);
 
-                    if (heap.freelist.size() > 0) {
+            return std::make_tuple(cpu, gpu, &heap, makeIndex(heapIndex, slot));
+        }
 
-                        auto offset = heap.freelist.back();
+        void releaseBatch(const std::vector<uint_fast32_t>& released)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
 
-                        heap.freelist.pop_back();
-                        cpu.ptr = heap.cpuHandle.ptr + offset * descriptorSize_;
-                        gpu.ptr = heap.gpuHandle.ptr + offset * descriptorSize_;
-                        found = true;
-                        break;
-                    }
-                }
+            for (auto index : released)
+                releaseOneInternal(index);
+        }
+
+        void releaseOneInternal(uint_fast32_t index)
+        {
+            auto heapIndex = getHeapIndex(index);
 
-                if (!found)
-                    allocateHeap();
+            if ((heapIndex >= heaps_.size()) || heaps_[heapIndex].ranged) {
+                auto fmt = boost::format{ "DX12DescriptorHeapCollection::releaseOne, invalid descriptor index %1%" } % index;
+
+                throw std::runtime_error{ boost::str(fmt) };
             }
 
-            // we need to store which container it belonged to for later release.
-            // using cpu for that should be ok since gpu is mirroring it
-            containerMap_.insert({ cpu.ptr, i });
+            auto& heap = heaps_[heapIndex];
+
+            heap.slots.free(getSlot(index));
+            --used_;
 
-            return std::make_tuple(cpu, gpu, &heaps_[i]);
+            if (!heap.available) {
+                heap.available = true;
+                available_.push_back(heapIndex);
+            }
         }
 
-        void allocateHeap()
+        // minCapacity is for ranges larger than what the policy would give
+        size_t allocateHeap(bool ranged, uint_fast32_t minCapacity)
         {
+            if (heaps_.size() >= MAX_DESCRIPTOR_HEAPS) {
+                auto fmt = boost::format{ "DX12DescriptorHeapCollection::allocateHeap, cannot have more than %1% heaps, increase the capacity" } % MAX_DESCRIPTOR_HEAPS;
+
+                throw std::runtime_error{ boost::str(fmt) };
+            }
+
+            auto capacity = (std::max)(nextCapacity_, minCapacity);
+
+            if (desc_.growth == EDescriptorHeapGrowth::GEOMETRIC)
+                nextCapacity_ = (std::min)(nextCapacity_ * 2, MAX_DESCRIPTOR_HEAP_SIZE);
+
             D3D12_DESCRIPTOR_HEAP_DESC desc = {};
 
-            desc.NumDescriptors = MAX_DESCRIPTOR_HEAP_SIZE;
+            desc.NumDescriptors = capacity;
             desc.Type = T;
             desc.Flags = getFlags();
 
-            heaps_.resize(heaps_.size() + 1);
+            // deque so that heap pointers returned in HandleTuple stay valid
+            heaps_.emplace_back(capacity, ranged);
 
-            auto& heap = heaps_[heaps_.size() - 1];
+            auto& heap = heaps_.back();
 
             // Not thread-safe so lock device
             {
@@ -169,9 +334,21 @@ namespace Takoyaki
             // Make a suitable name
             heap.descriptor->SetName(boost::str(getFormatString() % heaps_.size()).c_str());
             heap.cpuHandle = heap.descriptor->GetCPUDescriptorHandleForHeapStart();
-            heap.gpuHandle = heap.descriptor->GetGPUDescriptorHandleForHeapStart();
-            heap.freelist.resize(MAX_DESCRIPTOR_HEAP_SIZE);
-            std::iota(heap.freelist.begin(), heap.freelist.end(), 0);
+
+            // only shader visible heaps have a GPU address
+            if (desc.Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE)
+                heap.gpuHandle = heap.descriptor->GetGPUDescriptorHandleForHeapStart();
+            else
+                heap.gpuHandle.ptr = 0;
+
+            auto index = heaps_.size() - 1;
+
+            if (ranged)
+                rangedHeaps_.push_back(index);
+            else
+                available_.push_back(index);
+
+            return index;
         }
 
         boost::wformat getFormatString();
@@ -180,9 +357,15 @@ namespace Takoyaki
     private:
         std::mutex mutex_;
         std::weak_ptr<DX12Device> device_;
-        std::vector<DX12DescriptorHeap> heaps_;
-        std::unordered_map<SIZE_T, size_t> containerMap_;
+        std::deque<DX12DescriptorHeap> heaps_;
+        std::vector<size_t> available_;
+        std::vector<size_t> rangedHeaps_;
+        ThreadSlotCaches<HandleTuple, uint_fast32_t> caches_;
+        DescriptorHeapDesc desc_;
+        uint_fast32_t nextCapacity_;
         uint_fast32_t descriptorSize_;
+        uint_fast32_t used_;
+        uint_fast32_t peak_;
     };
 
     extern template DX12DescriptorHeapCollection<D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV>;
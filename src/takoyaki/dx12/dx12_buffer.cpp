@@ -28,26 +28,24 @@ namespace Takoyaki
 {
     DX12Buffer::DX12Buffer(D3D12_HEAP_TYPE type, uint_fast64_t sizeByte, D3D12_RESOURCE_STATES initialState) noexcept
         : intermediate_{ std::make_unique<Intermediate>() }
+        , allocator_{ nullptr }
     {
         intermediate_->type = type;
         intermediate_->size = sizeByte;
         intermediate_->initialState = initialState;
     }
 
-    void DX12Buffer::create(DX12Device* device)
+    DX12Buffer::~DX12Buffer()
     {
-        D3D12_HEAP_PROPERTIES prop;
-
-        prop.Type = intermediate_->type;
-
-        // let the driver decide about those properties
-        prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-        prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+        // the memory can only be reused once the placed resource is gone
+        resource_.Reset();
 
-        // no multi-gpu support for now
-        prop.CreationNodeMask = 1;
-        prop.VisibleNodeMask = 1;
+        if (allocator_ != nullptr)
+            allocator_->release(allocation_);
+    }
 
+    void DX12Buffer::create(DX12Device* device)
+    {
         // https://msdn.microsoft.com/en-us/library/windows/desktop/dn903813(v=vs.85).aspx
         D3D12_RESOURCE_DESC desc;
 
@@ -67,8 +65,8 @@ namespace Takoyaki
 
         desc.Width = intermediate_->size;
 
-        // multi-thread safe, no need to lock
-        DXCheckThrow(device->getDXDevice()->CreateCommittedResource(&prop, D3D12_HEAP_FLAG_NONE, &desc, intermediate_->initialState, nullptr, IID_PPV_ARGS(&resource_)));
+        allocator_ = &device->getMemoryAllocator();
+        allocation_ = allocator_->createResource(desc, intermediate_->type, intermediate_->initialState, resource_);
 
         intermediate_.reset();
     }
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "dx12_memory_allocator.h"
+
 namespace Takoyaki
 {
     class DX12Device;
@@ -33,7 +35,7 @@ namespace Takoyaki
 
     public:
         explicit DX12Buffer(D3D12_HEAP_TYPE, uint_fast64_t, D3D12_RESOURCE_STATES) noexcept;
-        ~DX12Buffer() = default;
+        ~DX12Buffer();
 
         //////////////////////////////////////////////////////////////////////////
         // Internal usage:
@@ -53,5 +55,7 @@ namespace Takoyaki
 
         std::unique_ptr<Intermediate> intermediate_;
         Microsoft::WRL::ComPtr<ID3D12Resource> resource_;
+        DX12MemoryAllocator* allocator_;
+        DX12Allocation allocation_;
     };
 } // namespace Takoyaki
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include "dxcommon.h"
 #include "../impl/command_impl.h"
 #include "../utility/log.h"
+#include "../utility/radix_sort.h"
 
 namespace Takoyaki
 {
@@ -37,43 +38,56 @@ namespace Takoyaki
 
     bool DX12CommandBuilder::buildCommand(const CommandDesc& desc, TaskCommand* cmd)
     {
-        // at this stage shouldn't need to lock to access resources anymore
+        // resources have been resolved by CommandImpl, this is only emission
         auto frame = device_->getCurrentFrame();
-        DX12Texture* rt = nullptr;
+        DX12Texture* rt = desc.renderTarget;
 
-        // set a render target
-        if (desc.renderTarget == UINT_FAST32_MAX) {
-            // default one
+        // default render target
+        if (rt == nullptr)
             rt = device_->getRenderTarget(frame);
-        } else {
-            // user specified
-            auto& textures = context_->getTextures();
-            auto found = textures.find(desc.renderTarget);
 
-            if (found == textures.end()) {
-                auto fmt = boost::format{ "DX12DeviceContext::buildCommand, cannot find rendertarget \"%1%\"" } % desc.renderTarget;
-
-                throw std::runtime_error{ boost::str(fmt) };
+        // states are tracked for the whole list, pending transitions are issued in one call
+        // right before the commands needing them. The state of the first use and the final one
+        // are resolved by DX12Device at submission
+        auto& states = cmd->states;
+        std::vector<ResourceTransition> transitions;
+
+        auto flushTransitions = [&]()
+        {
+            if (states.hasPending()) {
+                states.flush(transitions);
+                ResourceBarriers(cmd->commands.Get(), transitions);
+                transitions.clear();
             }
+        };
 
-            rt = &found->second;
-        }
-
-        D3D12_RESOURCE_STATES rtState = rt->getInitialState();
+        auto useRenderTarget = [&]()
+        {
+            states.transition(rt->getResource(), rt->getInitialState(), D3D12_RESOURCE_STATE_RENDER_TARGET);
+            flushTransitions();
+        };
 
-        // prepare the render target to be used
-        D3D12_RESOURCE_BARRIER beforeBarrier = TransitionBarrier(rt->getResource(), rt->getInitialState(), D3D12_RESOURCE_STATE_RENDER_TARGET);
+        // only one shader visible heap of each type so this is done once per list
+        // the sampler heap exists once a sampler has been created, which any sampler table requires
+        auto& shaderVisibleHeap = device_->getShaderVisibleHeap();
+        ID3D12DescriptorHeap* heaps[] = { shaderVisibleHeap.getHeap(), context_->getSamplerCache().getHeap() };
 
-        cmd->commands->ResourceBarrier(1, &beforeBarrier);
+        cmd->commands->SetDescriptorHeaps((heaps[1] != nullptr) ? 2 : 1, heaps);
         cmd->commands->OMSetRenderTargets(1, &rt->getRenderTargetView(), false, nullptr);
-        rtState = D3D12_RESOURCE_STATE_RENDER_TARGET;
 
-        for (auto descCmd : desc.commands) {
+        DX12RootSignature* rootSignature = nullptr;
+        std::vector<uint64_t> binding;
+        std::vector<SortItem> sortItems;
+        std::vector<SortItem> sortScratch;
+
+        for (auto& descCmd : desc.commands) {
             switch (descCmd.first) {
                 case ECommandType::CLEAR_COLOR:
                 {
                     auto color = boost::any_cast<glm::vec4>(descCmd.second);
-                    cmd->commands->ClearRenderTargetView(device_->getRenderTarget(frame)->getRenderTargetView(), glm::value_ptr(color), 0, nullptr);
+
+                    useRenderTarget();
+                    cmd->commands->ClearRenderTargetView(rt->getRenderTargetView(), glm::value_ptr(color), 0, nullptr);
                 }
                 break;
 
@@ -101,48 +115,22 @@ namespace Takoyaki
                 case ECommandType::COPY_REGION_TEXTURE2D:
                 {
                     // dstTex, dstSubresource, dstOffset, srcTex, srcAreaMin, srcAreaMax
-                    auto params = boost::any_cast<CopyTexRegionParams>(descCmd.second);
-                    auto& textures = context_->getTextures();
-
-                    auto dstFound = textures.find(params.dstHandle);
-
-                    if (dstFound == textures.end()) {
-                        auto fmt = boost::format{ "DX12DeviceContext::buildCommand, cannot find destination texture \"%1%\" for copy operation" } % params.dstHandle;
-
-                        throw std::runtime_error{ boost::str(fmt) };
-                    }
-
-                    auto srcFound = textures.find(params.srcHandle);
-
-                    if (srcFound == textures.end()) {
-                        auto fmt = boost::format{ "DX12DeviceContext::buildCommand, cannot find source texture \"%1%\" for copy operation" } % params.srcHandle;
-
-                        throw std::runtime_error{ boost::str(fmt) };
-                    }
+                    auto& copy = boost::any_cast<const CommandDesc::CopyRegionParams&>(descCmd.second);
+                    auto& params = copy.region;
 
                     D3D12_TEXTURE_COPY_LOCATION dstLoc, srcLoc;
 
-                    dstLoc.pResource = dstFound->second.getResource();
+                    dstLoc.pResource = copy.dst->getResource();
                     dstLoc.SubresourceIndex = params.dstSubresource;
                     dstLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-                    srcLoc.pResource = srcFound->second.getResource();
+                    srcLoc.pResource = copy.src->getResource();
                     srcLoc.SubresourceIndex = params.srcSubresource;
                     srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
 
-                    // need to transition source to correct state
-                    D3D12_RESOURCE_STATES srcState;
-
-                    if (params.srcHandle < device_->getFrameCount()) {
-                        // default render target use rtState
-                        srcState = rtState;
-                    } else {
-                        // set source to correct state
-                        srcState = srcFound->second.getInitialState();
-                    }
-
-                    D3D12_RESOURCE_BARRIER sourceBefore = TransitionBarrier(srcLoc.pResource, srcState, D3D12_RESOURCE_STATE_COPY_SOURCE);
-
-                    cmd->commands->ResourceBarrier(1, &sourceBefore);
+                    // CommandImpl rejects dst == src, both transitions would be merged into the last one
+                    states.transition(dstLoc.pResource, copy.dst->getInitialState(), D3D12_RESOURCE_STATE_COPY_DEST);
+                    states.transition(srcLoc.pResource, copy.src->getInitialState(), D3D12_RESOURCE_STATE_COPY_SOURCE);
+                    flushTransitions();
 
                     // check if empty
                     if (glm::all(glm::equal(params.srcAreaMin, glm::ivec3())) && glm::all(glm::equal(params.srcAreaMax, glm::ivec3()))) {
@@ -161,10 +149,6 @@ namespace Takoyaki
 
                         cmd->commands->CopyTextureRegion(&dstLoc, params.dstOffset.x, params.dstOffset.y, params.dstOffset.z, &srcLoc, &srcBox);
                     }
-
-                    D3D12_RESOURCE_BARRIER sourceAfter = TransitionBarrier(srcLoc.pResource, D3D12_RESOURCE_STATE_COPY_SOURCE, srcState);
-
-                    cmd->commands->ResourceBarrier(1, &sourceAfter);
                 }
                 break;
 
@@ -172,23 +156,72 @@ namespace Takoyaki
                 {
                     auto params = boost::any_cast<CommandDesc::DrawIndexedParams>(descCmd.second);
 
+                    useRenderTarget();
                     cmd->commands->DrawIndexedInstanced(std::get<0>(params), 1, std::get<1>(params), std::get<2>(params), 0);
                 }
                 break;
 
-                case ECommandType::SET_INDEX_BUFFER:
+                case ECommandType::MULTI_DRAW_INDEXED:
                 {
-                    auto handle = boost::any_cast<uint_fast32_t>(descCmd.second);
-                    auto& indexBuffers = context_->getIndexBuffers();
-                    auto found = indexBuffers.find(handle);
+                    // reference the records in place, only their order is sorted
+                    auto& params = boost::any_cast<const CommandDesc::MultiDrawParams&>(descCmd.second);
+                    auto& records = params.records;
+                    auto list = cmd->commands.Get();
+
+                    sortItems.resize(records.size());
+                    sortScratch.resize(records.size());
+
+                    for (size_t i = 0; i < records.size(); ++i)
+                        sortItems[i] = { records[i].sortKey, static_cast<uint32_t>(i) };
+
+                    // already on a worker, the other workers are building the other commands
+                    RadixSort(sortItems.data(), sortScratch.data(), sortItems.size());
+                    useRenderTarget();
 
-                    if (found == indexBuffers.end()) {
-                        auto fmt = boost::format{ "DX12DeviceContext::buildCommand, cannot find index buffer \"%1%\"" } % handle;
+                    for (auto& item : sortItems) {
+                        auto& record = records[item.index];
 
-                        throw std::runtime_error{ boost::str(fmt) };
+                        if (params.numConstants > 0)
+                            list->SetGraphicsRoot32BitConstants(params.rootIndex, params.numConstants, &record.constants.front(), 0);
+
+                        list->DrawIndexedInstanced(record.indexCount, 1, record.startIndex, record.baseVertex, 0);
                     }
+                }
+                break;
+
+                case ECommandType::READBACK_TEXTURE:
+                {
+                    auto& params = boost::any_cast<const CommandDesc::ReadbackParams&>(descCmd.second);
+                    auto src = params.src->getResource();
+
+                    states.transition(src, params.src->getInitialState(), D3D12_RESOURCE_STATE_COPY_SOURCE);
+                    flushTransitions();
 
-                    cmd->commands->IASetIndexBuffer(&found->second.getView());
+                    device_->getReadbackRing().readTexture(device_, cmd->commands.Get(), src, params.subresource, params.callback);
+                }
+                break;
+
+                case ECommandType::SET_BINDLESS_INDEX:
+                {
+                    auto params = boost::any_cast<CommandDesc::BindlessIndexParams>(descCmd.second);
+
+                    cmd->commands->SetGraphicsRoot32BitConstant(std::get<0>(params), std::get<1>(params), std::get<2>(params));
+                }
+                break;
+
+                case ECommandType::SET_BINDLESS_TABLE:
+                {
+                    auto rootIndex = boost::any_cast<uint_fast32_t>(descCmd.second);
+
+                    cmd->commands->SetGraphicsRootDescriptorTable(rootIndex, shaderVisibleHeap.getBindlessTable());
+                }
+                break;
+
+                case ECommandType::SET_INDEX_BUFFER:
+                {
+                    auto view = boost::any_cast<D3D12_INDEX_BUFFER_VIEW>(descCmd.second);
+
+                    cmd->commands->IASetIndexBuffer(&view);
                 }
                 break;
 
@@ -200,38 +233,61 @@ namespace Takoyaki
                 }
                 break;
 
-                case ECommandType::SET_ROOT_SIGNATURE:
+                case ECommandType::SET_ROOT_CONSTANT_BUFFER_VIEW:
                 {
-                    auto name = boost::any_cast<std::string>(descCmd.second);
-                    auto& rootSignatures = context_->getRootSignatures();
-                    auto found = rootSignatures.find(name);
+                    auto params = boost::any_cast<CommandDesc::RootCBVParams>(descCmd.second);
 
-                    if (found == rootSignatures.end()) {
-                        auto fmt = boost::format{ "DX12DeviceContext::buildCommand, cannot find root signature \"%1%\"" } % name;
+                    cmd->commands->SetGraphicsRootConstantBufferView(params.first, params.second);
+                }
+                break;
 
-                        throw std::runtime_error{ boost::str(fmt) };
-                    }
+                case ECommandType::SET_ROOT_CONSTANTS:
+                {
+                    auto& params = boost::any_cast<const CommandDesc::RootConstantsParams&>(descCmd.second);
 
-                    cmd->commands->SetGraphicsRootSignature(found->second.getRootSignature());
+                    cmd->commands->SetGraphicsRoot32BitConstants(params.rootIndex, static_cast<UINT>(params.values.size()), &params.values.front(), params.offset);
+                }
+                break;
+
+                case ECommandType::SET_ROOT_SIGNATURE:
+                {
+                    rootSignature = boost::any_cast<DX12RootSignature*>(descCmd.second);
+                    cmd->commands->SetGraphicsRootSignature(rootSignature->getRootSignature());
                 }
                 break;
 
                 case ECommandType::SET_ROOT_SIGNATURE_CONSTANT_BUFFER:
                 {
                     auto pair = boost::any_cast<CommandDesc::RSCBParams>(descCmd.second);
-                    auto cbPair = context_->getConstantBuffer(pair.second);
+                    auto cb = pair.second;
 
-                    if (!cbPair.first.isReady()) {
-                        auto fmt = boost::format{ "DX12DeviceContext::buildCommand, constant buffer not ready \"%1%\"" } % pair.second;
+                    if (!cb->isReady()) {
+                        auto fmt = boost::format{ "DX12DeviceContext::buildCommand, constant buffer bound to root index %1% not ready" } % pair.first;
 
                         LOGW << boost::str(fmt);
                         return false;
                     }
 
-                    ID3D12DescriptorHeap* temp[] = { cbPair.first.getHeap(frame)->descriptor.Get() };
+                    auto view = cb->getCPUView(frame);
+                    uint64_t ticket;
+
+                    cb->commit(frame);
+
+                    // same constant buffer at the same slot reuse the table written the first time
+                    binding.assign({ reinterpret_cast<uintptr_t>(rootSignature), pair.first, cb->getUID(), frame });
+
+                    auto table = shaderVisibleHeap.copyTable(binding, &view, 1, ticket);
+
+                    cmd->descriptorTickets.push_back(ticket);
+                    cmd->commands->SetGraphicsRootDescriptorTable(pair.first, table);
+                }
+                break;
+
+                case ECommandType::SET_SAMPLER_TABLE:
+                {
+                    auto params = boost::any_cast<CommandDesc::SamplerTableParams>(descCmd.second);
 
-                    cmd->commands->SetDescriptorHeaps(1, temp);
-                    cmd->commands->SetGraphicsRootDescriptorTable(pair.first, cbPair.first.getGPUView(frame));
+                    cmd->commands->SetGraphicsRootDescriptorTable(params.first, params.second);
                 }
                 break;
 
@@ -247,17 +303,9 @@ namespace Takoyaki
 
                 case ECommandType::SET_VERTEX_BUFFER:
                 {
-                    auto handle = boost::any_cast<uint_fast32_t>(descCmd.second);
-                    auto& vertexBuffers = context_->getVertexBuffers();
-                    auto found = vertexBuffers.find(handle);
+                    auto view = boost::any_cast<D3D12_VERTEX_BUFFER_VIEW>(descCmd.second);
 
-                    if (found == vertexBuffers.end()) {
-                        auto fmt = boost::format{ "DX12DeviceContext::buildCommand, cannot find vertex buffer \"%1%\"" } % handle;
-
-                        throw std::runtime_error{ boost::str(fmt) };
-                    }
-
-                    cmd->commands->IASetVertexBuffers(0, 1, &found->second.getView());
+                    cmd->commands->IASetVertexBuffers(0, 1, &view);
                 }
                 break;
 
@@ -270,15 +318,24 @@ namespace Takoyaki
                     cmd->commands->RSSetViewports(1, &viewport);
                 }
                 break;
+
+                case ECommandType::TRANSITION:
+                {
+                    // issued along with the barriers of the next command that flush
+                    auto params = boost::any_cast<CommandDesc::TransitionParams>(descCmd.second);
+                    auto tex = params.first;
+
+                    states.transition(tex->getResource(), tex->getInitialState(), ResourceStateToDX(params.second));
+                }
+                break;
             }
         }
 
-        // transition back the render target to its initial state
-        D3D12_RESOURCE_BARRIER afterBarrier = TransitionBarrier(rt->getResource(), rtState, rt->getInitialState());
-
-        cmd->commands->ResourceBarrier(1, &afterBarrier);
+        // the following lists expect what was requested last
+        flushTransitions();
 
-        cmd->priority = desc.priority;
+        // no transition back here, final states are kept by the tracker
+        cmd->sortKey = desc.sortKey;
         DXCheckThrow(cmd->commands->Close());
 
         return true;
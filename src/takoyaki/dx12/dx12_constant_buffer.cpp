@@ -32,11 +32,18 @@
 
 namespace Takoyaki
 {
+    namespace
+    {
+        std::atomic<uint64_t> uidGenerator{ 0 };
+    }
+
     DX12ConstantBuffer::DX12ConstantBuffer(DX12Context* context, uint_fast32_t sizeByte, uint_fast32_t numFrames)
         : owner_{ context }
         , buffer_{ std::make_unique<DX12Buffer>(D3D12_HEAP_TYPE_UPLOAD, sizeByte * numFrames, D3D12_RESOURCE_STATE_GENERIC_READ) }
+        , layout_{ sizeByte }
+        , shadow_{ sizeByte, numFrames }
         , mappedAddr_{ nullptr }
-        , curOffset_{ 0 }
+        , uid_{ 0 }
         , size_{ sizeByte }
         , ready_{ false }
     {
@@ -45,32 +52,26 @@ namespace Takoyaki
     DX12ConstantBuffer::DX12ConstantBuffer(DX12ConstantBuffer&& other) noexcept
         : owner_{ other.owner_ }
         , buffer_{ std::move(other.buffer_) }
-        , offsetMap_{ std::move(other.offsetMap_) }
-        , cpuHandles_{ std::move(other.cpuHandles_) }
+        , layout_{ std::move(other.layout_) }
+        , shadow_{ std::move(other.shadow_) }
+        , descriptors_{ other.descriptors_ }
         , mappedAddr_{ other.mappedAddr_ }
-        , curOffset_{ other.curOffset_ }
+        , uid_{ other.uid_ }
         , size_{ other.size_ }
         , ready_{ other.ready_.load() }
     {
-        other.cpuHandles_.clear();
+        other.descriptors_ = DX12DescriptorRange{};
     }
 
     DX12ConstantBuffer::~DX12ConstantBuffer()
     {
-        // only cpu handles are used to track descriptor heap usage
-        if (!cpuHandles_.empty())
-            owner_->getRTVDescHeapCollection().releaseRange(cpuHandles_.begin(), cpuHandles_.end());
+        if (descriptors_.isValid())
+            owner_->getSRVDescHeapCollection().releaseRange(descriptors_);
     }
 
-    void DX12ConstantBuffer::addVariable(const std::string& name, uint_fast32_t offset, uint_fast32_t size)
+    FieldHandle DX12ConstantBuffer::addVariable(const std::string& name, uint_fast32_t offset, uint_fast32_t size)
     {
-        CBVariable var;
-
-        var.offset = offset;
-        var.size = curOffset_;
-
-        offsetMap_.insert({ name, std::move(var) });
-        curOffset_ += size;
+        return layout_.addField(name, offset, size);
     }
 
     void DX12ConstantBuffer::create(const std::string& name, DX12Device* device)
@@ -82,17 +83,8 @@ namespace Takoyaki
         auto fmt = boost::wformat{ L"%1%" } % name.c_str();
         auto bufCount = device->getFrameCount();
 
-        cpuHandles_.reserve(bufCount);
-        cpuHandles_.reserve(bufCount);
-        heaps_.reserve(bufCount);
-
-        auto handles = owner_->getSRVDescHeapCollection().createRange(bufCount);
-
-        for (auto& tuple : handles) {
-            cpuHandles_.push_back(std::get<0>(tuple));
-            gpuHandles_.push_back(std::get<1>(tuple));
-            heaps_.push_back(std::get<2>(tuple));
-        }
+        descriptors_ = owner_->getSRVDescHeapCollection().createRange(bufCount);
+        uid_ = ++uidGenerator;
 
         res->SetName(boost::str(fmt).c_str());
 
@@ -107,7 +99,7 @@ namespace Takoyaki
                 auto lock = device->getDeviceLock();
 
                 // create constant buffer views to access the upload buffer
-                device->getDXDevice()->CreateConstantBufferView(&desc, cpuHandles_[i]);
+                device->getDXDevice()->CreateConstantBufferView(&desc, descriptors_.getCPU(i));
             }
         }
 
@@ -118,20 +110,46 @@ namespace Takoyaki
         ready_ = true;
     }
 
-    void DX12ConstantBuffer::setMatrix4x4(const std::string& name, const glm::mat4x4& value, uint_fast32_t frame)
+    void DX12ConstantBuffer::commit(uint_fast32_t frame)
+    {
+        std::lock_guard<std::mutex> lock{ shadowMutex_ };
+
+        if (shadow_.isDirty(frame))
+            shadow_.flush(frame, mappedAddr_ + (frame * size_));
+    }
+
+    void DX12ConstantBuffer::setField(FieldHandle handle, const void* data, uint_fast32_t sizeByte)
     {
-        auto found = offsetMap_.find(name);
+        auto offset = layout_.getWriteOffset(handle, sizeByte);
+        std::lock_guard<std::mutex> lock{ shadowMutex_ };
 
-        if (found == offsetMap_.end()) {
+        shadow_.write(offset, data, sizeByte);
+    }
+
+    void DX12ConstantBuffer::setMatrix4x4(const std::string& name, const glm::mat4x4& value)
+    {
+        auto handle = layout_.getField(name);
+
+        if (handle == FIELD_INVALID) {
             auto fmt = boost::format{ "DX12ConstantBuffer, could not find constant %1%" } % name;
 
             LOGW << boost::str(fmt);
             //throw std::runtime_error(boost::str(fmt));
         } else {
-            // TODO: doing this for each upload is potentially slow, maybe write in a temporary buffer first?
-            // https://developer.nvidia.com/content/constant-buffers-without-constant-pain-0
-            uint8_t* dest = mappedAddr_ + (frame * size_) + found->second.offset;
-            memcpy(dest, &value, sizeof(glm::mat4x4));
+            setField(handle, &value, sizeof(glm::mat4x4));
         }
     }
+
+    void DX12ConstantBuffer::setRange(uint_fast32_t offset, const void* data, uint_fast32_t sizeByte)
+    {
+        if ((offset > size_) || (sizeByte > size_ - offset)) {
+            auto fmt = boost::format{ "DX12ConstantBuffer::setRange, %1% bytes at offset %2% doesn't fit in %3% bytes" } % sizeByte % offset % size_;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        std::lock_guard<std::mutex> lock{ shadowMutex_ };
+
+        shadow_.write(offset, data, sizeByte);
+    }
 } // namespace Takoyaki
\ No newline at end of file
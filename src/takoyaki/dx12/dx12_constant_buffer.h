@@ -20,12 +20,15 @@
 
 #pragma once
 
+#include "descriptor_heap.h"
+#include "../utility/constant_buffer_layout.h"
+#include "../utility/shadow_buffer.h"
+
 namespace Takoyaki
 {
     class DX12Buffer;
     class DX12Context;
     class DX12Device;
-    struct DX12DescriptorHeap;
 
     class DX12ConstantBuffer
     {
@@ -41,34 +44,39 @@ namespace Takoyaki
         //////////////////////////////////////////////////////////////////////////
         // Internal usage:
 
-        void addVariable(const std::string&, uint_fast32_t, uint_fast32_t);
         void create(const std::string&, DX12Device*);
 
-        inline const D3D12_CPU_DESCRIPTOR_HANDLE& getCPUView(uint_fast32_t frame) { return cpuHandles_[frame]; }
-        inline const D3D12_GPU_DESCRIPTOR_HANDLE& getGPUView(uint_fast32_t frame) { return gpuHandles_[frame]; }
-        inline DX12DescriptorHeap* getHeap(uint_fast32_t frame) { return heaps_[frame]; }
+        // one view per frame in a CPU only heap, copied to the shader visible heap when bound
+        inline D3D12_CPU_DESCRIPTOR_HANDLE getCPUView(uint_fast32_t frame) const { return descriptors_.getCPU(frame); }
+
+        // never reused unlike names and descriptors, identify the views in cached descriptor tables
+        inline uint64_t getUID() const { return uid_; }
         inline bool isReady() const { return ready_.load(); }
 
+        // flush the writes this frame slot hasn't seen yet, done when the buffer is bound
+        void commit(uint_fast32_t);
+
         //////////////////////////////////////////////////////////////////////////
         // External usage:
 
-        void setMatrix4x4(const std::string&, const glm::mat4x4&, uint_fast32_t);
+        // layout is expected to be complete before the first write
+        FieldHandle addVariable(const std::string&, uint_fast32_t, uint_fast32_t);
+        inline FieldHandle getField(const std::string& name) const { return layout_.getField(name); }
 
-    private:
-        struct CBVariable
-        {
-            uint_fast32_t offset;
-            uint_fast32_t size;
-        };
+        // writes go to a CPU shadow copy, mapped memory is write-combined and only touched on commit
+        void setField(FieldHandle, const void*, uint_fast32_t);
+        void setMatrix4x4(const std::string&, const glm::mat4x4&);
+        void setRange(uint_fast32_t, const void*, uint_fast32_t);
 
+    private:
         DX12Context* owner_;
         std::unique_ptr<DX12Buffer> buffer_;
-        std::unordered_map<std::string, CBVariable> offsetMap_;     // TODO: thread unsafe but should be ok
-        std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> cpuHandles_;
-        std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> gpuHandles_;
-        std::vector<DX12DescriptorHeap*> heaps_;
+        ConstantBufferLayout layout_;
+        ShadowBuffer shadow_;
+        std::mutex shadowMutex_;
+        DX12DescriptorRange descriptors_;
         uint8_t* mappedAddr_;
-        uint_fast32_t curOffset_;
+        uint64_t uid_;
         uint_fast32_t size_;
         std::atomic<bool> ready_;
     };
@@ -30,15 +30,23 @@
 
 namespace Takoyaki
 {
+    namespace
+    {
+        // streaming textures are created with their smallest mips up to this size already resident
+        constexpr uint64_t STREAMING_TAIL_SIZE = 64 * 1024;
+    }
+
     extern template DX12DescriptorHeapCollection<D3D12_DESCRIPTOR_HEAP_TYPE_RTV>;
     extern template DX12DescriptorHeapCollection<D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV>;
 
-    DX12Context::DX12Context(const std::shared_ptr<DX12Device>& device, const std::shared_ptr<ThreadPool>& threadPool)
+    DX12Context::DX12Context(const std::shared_ptr<DX12Device>& device, const std::shared_ptr<ThreadPool>& threadPool, const FrameworkDesc& desc)
         : device_{ device }
         , threadPool_{ threadPool }
         , cmdBuilder_{ this , device_.get() }
-        , descHeapRTV_{ device }
-        , descHeapSRV_{ device }
+        , descHeapRTV_{ device, desc.rtvHeap }
+        , descHeapSRV_{ device, desc.cbvSrvUavHeap }
+        , samplers_{ device, desc.samplerHeapSize }
+        , mipStreamer_{ desc.mipStreamingBudget }
     {
         // somehow cannot default construct or move RWLockMap, oh well..
         shaders_.reserve(6);
@@ -60,6 +68,10 @@ namespace Takoyaki
 
     bool DX12Context::buildCommand(const CommandDesc& desc, TaskCommand* cmd)
     {
+#ifdef _DEBUG
+        validateHandles(desc);
+#endif
+
         return cmdBuilder_.buildCommand(desc, cmd);
     }
 
@@ -99,37 +111,6 @@ namespace Takoyaki
         pair.first.create(device_.get(), this);
     }
 
-    void DX12Context::createBuffer(EResourceType type, uint_fast32_t id, uint8_t* data, EFormat format, uint_fast32_t stride, uint_fast32_t sizeByte)
-    {
-        auto threadPool = threadPool_.lock();
-
-        switch (type) {
-            case Takoyaki::DX12Context::EResourceType::INDEX_BUFFER:
-            {
-                auto lock = indexBuffers_.getWriteLock();
-                auto pair = indexBuffers_.insert(std::make_pair(id, DX12IndexBuffer{ data, format, sizeByte, id }));
-
-                // then build a command to build underlaying resources
-                threadPool->submitGPU(std::bind(&DX12IndexBuffer::create, &pair.first->second, std::placeholders::_1, std::placeholders::_2), std::string(), 0);
-                threadPool->submitGPU(std::bind(&DX12IndexBuffer::cleanupCreate, &pair.first->second, std::placeholders::_1, std::placeholders::_2), std::string(), 1);
-                threadPool->submitGeneric(std::bind(&DX12IndexBuffer::cleanupIntermediate, &pair.first->second), 2);
-            }
-            break;
-
-            case Takoyaki::DX12Context::EResourceType::VERTEX_BUFFER:
-            {
-                auto lock = vertexBuffers_.getWriteLock();
-                auto pair = vertexBuffers_.insert(std::make_pair(id, DX12VertexBuffer{ data, stride, sizeByte, id }));
-
-                // then build a command to build underlaying resources
-                threadPool->submitGPU(std::bind(&DX12VertexBuffer::create, &pair.first->second, std::placeholders::_1, std::placeholders::_2), std::string(), 0);
-                threadPool->submitGPU(std::bind(&DX12VertexBuffer::cleanupCreate, &pair.first->second, std::placeholders::_1, std::placeholders::_2), std::string(), 1);
-                threadPool->submitGeneric(std::bind(&DX12VertexBuffer::cleanupIntermediate, &pair.first->second), 2);
-            }
-            break;
-        }
-    }
-
     void DX12Context::createConstanBuffer(const std::string& name, uint_fast32_t size)
     {
         auto lock = constantBuffers_.getWriteLock();
@@ -149,6 +130,27 @@ namespace Takoyaki
         res.first->second.create(name, device_.get());
     }
 
+    DX12DynamicBuffer& DX12Context::createDynamicBuffer(EResourceType type, uint_fast32_t id, EFormat format, uint_fast32_t stride, uint_fast32_t sizeByte)
+    {
+        if (type == EResourceType::INDEX_BUFFER) {
+            auto lock = indexBuffers_.getWriteLock();
+            auto pair = indexBuffers_.insert(std::make_pair(id, DX12IndexBuffer{ format, sizeByte, id }));
+
+            lock.unlock();
+            pair.first->second.createDynamic(device_.get());
+
+            return pair.first->second.getDynamic();
+        }
+
+        auto lock = vertexBuffers_.getWriteLock();
+        auto pair = vertexBuffers_.insert(std::make_pair(id, DX12VertexBuffer{ stride, sizeByte, id }));
+
+        lock.unlock();
+        pair.first->second.createDynamic(device_.get());
+
+        return pair.first->second.getDynamic();
+    }
+
     void DX12Context::createInputLayout(const std::string& name)
     {
         auto lock = inputLayouts_.getWriteLock();
@@ -195,6 +197,132 @@ namespace Takoyaki
         //threadPool->submitGPU(std::bind(&DX12Texture::create, &pair.first->second, std::placeholders::_1, std::placeholders::_2), std::string(), 0);
     }
 
+    void DX12Context::createTexture(uint_fast32_t id, const TextureDesc& desc, const SubresourceData* data)
+    {
+        createTexture(id, desc);
+        getTexture(id).upload(device_.get(), data);
+    }
+
+    void DX12Context::createStreamingTexture(uint_fast32_t id, const TextureDesc& desc, const TextureWriter& writer)
+    {
+        createTexture(id, desc);
+
+        auto& texture = getTexture(id);
+        auto& layout = texture.getLayout();
+        std::vector<uint64_t> mipSizes(layout.mipLevels);
+
+        for (uint32_t mip = 0; mip < layout.mipLevels; ++mip)
+            mipSizes[mip] = GetMipSize(layout, mip);
+
+        // the tail goes with the rest of this frame uploads, larger mips follow through streamTextures
+        auto tail = MipStreamer::getTailStart(mipSizes, STREAMING_TAIL_SIZE);
+
+        texture.uploadMips(device_.get(), tail, layout.mipLevels, writer, nullptr);
+        texture.setResidentMip(tail);
+
+        if (tail == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock{ streamMutex_ };
+
+        mipStreamer_.add(static_cast<uint32_t>(id), mipSizes, tail);
+        streamWriters_.insert(std::make_pair(id, writer));
+    }
+
+    void DX12Context::createBindlessTextureView(uint_fast32_t id, uint_fast32_t index)
+    {
+        auto& texture = getTexture(id);
+        auto resource = texture.getResource();
+        auto residentMip = texture.getResidentMip();
+        auto& heap = device_->getShaderVisibleHeap();
+
+        if (residentMip == 0) {
+            auto lock = device_->getDeviceLock();
+
+            device_->getDXDevice()->CreateShaderResourceView(resource, nullptr, heap.getBindlessCPU(index));
+            return;
+        }
+
+        // same view as the default one but sampling is clamped to the resident mips
+        auto resDesc = resource->GetDesc();
+        auto minLOD = static_cast<FLOAT>(residentMip);
+        D3D12_SHADER_RESOURCE_VIEW_DESC desc = {};
+
+        desc.Format = resDesc.Format;
+        desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+
+        switch (resDesc.Dimension) {
+            case D3D12_RESOURCE_DIMENSION_TEXTURE1D:
+                if (resDesc.DepthOrArraySize > 1) {
+                    desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1DARRAY;
+                    desc.Texture1DArray.MipLevels = resDesc.MipLevels;
+                    desc.Texture1DArray.ArraySize = resDesc.DepthOrArraySize;
+                    desc.Texture1DArray.ResourceMinLODClamp = minLOD;
+                } else {
+                    desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1D;
+                    desc.Texture1D.MipLevels = resDesc.MipLevels;
+                    desc.Texture1D.ResourceMinLODClamp = minLOD;
+                }
+                break;
+
+            case D3D12_RESOURCE_DIMENSION_TEXTURE2D:
+                if (resDesc.DepthOrArraySize > 1) {
+                    desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+                    desc.Texture2DArray.MipLevels = resDesc.MipLevels;
+                    desc.Texture2DArray.ArraySize = resDesc.DepthOrArraySize;
+                    desc.Texture2DArray.ResourceMinLODClamp = minLOD;
+                } else {
+                    desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+                    desc.Texture2D.MipLevels = resDesc.MipLevels;
+                    desc.Texture2D.ResourceMinLODClamp = minLOD;
+                }
+                break;
+
+            case D3D12_RESOURCE_DIMENSION_TEXTURE3D:
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE3D;
+                desc.Texture3D.MipLevels = resDesc.MipLevels;
+                desc.Texture3D.ResourceMinLODClamp = minLOD;
+                break;
+
+            default:
+                throw std::runtime_error{ "DX12Context::createBindlessTextureView, resource is not a texture" };
+        }
+
+        auto lock = device_->getDeviceLock();
+
+        device_->getDXDevice()->CreateShaderResourceView(resource, &desc, heap.getBindlessCPU(index));
+    }
+
+    void DX12Context::createBindlessBufferView(EResourceType type, uint_fast32_t id, uint_fast32_t index)
+    {
+        ID3D12Resource* resource;
+        UINT sizeByte;
+
+        if (type == EResourceType::INDEX_BUFFER) {
+            auto& buffer = getIndexBuffer(id);
+
+            resource = buffer.getResource();
+            sizeByte = buffer.getView().SizeInBytes;
+        } else {
+            auto& buffer = getVertexBuffer(id);
+
+            resource = buffer.getResource();
+            sizeByte = buffer.getView().SizeInBytes;
+        }
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC desc = {};
+
+        desc.Format = DXGI_FORMAT_R32_TYPELESS;
+        desc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+        desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        desc.Buffer.NumElements = sizeByte / 4;
+        desc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
+
+        auto lock = device_->getDeviceLock();
+
+        device_->getDXDevice()->CreateShaderResourceView(resource, &desc, device_->getShaderVisibleHeap().getBindlessCPU(index));
+    }
+
     void DX12Context::destroyDone()
     {
         DestroyQueueType::ValueType pair;
@@ -225,6 +353,13 @@ namespace Takoyaki
                 }
                 break;
             }
+
+#ifdef _DEBUG
+            // the resource is gone from its map now, validateHandles catches it from there
+            std::lock_guard<std::mutex> lock{ destroyedMutex_ };
+
+            destroyed_.erase(pair);
+#endif
         } else {
             throw std::runtime_error{ "DX12Context::onDestroyDone called but queue empty" };
         }
@@ -280,6 +415,23 @@ namespace Takoyaki
         // destruction is deferred so add to destroy queue and submit a job request
         auto threadPool = threadPool_.lock();
 
+        if (type == EResourceType::TEXTURE) {
+            std::lock_guard<std::mutex> lock{ streamMutex_ };
+
+            // uploads in flight complete into nothing
+            mipStreamer_.remove(static_cast<uint32_t>(id));
+            streamWriters_.erase(id);
+            bindlessTextures_.erase(id);
+        }
+
+#ifdef _DEBUG
+        {
+            std::lock_guard<std::mutex> lock{ destroyedMutex_ };
+
+            destroyed_.insert(std::make_pair(type, id));
+        }
+#endif
+
         destroyQueue_.push(std::make_pair(type, id));
         threadPool->submitGPU(std::bind(&DX12Context::destroyMain, this, std::placeholders::_1, std::placeholders::_2), std::string(), 0);
         threadPool->submitGeneric(std::bind(&DX12Context::destroyDone, this), 1);
@@ -302,6 +454,37 @@ namespace Takoyaki
         return ConstantBufferReturn(std::pair<DX12ConstantBuffer&, std::shared_lock<std::shared_timed_mutex>>(found->second, std::move(lock)));
     }
 
+    void DX12Context::flushDescriptorCaches()
+    {
+        descHeapRTV_.flushReleased();
+        descHeapSRV_.flushReleased();
+    }
+
+    DescriptorHeapStats DX12Context::getDescriptorHeapStats(EDescriptorHeapType type)
+    {
+        switch (type) {
+            case EDescriptorHeapType::BINDLESS:
+                return device_->getShaderVisibleHeap().getBindlessStats();
+
+            case EDescriptorHeapType::CBV_SRV_UAV:
+                return descHeapSRV_.getStats();
+
+            case EDescriptorHeapType::RTV:
+                return descHeapRTV_.getStats();
+
+            case EDescriptorHeapType::SAMPLER:
+                return samplers_.getStats();
+
+            case EDescriptorHeapType::SHADER_VISIBLE:
+                return device_->getShaderVisibleHeap().getStats();
+
+            case EDescriptorHeapType::TABLE_CACHE:
+                return device_->getShaderVisibleHeap().getTableCacheStats();
+        }
+
+        throw std::runtime_error{ "DX12Context::getDescriptorHeapStats, unknown heap type" };
+    }
+
     const DX12IndexBuffer& DX12Context::getIndexBuffer(uint_fast32_t id)
     {
         auto lock = indexBuffers_.getReadLock();
@@ -385,4 +568,153 @@ namespace Takoyaki
 
         return found->second;
     }
+
+#ifdef _DEBUG
+    void DX12Context::validateHandles(const CommandDesc& desc)
+    {
+        std::lock_guard<std::mutex> lock{ destroyedMutex_ };
+
+        auto check = [this](EResourceType type, auto& map, const std::vector<uint_fast32_t>& handles, const char* name)
+        {
+            auto mapLock = map.getReadLock();
+
+            // waiting for destruction, or already erased once destroyDone ran
+            for (auto handle : handles) {
+                if ((destroyed_.find(std::make_pair(type, handle)) != destroyed_.end()) || (map.find(handle) == map.end())) {
+                    auto fmt = boost::format{ "DX12Context::buildCommand, %1% \"%2%\" was destroyed before the command recording it was built" } % name % handle;
+
+                    throw std::runtime_error{ boost::str(fmt) };
+                }
+            }
+        };
+
+        // named resources are never destroyed, they must still be the object resolved when recording
+        auto checkNamed = [](auto& map, const auto& resolved, const char* name)
+        {
+            auto mapLock = map.getReadLock();
+
+            for (auto& pair : resolved) {
+                auto found = map.find(pair.first);
+
+                if ((found == map.end()) || (&found->second != pair.second)) {
+                    auto fmt = boost::format{ "DX12Context::buildCommand, %1% \"%2%\" was replaced before the command recording it was built" } % name % pair.first;
+
+                    throw std::runtime_error{ boost::str(fmt) };
+                }
+            }
+        };
+
+        check(EResourceType::INDEX_BUFFER, indexBuffers_, desc.handles.indexBuffers, "index buffer");
+        check(EResourceType::TEXTURE, textures_, desc.handles.textures, "texture");
+        check(EResourceType::VERTEX_BUFFER, vertexBuffers_, desc.handles.vertexBuffers, "vertex buffer");
+        checkNamed(constantBuffers_, desc.handles.constantBuffers, "constant buffer");
+        checkNamed(rootSignatures_, desc.handles.rootSignatures, "root signature");
+    }
+#endif
+
+    uint_fast32_t DX12Context::registerBindless(EResourceType type, uint_fast32_t id)
+    {
+        if (type != EResourceType::TEXTURE) {
+            auto dynamic = (type == EResourceType::INDEX_BUFFER) ? getIndexBuffer(id).isDynamic() : getVertexBuffer(id).isDynamic();
+
+            // the view would be stale as soon as the buffer is mapped again
+            if (dynamic)
+                throw std::runtime_error{ "DX12Context::registerBindless, dynamic buffers cannot be bindless" };
+        }
+
+        auto& heap = device_->getShaderVisibleHeap();
+        auto index = heap.allocateBindless();
+
+        if (type == EResourceType::TEXTURE) {
+            std::lock_guard<std::mutex> lock{ streamMutex_ };
+
+            // streaming textures views are updated as their mips arrive
+            if (mipStreamer_.isStreaming(static_cast<uint32_t>(id)))
+                bindlessTextures_.insert(std::make_pair(id, index));
+
+            createBindlessTextureView(id, index);
+        } else {
+            // buffers are created by the workers, write the view once that is done
+            auto threadPool = threadPool_.lock();
+
+            threadPool->submitGeneric([this, type, id, index]() { createBindlessBufferView(type, id, index); }, 1);
+        }
+
+        return index;
+    }
+
+    void DX12Context::unregisterBindless(uint_fast32_t index)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ streamMutex_ };
+
+            for (auto it = bindlessTextures_.begin(); it != bindlessTextures_.end(); ++it) {
+                if (it->second == index) {
+                    bindlessTextures_.erase(it);
+                    break;
+                }
+            }
+        }
+
+        // the current frame may still index it
+        device_->getShaderVisibleHeap().releaseBindless(index, device_->getFenceValue());
+    }
+
+    void DX12Context::streamTextures()
+    {
+        std::vector<std::pair<MipStreamer::Request, TextureWriter>> uploads;
+
+        {
+            std::lock_guard<std::mutex> lock{ streamMutex_ };
+            std::vector<MipStreamer::Request> requests;
+
+            mipStreamer_.schedule(requests);
+
+            for (auto& request : requests)
+                uploads.push_back(std::make_pair(request, streamWriters_[request.id]));
+        }
+
+        // writers are user code, they may call back into the renderer or take a while
+        for (auto& upload : uploads) {
+            auto id = upload.first.id;
+            auto mip = upload.first.mip;
+            DX12Texture* texture;
+
+            {
+                auto lock = textures_.getReadLock();
+                auto found = textures_.find(id);
+
+                // destroyed since it was scheduled, the streamer already forgot it
+                if (found == textures_.end())
+                    continue;
+
+                texture = &found->second;
+            }
+
+            texture->uploadMips(device_.get(), mip, mip + 1, upload.second, [this, id, mip]() { onMipLoaded(id, mip); });
+        }
+    }
+
+    void DX12Context::onMipLoaded(uint_fast32_t id, uint_fast32_t mip)
+    {
+        std::lock_guard<std::mutex> lock{ streamMutex_ };
+        auto residentMip = mipStreamer_.onLoaded(static_cast<uint32_t>(id), static_cast<uint32_t>(mip));
+
+        // destroyed while uploading
+        if (residentMip == MIP_INVALID)
+            return;
+
+        getTexture(id).setResidentMip(residentMip);
+
+        // both views are valid for the whole resource, shaders see either clamp until the next frame
+        auto range = bindlessTextures_.equal_range(id);
+
+        for (auto it = range.first; it != range.second; ++it)
+            createBindlessTextureView(id, it->second);
+
+        if (residentMip == 0) {
+            streamWriters_.erase(id);
+            bindlessTextures_.erase(id);
+        }
+    }
 } // namespace Takoyaki
\ No newline at end of file
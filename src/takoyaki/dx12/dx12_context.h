@@ -29,15 +29,18 @@
 #include "dx12_input_layout.h"
 #include "dx12_pipeline_state.h"
 #include "dx12_root_signature.h"
+#include "dx12_sampler_cache.h"
 #include "dx12_vertex_buffer.h"
 #include "dx12_texture.h"
 #include "../rwlock_map.h"
+#include "../utility/mip_streamer.h"
 #include "../thread_safe_stack.h"
 #include "../thread_safe_queue.h"
 #include "../public/definitions.h"
 
 namespace Takoyaki
 {
+    class DX12DynamicBuffer;
     class ThreadPool;
     struct CommandDesc;
 
@@ -63,7 +66,7 @@ namespace Takoyaki
         using PipelineStateReturn = std::pair<DX12PipelineState&, std::shared_lock<std::shared_timed_mutex>>;
         using RootSignatureReturn = std::pair<DX12RootSignature&, std::shared_lock<std::shared_timed_mutex>>;
 
-        DX12Context(const std::shared_ptr<DX12Device>&, const std::shared_ptr<ThreadPool>&);
+        DX12Context(const std::shared_ptr<DX12Device>&, const std::shared_ptr<ThreadPool>&, const FrameworkDesc&);
         ~DX12Context() = default;
 
         //////////////////////////////////////////////////////////////////////////
@@ -76,24 +79,65 @@ namespace Takoyaki
         void addShader(EShaderType, const std::string&, D3D12_SHADER_BYTECODE&&);
         void createSwapchainTexture(uint_fast32_t);
         void createTexture(uint_fast32_t, const TextureDesc&);
+        void createTexture(uint_fast32_t, const TextureDesc&, const SubresourceData*);
+        void createStreamingTexture(uint_fast32_t, const TextureDesc&, const TextureWriter&);
+
+        // start the next mip uploads of streaming textures, once per frame before the copy queue is submitted
+        void streamTextures();
+
+        // give back descriptors released by threads since the last frame
+        void flushDescriptorCaches();
 
         // Get
         inline DescriptorHeapRTV& getRTVDescHeapCollection() { return descHeapRTV_; }
         inline DescriptorHeapSRV& getSRVDescHeapCollection() { return descHeapSRV_; }
+        DescriptorHeapStats getDescriptorHeapStats(EDescriptorHeapType);
         inline RWLockMap<uint_fast32_t, DX12IndexBuffer>& getIndexBuffers() { return indexBuffers_; }
         inline RWLockMap<std::string, DX12RootSignature>& getRootSignatures() { return rootSignatures_; }
+        inline DX12SamplerCache& getSamplerCache() { return samplers_; }
         inline RWLockMap<uint_fast32_t, DX12Texture>& getTextures() { return textures_; }
         inline RWLockMap<uint_fast32_t, DX12VertexBuffer>& getVertexBuffers() { return vertexBuffers_; }
 
         //////////////////////////////////////////////////////////////////////////
         // Internal & External
 
-        void createBuffer(EResourceType, uint_fast32_t, uint8_t*, EFormat, uint_fast32_t, uint_fast32_t);
+        // data is anything DX12VertexBuffer::create accepts, the resource is created right away
+        template <typename Data>
+        void createBuffer(EResourceType type, uint_fast32_t id, Data&& data, EFormat format, uint_fast32_t stride, uint_fast32_t sizeByte)
+        {
+            switch (type) {
+                case EResourceType::INDEX_BUFFER:
+                {
+                    auto lock = indexBuffers_.getWriteLock();
+                    auto pair = indexBuffers_.insert(std::make_pair(id, DX12IndexBuffer{ format, sizeByte, id }));
+
+                    lock.unlock();
+                    pair.first->second.create(device_.get(), std::forward<Data>(data));
+                }
+                break;
+
+                case EResourceType::VERTEX_BUFFER:
+                {
+                    auto lock = vertexBuffers_.getWriteLock();
+                    auto pair = vertexBuffers_.insert(std::make_pair(id, DX12VertexBuffer{ stride, sizeByte, id }));
+
+                    lock.unlock();
+                    pair.first->second.create(device_.get(), std::forward<Data>(data));
+                }
+                break;
+            }
+        }
+
         void createConstanBuffer(const std::string&, uint_fast32_t);
+        DX12DynamicBuffer& createDynamicBuffer(EResourceType, uint_fast32_t, EFormat, uint_fast32_t, uint_fast32_t);
         void createInputLayout(const std::string&);
         void createPipelineState(const std::string&, const PipelineStateDesc&);
         void createRootSignature(const std::string&);
 
+        // bindless, buffers are viewed as ByteAddressBuffer
+        uint_fast32_t registerBindless(EResourceType, uint_fast32_t);
+        void unregisterBindless(uint_fast32_t);
+
         void destroyDone();
         bool destroyMain(void*, void*);
         void destroyResource(EResourceType, uint_fast32_t);
@@ -114,6 +158,13 @@ namespace Takoyaki
     private:
         void compileMain(const std::string& name);
 
+#ifdef _DEBUG
+        void validateHandles(const CommandDesc&);
+#endif
+        void createBindlessBufferView(EResourceType, uint_fast32_t, uint_fast32_t);
+        void createBindlessTextureView(uint_fast32_t, uint_fast32_t);
+        void onMipLoaded(uint_fast32_t, uint_fast32_t);
+
     private:
         std::shared_ptr<DX12Device> device_;
         std::weak_ptr<ThreadPool> threadPool_;
@@ -121,6 +172,7 @@ namespace Takoyaki
 
         DescriptorHeapRTV descHeapRTV_;
         DescriptorHeapSRV descHeapSRV_;
+        DX12SamplerCache samplers_;
 
         RWLockMap<std::string, DX12ConstantBuffer> constantBuffers_;
         RWLockMap<uint_fast32_t, DX12IndexBuffer> indexBuffers_;
@@ -137,5 +189,17 @@ namespace Takoyaki
         // resource destruction have to be handled by the context
         using DestroyQueueType = ThreadSafeQueue<std::pair<EResourceType, uint_fast32_t>>;
         DestroyQueueType destroyQueue_;
+
+#ifdef _DEBUG
+        // handles are never reused, destroyed ones are kept until destroyDone erased the resource from its map
+        std::mutex destroyedMutex_;
+        std::set<std::pair<EResourceType, uint_fast32_t>> destroyed_;
+#endif
+
+        // mip streaming, bindless views of streaming textures are rewritten as mips become resident
+        std::mutex streamMutex_;
+        MipStreamer mipStreamer_;
+        std::unordered_map<uint_fast32_t, TextureWriter> streamWriters_;
+        std::unordered_multimap<uint_fast32_t, uint_fast32_t> bindlessTextures_;
     };
 } // namespace Takoyaki
\ No newline at end of file
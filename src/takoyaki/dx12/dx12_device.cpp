@@ -27,6 +27,7 @@
 #include "descriptor_heap.h"
 #include "dxutility.h"
 #include "../utility/log.h"
+#include "../utility/radix_sort.h"
 #include "../public/definitions.h"
 
 namespace Takoyaki
@@ -118,6 +119,11 @@ namespace Takoyaki
         commandLists_.resize(bufferCount_);
         dxCommandLists_.resize(bufferCount_);
         commandListMutexes_.resize(bufferCount_);
+        transitionAllocators_.resize(bufferCount_);
+        transitionLists_.resize(bufferCount_);
+
+        for (auto& allocator : transitionAllocators_)
+            DXCheckThrow(D3DDevice_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&allocator)));
 
         // Create synchronization objects.
         fenceValues_.resize(bufferCount_);
@@ -125,6 +131,12 @@ namespace Takoyaki
         DXCheckThrow(D3DDevice_->CreateFence(fenceValues_[currentFrame_], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_)));
         fenceValues_[currentFrame_]++;
         fenceEvent_ = CreateEventEx(nullptr, FALSE, FALSE, EVENT_ALL_ACCESS);
+
+        memoryAllocator_.create(this, desc.resourceHeapSize);
+        shaderVisibleHeap_.create(D3DDevice_.Get(), desc.shaderVisibleHeapSize, desc.bindlessCapacity, desc.tableCacheSize);
+        uploadRing_.create(this, desc.uploadPageSize, bufferCount_);
+        readbackRing_.create(this, desc.readbackPageSize, bufferCount_);
+        uploadManager_.create(this, desc.uploadStagingSize);
     }
 
     void DX12Device::createSwapChain()
@@ -242,20 +254,58 @@ namespace Takoyaki
         auto& cmdList = commandLists_[currentFrame_];
         auto& dxList = dxCommandLists_[currentFrame_];
 
+        // resources uploaded this frame can be used right away, the wait happens on the GPU
+        auto uploadFence = uploadManager_.submit();
+
+        if (uploadFence > 0)
+            DXCheckThrow(commandQueue_->Wait(uploadManager_.getFence(), uploadFence));
+
         if (!cmdList.empty()) {
-            // TODO: parallelize ?
-            std::sort(cmdList.begin(), cmdList.end(), [](const TaskCommand& lhs, const TaskCommand& rhs)
-            {
-                return lhs.priority < rhs.priority;
-            });
+            auto count = cmdList.size();
+
+            // sort indices instead of moving command lists around
+            sortItems_.resize(count);
+            sortScratch_.resize(count);
+
+            for (size_t i = 0; i < count; ++i) {
+                sortItems_[i].key = cmdList[i].sortKey;
+                sortItems_[i].index = static_cast<uint32_t>(i);
+            }
+
+            sorter_.sort(sortItems_.data(), sortScratch_.data(), count);
+
+            // previous use of this allocator is done since we wait for the GPU after each execution
+            DXCheckThrow(transitionAllocators_[currentFrame_]->Reset());
+
+            uint_fast32_t numTransitionLists = 0;
+
+            dxList.reserve(count * 2 + 1);
+
+            for (auto& item : sortItems_) {
+                auto& cmd = cmdList[item.index];
+
+                // tables can be reused once waitForGpu signaled this value
+                shaderVisibleHeap_.setFence(cmd.descriptorTickets, fenceValues_[currentFrame_]);
+
+                // only what the list expect on entry that doesn't match the previous list exit
+                stateResolver_.resolve(cmd.states, transitions_);
+
+                if (!transitions_.empty())
+                    dxList.push_back(recordTransitions(numTransitionLists++));
 
-            // can probably do better
-            for (auto& cmd : cmdList)
                 dxList.push_back(cmd.commands.Get());
+            }
+
+            // back to home states for the swap chain present and for anything outside command lists
+            stateResolver_.restore(transitions_);
 
-            commandQueue_->ExecuteCommandLists(static_cast<uint_fast32_t>(cmdList.size()), &dxList.front());
+            if (!transitions_.empty())
+                dxList.push_back(recordTransitions(numTransitionLists++));
+
+            commandQueue_->ExecuteCommandLists(static_cast<uint_fast32_t>(dxList.size()), &dxList.front());
 
             waitForGpu();
+            shaderVisibleHeap_.retire(fence_->GetCompletedValue());
         }
     }
 
@@ -328,25 +378,56 @@ namespace Takoyaki
             // when the application is killed by the OS. Add proper support
             D3DDevice_.Reset();
             throw std::runtime_error{ "Device removal not implemented" };
-        } else {
-            DXCheckThrow(res);
+        }
 
-            // Schedule a Signal command in the queue.
-            auto current = fenceValues_[currentFrame_];
-            DXCheckThrow(commandQueue_->Signal(fence_.Get(), current));
+        DXCheckThrow(res);
+    }
 
-            // Advance the frame index.
-            currentFrame_ = (currentFrame_ + 1) % bufferCount_;
+    void DX12Device::nextFrame()
+    {
+        // Schedule a Signal command in the queue.
+        auto current = fenceValues_[currentFrame_];
+        DXCheckThrow(commandQueue_->Signal(fence_.Get(), current));
 
-            // Check to see if the next frame is ready to start.
-            if (fence_->GetCompletedValue() < fenceValues_[currentFrame_]) {
-                DXCheckThrow(fence_->SetEventOnCompletion(fenceValues_[currentFrame_], fenceEvent_));
-                WaitForSingleObjectEx(fenceEvent_, INFINITE, FALSE);
-            }
+        // Advance the frame index.
+        currentFrame_ = (currentFrame_ + 1) % bufferCount_;
+
+        // Check to see if the next frame is ready to start.
+        if (fence_->GetCompletedValue() < fenceValues_[currentFrame_]) {
+            DXCheckThrow(fence_->SetEventOnCompletion(fenceValues_[currentFrame_], fenceEvent_));
+            WaitForSingleObjectEx(fenceEvent_, INFINITE, FALSE);
+        }
 
-            // Set the fence value for the next frame.
-            fenceValues_[currentFrame_]++;
+        // Set the fence value for the next frame, values have to keep increasing across frames
+        // for the shader visible heap to know what has been completed
+        fenceValues_[currentFrame_] = current + 1;
+        shaderVisibleHeap_.retire(fence_->GetCompletedValue());
+
+        // the GPU is done with what this frame uploaded and copied back last time
+        readbackRing_.retire(currentFrame_);
+        uploadRing_.reset(currentFrame_);
+        uploadManager_.retire();
+    }
+
+    ID3D12CommandList* DX12Device::recordTransitions(uint_fast32_t index)
+    {
+        auto& lists = transitionLists_[currentFrame_];
+        auto allocator = transitionAllocators_[currentFrame_].Get();
+
+        if (index == lists.size()) {
+            lists.emplace_back();
+            DXCheckThrow(D3DDevice_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, allocator, nullptr, IID_PPV_ARGS(&lists.back())));
+        } else {
+            DXCheckThrow(lists[index]->Reset(allocator, nullptr));
         }
+
+        auto list = lists[index].Get();
+
+        ResourceBarriers(list, transitions_);
+        DXCheckThrow(list->Close());
+        transitions_.clear();
+
+        return list;
     }
 
     void DX12Device::setWindowSize(const glm::vec2& value)
@@ -22,9 +22,16 @@
 
 #include <boost/any.hpp>
 
+#include "dx12_memory_allocator.h"
+#include "dx12_readback_ring.h"
 #include "dx12_texture.h"
 #include "dxcommon.h"
+#include "dx12_shader_visible_heap.h"
+#include "dx12_upload_manager.h"
+#include "dx12_upload_ring.h"
 #include "../thread_safe_stack.h"
+#include "../utility/copy_engine.h"
+#include "../utility/radix_sort.h"
 #include "../public/definitions.h"
 
 namespace Takoyaki
@@ -51,15 +58,28 @@ namespace Takoyaki
         void present();
         void validate();
 
+        // wait for the next frame to be available and recycle its resources, nothing may record meanwhile
+        void nextFrame();
+
         void executeCommandList();
 
         inline uint_fast32_t getFrameCount() const { return bufferCount_; }
         inline uint_fast32_t getCurrentFrame() const { return currentFrame_; }
+
+        // signaled once the work of the current frame is done
+        inline uint64_t getFenceValue() const { return fenceValues_[currentFrame_]; }
         inline DX12Texture* getRenderTarget(uint_fast32_t frame) { return renderTargets_[frame]; }
 
         inline CommandListReturn getCommandList() { return CommandListReturn(commandLists_[currentFrame_.load()], std::unique_lock<std::mutex>(commandListMutexes_[currentFrame_.load()])); }
         inline std::unique_lock<std::mutex> getDeviceLock() { return std::unique_lock<std::mutex>(deviceMutex_); }
         inline const Microsoft::WRL::ComPtr<ID3D12Device>& getDXDevice() { return D3DDevice_; }
+        inline CopyEngine& getCopyEngine() { return copyEngine_; }
+        inline DX12MemoryAllocator& getMemoryAllocator() { return memoryAllocator_; }
+        inline DX12ReadbackRing& getReadbackRing() { return readbackRing_; }
+        inline DX12ShaderVisibleHeap& getShaderVisibleHeap() { return shaderVisibleHeap_; }
+        inline RadixSorter& getSorter() { return sorter_; }
+        inline DX12UploadManager& getUploadManager() { return uploadManager_; }
+        inline DX12UploadRing& getUploadRing() { return uploadRing_; }
 
         // properties
         inline const glm::vec2& getWindowSize() const { return windowSize_; }
@@ -71,6 +91,7 @@ namespace Takoyaki
     private:
         void createDevice(const FrameworkDesc&);
         DXGI_MODE_ROTATION getDXGIOrientation() const;
+        ID3D12CommandList* recordTransitions(uint_fast32_t);
         void waitForGpu();
 
     private:
@@ -84,6 +105,35 @@ namespace Takoyaki
         Microsoft::WRL::ComPtr<ID3D12CommandQueue>  commandQueue_;
         std::vector<std::vector<TaskCommand>> commandLists_;
         std::vector<std::vector<ID3D12CommandList*>> dxCommandLists_;
+        std::vector<SortItem> sortItems_;
+        std::vector<SortItem> sortScratch_;
+
+        // frame submission order, large frames are sorted with the worker threads
+        RadixSorter sorter_;
+
+        // resource states across command lists, transitions are recorded in small lists of their own
+        ResourceStateResolver stateResolver_;
+        std::vector<ResourceTransition> transitions_;
+        std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> transitionAllocators_;
+        std::vector<std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>>> transitionLists_;
+
+        // placed resources, must outlive any buffer owned by the device
+        DX12MemoryAllocator memoryAllocator_;
+
+        // descriptor tables are copied here by the command builders
+        DX12ShaderVisibleHeap shaderVisibleHeap_;
+
+        // per frame transient constant data
+        DX12UploadRing uploadRing_;
+
+        // per frame texture data copied back to the CPU
+        DX12ReadbackRing readbackRing_;
+
+        // copies into upload memory, uses the worker threads once the thread pool is running
+        CopyEngine copyEngine_;
+
+        // static resource data, on its own copy queue
+        DX12UploadManager uploadManager_;
 
         // cpu synchronization
         std::mutex deviceMutex_;
@@ -0,0 +1,111 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dx12_dynamic_buffer.h"
+
+#include "dx12_buffer.h"
+#include "dx12_device.h"
+#include "dxutility.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        // slots are 256 bytes aligned like the upload ring so both can be used for any buffer view
+        uint_fast32_t slotSize(uint_fast32_t sizeByte)
+        {
+            return (sizeByte + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+        }
+    }
+
+    DX12DynamicBuffer::DX12DynamicBuffer(uint_fast32_t sizeByte, uint_fast32_t numFrames) noexcept
+        : buffer_{ std::make_unique<DX12Buffer>(D3D12_HEAP_TYPE_UPLOAD, slotSize(sizeByte) * numFrames, D3D12_RESOURCE_STATE_GENERIC_READ) }
+        , cpu_{ nullptr }
+        , gpu_{ 0 }
+        , address_{ 0 }
+        , mappedAddress_{ 0 }
+        , mappedCPU_{ nullptr }
+        , size_{ sizeByte }
+        , slotSize_{ slotSize(sizeByte) }
+        , lastFence_{ 0 }
+        , mapped_{ false }
+    {
+    }
+
+    DX12DynamicBuffer::~DX12DynamicBuffer() = default;
+
+    void DX12DynamicBuffer::create(DX12Device* device, const std::wstring& name)
+    {
+        buffer_->create(device);
+
+        auto res = buffer_->getResource();
+
+        res->SetName(name.c_str());
+        gpu_ = res->GetGPUVirtualAddress();
+        address_ = gpu_;
+
+        // the CPU never reads from it, keep it mapped for its whole lifetime
+        D3D12_RANGE readRange = { 0, 0 };
+
+        DXCheckThrow(res->Map(0, &readRange, reinterpret_cast<void**>(&cpu_)));
+    }
+
+    ID3D12Resource* DX12DynamicBuffer::getResource() const
+    {
+        return buffer_->getResource();
+    }
+
+    uint8_t* DX12DynamicBuffer::map(DX12Device* device, bool discard)
+    {
+        if (mapped_)
+            throw std::runtime_error{ "DX12DynamicBuffer::map, buffer is already mapped" };
+
+        // the fence value identifies the frame being recorded, the frame index alone repeats
+        auto frame = device->getCurrentFrame();
+        auto fence = device->getFenceValue();
+
+        if (fence != lastFence_) {
+            // first map this frame, the previous use of this slot has completed
+            mappedCPU_ = cpu_ + (frame * slotSize_);
+            mappedAddress_ = gpu_ + (frame * slotSize_);
+            lastFence_ = fence;
+        } else if (discard) {
+            // commands recorded earlier this frame still point to the previous region, rename it
+            auto alloc = device->getUploadRing().allocate(frame, size_);
+
+            mappedCPU_ = alloc.cpu;
+            mappedAddress_ = alloc.gpu;
+        }
+
+        mapped_ = true;
+
+        return mappedCPU_;
+    }
+
+    void DX12DynamicBuffer::unmap()
+    {
+        if (!mapped_)
+            throw std::runtime_error{ "DX12DynamicBuffer::unmap, buffer is not mapped" };
+
+        mapped_ = false;
+        address_ = mappedAddress_;
+    }
+} // namespace Takoyaki
@@ -0,0 +1,64 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+namespace Takoyaki
+{
+    class DX12Buffer;
+    class DX12Device;
+
+    // Per-frame CPU written buffer, one persistently mapped slot per frame in flight so the CPU never
+    // writes a region the GPU may still read. Mapping again with discard in the same frame orphans the
+    // previous contents and returns fresh memory from the upload ring instead of waiting on the GPU
+    class DX12DynamicBuffer
+    {
+        DX12DynamicBuffer(const DX12DynamicBuffer&) = delete;
+        DX12DynamicBuffer& operator=(const DX12DynamicBuffer&) = delete;
+        DX12DynamicBuffer(DX12DynamicBuffer&&) = delete;
+        DX12DynamicBuffer& operator=(DX12DynamicBuffer&&) = delete;
+
+    public:
+        explicit DX12DynamicBuffer(uint_fast32_t, uint_fast32_t) noexcept;
+        ~DX12DynamicBuffer();
+
+        void create(DX12Device*, const std::wstring&);
+
+        // contents are not preserved from one frame to the next, the whole range must be written
+        uint8_t* map(DX12Device*, bool);
+        void unmap();
+
+        // address of the last unmapped contents, this is what commands recorded now will read
+        inline D3D12_GPU_VIRTUAL_ADDRESS getAddress() const { return address_.load(); }
+        ID3D12Resource* getResource() const;
+
+    private:
+        std::unique_ptr<DX12Buffer> buffer_;
+        uint8_t* cpu_;
+        D3D12_GPU_VIRTUAL_ADDRESS gpu_;
+        std::atomic<D3D12_GPU_VIRTUAL_ADDRESS> address_;
+        D3D12_GPU_VIRTUAL_ADDRESS mappedAddress_;
+        uint8_t* mappedCPU_;
+        uint_fast32_t size_;
+        uint_fast32_t slotSize_;
+        uint64_t lastFence_;
+        bool mapped_;
+    };
+} // namespace Takoyaki
@@ -26,7 +26,7 @@ namespace Takoyaki
 {
     class DX12Buffer;
     class DX12Device;
-    class ThreadPool;
+    class DX12DynamicBuffer;
 
     // For simplicity, bundle vertex and index buffer here
     class DX12IndexBuffer
@@ -36,35 +36,44 @@ namespace Takoyaki
         DX12IndexBuffer& operator=(DX12IndexBuffer&&) = delete;
 
     public:
-        explicit DX12IndexBuffer(uint8_t*, EFormat, uint_fast32_t, uint_fast32_t) noexcept;
+        explicit DX12IndexBuffer(EFormat, uint_fast32_t, uint_fast32_t) noexcept;
         DX12IndexBuffer(DX12IndexBuffer&&) noexcept;
-        ~DX12IndexBuffer() = default;
+        ~DX12IndexBuffer();
 
         //////////////////////////////////////////////////////////////////////////
         // Internal usage:
 
+        // see DX12UploadManager::uploadBuffer for how each data source is uploaded
+        void create(DX12Device*, const uint8_t*);
+        void create(DX12Device*, std::vector<uint8_t>&&);
+        void create(DX12Device*, const UploadWriter&);
+
+        // written by the CPU every frame, see DX12DynamicBuffer
+        void createDynamic(DX12Device*);
+
         // tasks
-        bool create(void*, void*);
-        bool cleanupCreate(void*, void*);
-        void cleanupIntermediate();
         bool destroy(void*, void*);
 
         //////////////////////////////////////////////////////////////////////////
         // Internal & External
 
-        inline D3D12_INDEX_BUFFER_VIEW getView() const { return view_; }
+        // dynamic buffers point to the contents last unmapped
+        D3D12_INDEX_BUFFER_VIEW getView() const;
+        ID3D12Resource* getResource() const;
+        inline bool isDynamic() const { return dynamic_ != nullptr; }
+        inline DX12DynamicBuffer& getDynamic() const { return *dynamic_; }
+
+        // the data is on the GPU, queues waiting on the copy fence can use it before that
+        inline bool isReady() const { return ready_.load(); }
 
     private:
-        struct Intermediate
-        {
-            std::vector<uint8_t> data;
-            D3D12_SUBRESOURCE_DATA dataDesc;
-            uint_fast32_t id;
-        };
+        ID3D12Resource* createResource(DX12Device*);
 
+    private:
         std::unique_ptr<DX12Buffer> indexBuffer_;
-        std::unique_ptr<DX12Buffer> uploadBuffer_;
-        std::unique_ptr<Intermediate> intermediate_;
+        std::unique_ptr<DX12DynamicBuffer> dynamic_;
         D3D12_INDEX_BUFFER_VIEW view_;
+        uint_fast32_t id_;
+        std::atomic<bool> ready_;
     };
 } // namespace Takoyaki
\ No newline at end of file
@@ -0,0 +1,204 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dx12_memory_allocator.h"
+
+#include "dx12_device.h"
+#include "dxutility.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        D3D12_HEAP_PROPERTIES HeapProperties(D3D12_HEAP_TYPE type)
+        {
+            D3D12_HEAP_PROPERTIES prop;
+
+            prop.Type = type;
+
+            // let the driver decide about those properties
+            prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+            prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+
+            // no multi-gpu support for now
+            prop.CreationNodeMask = 1;
+            prop.VisibleNodeMask = 1;
+
+            return prop;
+        }
+    }
+
+    DX12Allocation::DX12Allocation() noexcept
+        : pool{ 0 }
+        , heap{ 0 }
+        , offset{ BUDDY_INVALID }
+    {
+    }
+
+    DX12MemoryAllocator::DX12MemoryAllocator() noexcept
+        : device_{ nullptr }
+        , heapSize_{ 0 }
+    {
+    }
+
+    void DX12MemoryAllocator::create(DX12Device* device, uint_fast32_t heapSize)
+    {
+        if ((heapSize & (heapSize - 1)) != 0) {
+            auto fmt = boost::format{ "DX12MemoryAllocator::create, heap size %1% must be a power of two" } % heapSize;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        device_ = device;
+        heapSize_ = heapSize;
+
+        // resource heap tier 1 cannot mix buffers and textures, keep them apart for every tier
+        pools_[POOL_BUFFER_DEFAULT].type = D3D12_HEAP_TYPE_DEFAULT;
+        pools_[POOL_BUFFER_DEFAULT].flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+        pools_[POOL_BUFFER_UPLOAD].type = D3D12_HEAP_TYPE_UPLOAD;
+        pools_[POOL_BUFFER_UPLOAD].flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+        pools_[POOL_TEXTURE].type = D3D12_HEAP_TYPE_DEFAULT;
+        pools_[POOL_TEXTURE].flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+    }
+
+    uint_fast32_t DX12MemoryAllocator::createHeap(Pool& pool)
+    {
+        D3D12_HEAP_DESC desc;
+
+        desc.SizeInBytes = heapSize_;
+        desc.Properties = HeapProperties(pool.type);
+        desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        desc.Flags = pool.flags;
+
+        // reuse the slot of a heap released when it became empty so allocations keep their index
+        uint_fast32_t index = 0;
+
+        while ((index < pool.heaps.size()) && (pool.heaps[index].heap != nullptr))
+            ++index;
+
+        if (index == pool.heaps.size())
+            pool.heaps.emplace_back();
+
+        auto& heap = pool.heaps[index];
+
+        DXCheckThrow(device_->getDXDevice()->CreateHeap(&desc, IID_PPV_ARGS(&heap.heap)));
+        heap.allocator = std::make_unique<BuddyAllocator>(heapSize_, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+        return index;
+    }
+
+    DX12Allocation DX12MemoryAllocator::createResource(const D3D12_RESOURCE_DESC& desc, D3D12_HEAP_TYPE type, D3D12_RESOURCE_STATES initialState, Microsoft::WRL::ComPtr<ID3D12Resource>& resource)
+    {
+        auto dxDevice = device_->getDXDevice();
+        auto info = dxDevice->GetResourceAllocationInfo(0, 1, &desc);
+        auto poolIndex = selectPool(desc, type, info);
+        DX12Allocation res;
+
+        if (poolIndex == POOL_COMMITTED) {
+            auto prop = HeapProperties(type);
+
+            // multi-thread safe, no need to lock
+            DXCheckThrow(dxDevice->CreateCommittedResource(&prop, D3D12_HEAP_FLAG_NONE, &desc, initialState, nullptr, IID_PPV_ARGS(&resource)));
+
+            return res;
+        }
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        auto& pool = pools_[poolIndex];
+
+        res.pool = poolIndex;
+
+        for (uint_fast32_t i = 0; i < pool.heaps.size(); ++i) {
+            auto& heap = pool.heaps[i];
+
+            if (heap.allocator == nullptr)
+                continue;
+
+            res.offset = heap.allocator->allocate(info.SizeInBytes);
+
+            if (res.offset != BUDDY_INVALID) {
+                res.heap = i;
+                break;
+            }
+        }
+
+        if (!res.isPlaced()) {
+            res.heap = createHeap(pool);
+            res.offset = pool.heaps[res.heap].allocator->allocate(info.SizeInBytes);
+        }
+
+        auto& heap = pool.heaps[res.heap];
+        auto hr = dxDevice->CreatePlacedResource(heap.heap.Get(), res.offset, &desc, initialState, nullptr, IID_PPV_ARGS(&resource));
+
+        if (FAILED(hr))
+            heap.allocator->free(res.offset);
+
+        DXCheckThrow(hr);
+
+        return res;
+    }
+
+    void DX12MemoryAllocator::release(const DX12Allocation& allocation)
+    {
+        if (!allocation.isPlaced())
+            return;
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        auto& heaps = pools_[allocation.pool].heaps;
+        auto& heap = heaps[allocation.heap];
+
+        heap.allocator->free(allocation.offset);
+
+        // give back empty heaps except the first one of each pool, to avoid creating one at every allocation
+        if ((allocation.heap > 0) && heap.allocator->isEmpty()) {
+            heap.allocator.reset();
+            heap.heap.Reset();
+        }
+    }
+
+    auto DX12MemoryAllocator::selectPool(const D3D12_RESOURCE_DESC& desc, D3D12_HEAP_TYPE type, const D3D12_RESOURCE_ALLOCATION_INFO& info) const -> EPool
+    {
+        // large resources would waste most of a heap, MSAA need 4MB alignment
+        if ((heapSize_ == 0) || (info.SizeInBytes > heapSize_ / 4) || (info.Alignment > D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT))
+            return POOL_COMMITTED;
+
+        if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+            switch (type) {
+                case D3D12_HEAP_TYPE_DEFAULT:
+                    return POOL_BUFFER_DEFAULT;
+
+                case D3D12_HEAP_TYPE_UPLOAD:
+                    return POOL_BUFFER_UPLOAD;
+
+                default:
+                    return POOL_COMMITTED;
+            }
+        }
+
+        // placed render targets and depth stencils must be cleared or discarded before their first use
+        auto targetFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+        if ((type == D3D12_HEAP_TYPE_DEFAULT) && ((desc.Flags & targetFlags) == 0))
+            return POOL_TEXTURE;
+
+        return POOL_COMMITTED;
+    }
+} // namespace Takoyaki
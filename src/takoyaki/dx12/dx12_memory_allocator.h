@@ -0,0 +1,96 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "../utility/buddy_allocator.h"
+
+namespace Takoyaki
+{
+    class DX12Device;
+
+    // where a resource memory comes from, committed resources have no offset
+    struct DX12Allocation
+    {
+        DX12Allocation() noexcept;
+
+        inline bool isPlaced() const { return offset != BUDDY_INVALID; }
+
+        uint_fast32_t pool;
+        uint_fast32_t heap;
+        uint64_t offset;
+    };
+
+    // Resources are placed in large heaps instead of being committed one by one
+    // Buffers and non render target textures are sub-allocated with a buddy allocator in heaps of a
+    // fixed size, render targets, depth stencils, readback and anything larger than a quarter of a heap
+    // still get a committed resource of their own
+    class DX12MemoryAllocator
+    {
+        DX12MemoryAllocator(const DX12MemoryAllocator&) = delete;
+        DX12MemoryAllocator& operator=(const DX12MemoryAllocator&) = delete;
+        DX12MemoryAllocator(DX12MemoryAllocator&&) = delete;
+        DX12MemoryAllocator& operator=(DX12MemoryAllocator&&) = delete;
+
+    public:
+        DX12MemoryAllocator() noexcept;
+        ~DX12MemoryAllocator() = default;
+
+        // heap size must be a power of two, 0 commit every resource
+        void create(DX12Device*, uint_fast32_t);
+
+        // thread-safe
+        DX12Allocation createResource(const D3D12_RESOURCE_DESC&, D3D12_HEAP_TYPE, D3D12_RESOURCE_STATES, Microsoft::WRL::ComPtr<ID3D12Resource>&);
+
+        // the resource must have been released and no longer be in use by the GPU
+        void release(const DX12Allocation&);
+
+    private:
+        enum EPool
+        {
+            POOL_BUFFER_DEFAULT,
+            POOL_BUFFER_UPLOAD,
+            POOL_TEXTURE,
+            POOL_COMMITTED
+        };
+
+        struct Heap
+        {
+            Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+            std::unique_ptr<BuddyAllocator> allocator;
+        };
+
+        struct Pool
+        {
+            std::vector<Heap> heaps;
+            D3D12_HEAP_TYPE type;
+            D3D12_HEAP_FLAGS flags;
+        };
+
+        uint_fast32_t createHeap(Pool&);
+        EPool selectPool(const D3D12_RESOURCE_DESC&, D3D12_HEAP_TYPE, const D3D12_RESOURCE_ALLOCATION_INFO&) const;
+
+    private:
+        DX12Device* device_;
+        std::array<Pool, POOL_COMMITTED> pools_;
+        std::mutex mutex_;
+        uint64_t heapSize_;
+    };
+} // namespace Takoyaki
@@ -0,0 +1,126 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dx12_readback_ring.h"
+
+#include "dx12_buffer.h"
+#include "dx12_device.h"
+#include "dxutility.h"
+
+namespace Takoyaki
+{
+    DX12ReadbackRing::~DX12ReadbackRing() = default;
+
+    void DX12ReadbackRing::create(DX12Device* device, uint_fast64_t pageSize, uint_fast32_t frameCount)
+    {
+        if (pageSize == 0)
+            return;
+
+        pages_.resize(frameCount);
+
+        for (uint_fast32_t i = 0; i < frameCount; ++i) {
+            auto& page = pages_[i];
+            auto fmt = boost::wformat{ L"Readback Ring %1%" } % i;
+
+            page.buffer = std::make_unique<DX12Buffer>(D3D12_HEAP_TYPE_READBACK, pageSize, D3D12_RESOURCE_STATE_COPY_DEST);
+            page.buffer->create(device);
+            page.allocator = std::make_unique<LinearAllocator>(pageSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+            auto res = page.buffer->getResource();
+
+            res->SetName(boost::str(fmt).c_str());
+
+            // readback heaps are write-back memory, they can stay mapped and are only read once the fence completed
+            DXCheckThrow(res->Map(0, nullptr, reinterpret_cast<void**>(&page.cpu)));
+        }
+    }
+
+    void DX12ReadbackRing::readTexture(DX12Device* device, ID3D12GraphicsCommandList* commands, ID3D12Resource* src, uint_fast32_t subresource, ReadbackCallback callback)
+    {
+        if (pages_.empty())
+            throw std::runtime_error{ "DX12ReadbackRing::readTexture, readback is disabled, FrameworkDesc::readbackPageSize is 0" };
+
+        auto desc = src->GetDesc();
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+        UINT numRows;
+        UINT64 rowSizeByte;
+        UINT64 sizeByte;
+
+        device->getDXDevice()->GetCopyableFootprints(&desc, static_cast<UINT>(subresource), 1, 0, &footprint, &numRows, &rowSizeByte, &sizeByte);
+
+        // commands are built for the current frame, so are its readbacks
+        auto frame = device->getCurrentFrame();
+        auto& page = pages_[frame];
+        auto offset = page.allocator->allocate(sizeByte);
+
+        if (offset == LINEAR_INVALID) {
+            auto fmt = boost::format{ "DX12ReadbackRing::readTexture, cannot allocate %1% bytes, the %2% bytes page of this frame is full, increase FrameworkDesc::readbackPageSize" } % sizeByte % page.allocator->getCapacity();
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        D3D12_TEXTURE_COPY_LOCATION dstLoc, srcLoc;
+
+        footprint.Offset = offset;
+        dstLoc.pResource = page.buffer->getResource();
+        dstLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        dstLoc.PlacedFootprint = footprint;
+        srcLoc.pResource = src;
+        srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        srcLoc.SubresourceIndex = static_cast<UINT>(subresource);
+
+        commands->CopyTextureRegion(&dstLoc, 0, 0, 0, &srcLoc, nullptr);
+
+        // rows of every depth slice follow each other at the same pitch
+        Request request;
+
+        request.offset = offset;
+        request.rowSizeByte = static_cast<uint_fast32_t>(rowSizeByte);
+        request.rowPitch = footprint.Footprint.RowPitch;
+        request.numRows = numRows * footprint.Footprint.Depth;
+        request.callback = std::move(callback);
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        page.requests.push_back(std::move(request));
+    }
+
+    void DX12ReadbackRing::retire(uint_fast32_t frame)
+    {
+        if (pages_.empty())
+            return;
+
+        auto& page = pages_[frame];
+        std::vector<Request> requests;
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            requests.swap(page.requests);
+        }
+
+        // outside of the lock, callbacks are free to record more readbacks
+        for (auto& request : requests)
+            request.callback(page.cpu + request.offset, request.rowSizeByte, request.rowPitch, request.numRows);
+
+        page.allocator->reset();
+    }
+} // namespace Takoyaki
@@ -0,0 +1,74 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "../utility/linear_allocator.h"
+#include "../public/definitions.h"
+
+namespace Takoyaki
+{
+    class DX12Buffer;
+    class DX12Device;
+
+    // Texture data copied back to the CPU without stalling, one persistently mapped readback page per frame
+    // copies are recorded with the frame commands and callbacks are called once the fence of that frame
+    // completed, right before its page is reused
+    class DX12ReadbackRing
+    {
+        DX12ReadbackRing(const DX12ReadbackRing&) = delete;
+        DX12ReadbackRing& operator=(const DX12ReadbackRing&) = delete;
+        DX12ReadbackRing(DX12ReadbackRing&&) = delete;
+        DX12ReadbackRing& operator=(DX12ReadbackRing&&) = delete;
+
+    public:
+        DX12ReadbackRing() = default;
+        ~DX12ReadbackRing();
+
+        void create(DX12Device*, uint_fast64_t, uint_fast32_t);
+
+        // the source must be in COPY_SOURCE state, throw when the page is full
+        void readTexture(DX12Device*, ID3D12GraphicsCommandList*, ID3D12Resource*, uint_fast32_t, ReadbackCallback);
+
+        // the GPU is done with the frame
+        void retire(uint_fast32_t);
+
+    private:
+        struct Request
+        {
+            uint_fast64_t offset;
+            uint_fast32_t rowSizeByte;
+            uint_fast32_t rowPitch;
+            uint_fast32_t numRows;
+            ReadbackCallback callback;
+        };
+
+        struct Page
+        {
+            std::unique_ptr<DX12Buffer> buffer;
+            std::unique_ptr<LinearAllocator> allocator;
+            std::vector<Request> requests;
+            uint8_t* cpu;
+        };
+
+        std::mutex mutex_;
+        std::vector<Page> pages_;
+    };
+} // namespace Takoyaki
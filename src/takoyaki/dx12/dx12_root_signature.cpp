@@ -131,6 +131,12 @@ namespace Takoyaki
         range.add(DescriptorTypeToDX(type), numDescriptors, baseShaderRegister);
     }
 
+    void DX12RootSignature::addStaticSampler(const SamplerDesc& desc, uint_fast32_t shaderRegister)
+    {
+        // Static samplers are baked in the root signature and do not count toward its size
+        intermediate_->samplers.push_back(StaticSamplerDescToDX(desc, shaderRegister));
+    }
+
     bool DX12RootSignature::create(DX12Device* device)
     {
         if ((intermediate_) && (intermediate_->params.size() > 0)) {
@@ -154,9 +160,8 @@ namespace Takoyaki
             desc.pParameters = &intermediate_->params.front();
             desc.Flags = intermediate_->flags;
 
-            // TODO: add sampler support
-            desc.NumStaticSamplers = 0;
-            desc.pStaticSamplers = nullptr;
+            desc.NumStaticSamplers = static_cast<UINT>(intermediate_->samplers.size());
+            desc.pStaticSamplers = intermediate_->samplers.empty() ? nullptr : &intermediate_->samplers.front();
 
             Microsoft::WRL::ComPtr<ID3DBlob> pSignature;
             Microsoft::WRL::ComPtr<ID3DBlob> pError;
@@ -52,6 +52,7 @@ namespace Takoyaki
         void addDescriptorUnorderedAccess(uint_fast32_t);
         void addDescriptorShaderResource(uint_fast32_t);
         uint_fast32_t addDescriptorTable();
+        void addStaticSampler(const SamplerDesc&, uint_fast32_t);
 
         // only when using descriptor tables
         void addDescriptorRange(uint_fast32_t, EDescriptorType, uint_fast32_t, uint_fast32_t);
@@ -64,6 +65,7 @@ namespace Takoyaki
             Intermediate() noexcept;
             std::vector<D3D12_ROOT_PARAMETER> params;
             std::vector<DX12DescriptorRanges> ranges;
+            std::vector<D3D12_STATIC_SAMPLER_DESC> samplers;
             D3D12_ROOT_SIGNATURE_FLAGS flags;
 
             // The maximum size of a root signature is 64 DWORDs.
@@ -0,0 +1,133 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dx12_sampler_cache.h"
+
+#include "dxutility.h"
+
+namespace Takoyaki
+{
+    extern template DX12DescriptorHeapCollection<D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER>;
+
+    namespace
+    {
+        // D3D12_SAMPLER_DESC is only made of 32-bit fields
+        size_t HashSamplerDesc(const D3D12_SAMPLER_DESC& desc)
+        {
+            auto words = reinterpret_cast<const uint32_t*>(&desc);
+            size_t res = 14695981039346656037ULL;
+
+            for (size_t i = 0; i < sizeof(D3D12_SAMPLER_DESC) / sizeof(uint32_t); ++i) {
+                res ^= words[i];
+                res *= 1099511628211ULL;
+            }
+
+            return res;
+        }
+
+        DescriptorHeapDesc MakeSamplerHeapDesc(uint_fast32_t capacity)
+        {
+            if ((capacity == 0) || (capacity > D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE)) {
+                auto fmt = boost::format{ "DX12SamplerCache, samplerHeapSize %1% must be between 1 and %2%" } % capacity % D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE;
+
+                throw std::runtime_error{ boost::str(fmt) };
+            }
+
+            DescriptorHeapDesc res;
+
+            res.capacity = capacity;
+            res.growth = EDescriptorHeapGrowth::FIXED;
+
+            return res;
+        }
+    }
+
+    DX12SamplerCache::DX12SamplerCache(const std::shared_ptr<DX12Device>& device, uint_fast32_t capacity)
+        : device_{ device }
+        , heap_{ device, MakeSamplerHeapDesc(capacity) }
+        , boundHeap_{ nullptr }
+    {
+    }
+
+    uint_fast32_t DX12SamplerCache::getSampler(const SamplerDesc& desc)
+    {
+        auto dxDesc = SamplerDescToDX(desc);
+        auto hash = HashSamplerDesc(dxDesc);
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        auto found = lookup_.equal_range(hash);
+
+        for (auto it = found.first; it != found.second; ++it) {
+            if (memcmp(&entries_[it->second].desc, &dxDesc, sizeof(D3D12_SAMPLER_DESC)) == 0)
+                return it->second;
+        }
+
+        auto range = heap_.createRange(1);
+
+        // a second heap cannot be bound together with the first one
+        if ((range.index >> DESCRIPTOR_SLOT_BITS) != 0) {
+            heap_.releaseRange(range);
+
+            auto fmt = boost::format{ "DX12SamplerCache::getSampler, more than %1% unique samplers, increase FrameworkDesc::samplerHeapSize" } % entries_.size();
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        {
+            auto device = device_.lock();
+            auto deviceLock = device->getDeviceLock();
+
+            device->getDXDevice()->CreateSampler(&dxDesc, range.getCPU(0));
+        }
+
+        auto res = static_cast<uint_fast32_t>(entries_.size());
+
+        boundHeap_ = range.heap->descriptor.Get();
+        entries_.push_back(Entry{ dxDesc, range });
+        lookup_.insert(std::make_pair(hash, res));
+
+        return res;
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE DX12SamplerCache::getTable(uint_fast32_t id)
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        if (id >= entries_.size()) {
+            auto fmt = boost::format{ "DX12SamplerCache::getTable, invalid sampler %1%" } % id;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        return entries_[id].range.getGPU(0);
+    }
+
+    ID3D12DescriptorHeap* DX12SamplerCache::getHeap()
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        return boundHeap_;
+    }
+
+    DescriptorHeapStats DX12SamplerCache::getStats()
+    {
+        return heap_.getStats();
+    }
+} // namespace Takoyaki
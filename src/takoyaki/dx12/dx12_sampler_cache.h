@@ -0,0 +1,67 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "descriptor_heap.h"
+
+namespace Takoyaki
+{
+    // Sampler descriptors for the cases static samplers can't cover, identical descs share one descriptor
+    // The heap is shader visible so a sampler is bound as a one descriptor table without any copy,
+    // only one sampler heap can be bound at a time so the cache never grows past FrameworkDesc::samplerHeapSize
+    // Samplers live as long as the context, there are only a handful of unique ones in practice
+    // Thread-safe
+    class DX12SamplerCache
+    {
+        DX12SamplerCache(const DX12SamplerCache&) = delete;
+        DX12SamplerCache& operator=(const DX12SamplerCache&) = delete;
+        DX12SamplerCache(DX12SamplerCache&&) = delete;
+        DX12SamplerCache& operator=(DX12SamplerCache&&) = delete;
+
+    public:
+        using DescriptorHeapSampler = DX12DescriptorHeapCollection<D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER>;
+
+        DX12SamplerCache(const std::shared_ptr<DX12Device>&, uint_fast32_t);
+        ~DX12SamplerCache() = default;
+
+        // return the id of an existing sampler when the desc match
+        uint_fast32_t getSampler(const SamplerDesc&);
+        D3D12_GPU_DESCRIPTOR_HANDLE getTable(uint_fast32_t);
+
+        // nullptr until the first sampler is created
+        ID3D12DescriptorHeap* getHeap();
+        DescriptorHeapStats getStats();
+
+    private:
+        struct Entry
+        {
+            D3D12_SAMPLER_DESC desc;
+            DX12DescriptorRange range;
+        };
+
+        std::mutex mutex_;
+        std::weak_ptr<DX12Device> device_;
+        DescriptorHeapSampler heap_;
+        ID3D12DescriptorHeap* boundHeap_;
+        std::vector<Entry> entries_;
+        std::unordered_multimap<size_t, uint_fast32_t> lookup_;     // hash of the D3D desc to entries_ index
+    };
+} // namespace Takoyaki
@@ -0,0 +1,298 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dx12_shader_visible_heap.h"
+
+#include "dxutility.h"
+
+namespace
+{
+    // tickets of the table cache are uses, the ring never gets that far
+    constexpr uint64_t TABLE_CACHE_TICKET = 1ULL << 63;
+}
+
+namespace Takoyaki
+{
+    DX12ShaderVisibleHeap::DX12ShaderVisibleHeap() noexcept
+        : device_{ nullptr }
+        , descriptorSize_{ 0 }
+        , bindlessCapacity_{ 0 }
+        , ringStart_{ 0 }
+        , peak_{ 0 }
+        , bindlessPeak_{ 0 }
+        , tableCachePeak_{ 0 }
+    {
+        cpuStart_.ptr = 0;
+        gpuStart_.ptr = 0;
+    }
+
+    void DX12ShaderVisibleHeap::create(ID3D12Device* device, uint_fast32_t capacity, uint_fast32_t bindlessCapacity, uint_fast32_t tableCacheCapacity)
+    {
+        D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+
+        // bindless array first so that its table start at the beginning of the heap, then cached tables and the ring
+        desc.NumDescriptors = bindlessCapacity + tableCacheCapacity + capacity;
+        desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+
+        DXCheckThrow(device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&heap_)));
+        heap_->SetName(L"Shader Visible Heap");
+
+        device_ = device;
+        ring_ = std::make_unique<DescriptorRing>(static_cast<uint32_t>(capacity));
+        bindlessCapacity_ = bindlessCapacity;
+        ringStart_ = bindlessCapacity + tableCacheCapacity;
+
+        if (bindlessCapacity > 0)
+            bindless_ = std::make_unique<FencedIndexAllocator>(static_cast<uint32_t>(bindlessCapacity));
+
+        if (tableCacheCapacity > 0)
+            tableCache_ = std::make_unique<DescriptorTableCache>(static_cast<uint32_t>(tableCacheCapacity));
+
+        cpuStart_ = heap_->GetCPUDescriptorHandleForHeapStart();
+        gpuStart_ = heap_->GetGPUDescriptorHandleForHeapStart();
+        descriptorSize_ = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE DX12ShaderVisibleHeap::copyTable(const D3D12_CPU_DESCRIPTOR_HANDLE* src, uint_fast32_t count, uint64_t& ticket)
+    {
+        uint32_t offset;
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            offset = ring_->allocate(static_cast<uint32_t>(count), ticket);
+            peak_ = (std::max)(peak_, static_cast<uint_fast32_t>(ring_->getCapacity() - ring_->getNumFree()));
+        }
+
+        if (offset == RING_INVALID) {
+            auto fmt = boost::format{ "DX12ShaderVisibleHeap::copyTable, ring is full, cannot allocate %1% descriptors" } % count;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        copyDescriptors(ringStart_ + offset, src, count);
+
+        return getGPU(ringStart_ + offset);
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE DX12ShaderVisibleHeap::copyTable(const std::vector<uint64_t>& binding, const D3D12_CPU_DESCRIPTOR_HANDLE* src, uint_fast32_t count, uint64_t& ticket)
+    {
+        if (!tableCache_)
+            return copyTable(src, count, ticket);
+
+        uint32_t offset;
+        bool hit = false;
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            offset = tableCache_->find(binding, ticket);
+
+            if (offset != TABLE_CACHE_MISS) {
+                hit = true;
+            } else {
+                offset = tableCache_->insert(binding, static_cast<uint32_t>(count), ticket);
+                tableCachePeak_ = (std::max)(tableCachePeak_, static_cast<uint_fast32_t>(tableCache_->getNumUsed()));
+            }
+        }
+
+        // everything is in flight, a transient table will do
+        if (offset == TABLE_CACHE_MISS)
+            return copyTable(src, count, ticket);
+
+        ticket |= TABLE_CACHE_TICKET;
+
+        if (!hit)
+            copyDescriptors(bindlessCapacity_ + offset, src, count);
+
+        return getGPU(bindlessCapacity_ + offset);
+    }
+
+    void DX12ShaderVisibleHeap::copyDescriptors(uint_fast32_t offset, const D3D12_CPU_DESCRIPTOR_HANDLE* src, uint_fast32_t count)
+    {
+        if (count == 0)
+            return;
+
+        D3D12_CPU_DESCRIPTOR_HANDLE dst;
+
+        dst.ptr = cpuStart_.ptr + offset * descriptorSize_;
+
+        // descriptor copies are free-threaded, no need for the device lock
+        // views allocated together from the same heap are next to each other, a single range is the common case
+        uint_fast32_t numRanges = 1;
+
+        for (uint_fast32_t i = 1; i < count; ++i) {
+            if (src[i].ptr != src[i - 1].ptr + descriptorSize_)
+                ++numRanges;
+        }
+
+        if (numRanges == 1) {
+            device_->CopyDescriptorsSimple(static_cast<UINT>(count), dst, src[0], D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+            return;
+        }
+
+        // still one call, each run of adjacent sources is a range
+        std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> srcStarts;
+        std::vector<UINT> srcSizes;
+
+        srcStarts.reserve(numRanges);
+        srcSizes.reserve(numRanges);
+
+        for (uint_fast32_t i = 0; i < count; ++i) {
+            if ((i > 0) && (src[i].ptr == src[i - 1].ptr + descriptorSize_)) {
+                ++srcSizes.back();
+            } else {
+                srcStarts.push_back(src[i]);
+                srcSizes.push_back(1);
+            }
+        }
+
+        UINT dstSize = static_cast<UINT>(count);
+
+        device_->CopyDescriptors(1, &dst, &dstSize, static_cast<UINT>(numRanges), srcStarts.data(), srcSizes.data(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE DX12ShaderVisibleHeap::getGPU(uint_fast32_t offset) const
+    {
+        D3D12_GPU_DESCRIPTOR_HANDLE res;
+
+        res.ptr = gpuStart_.ptr + offset * descriptorSize_;
+
+        return res;
+    }
+
+    void DX12ShaderVisibleHeap::setFence(const std::vector<uint64_t>& tickets, uint64_t fence)
+    {
+        if (tickets.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        for (auto ticket : tickets) {
+            if (ticket & TABLE_CACHE_TICKET)
+                tableCache_->setFence(ticket & ~TABLE_CACHE_TICKET, fence);
+            else
+                ring_->setFence(ticket, fence);
+        }
+    }
+
+    uint_fast32_t DX12ShaderVisibleHeap::allocateBindless()
+    {
+        if (!bindless_)
+            throw std::runtime_error{ "DX12ShaderVisibleHeap::allocateBindless, bindless is disabled, FrameworkDesc::bindlessCapacity is 0" };
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        auto index = bindless_->allocate();
+
+        if (index == BITMAP_INVALID) {
+            auto fmt = boost::format{ "DX12ShaderVisibleHeap::allocateBindless, all %1% indices are used or waiting for the GPU" } % bindlessCapacity_;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        bindlessPeak_ = (std::max)(bindlessPeak_, static_cast<uint_fast32_t>(bindless_->getNumUsed()));
+
+        return index;
+    }
+
+    void DX12ShaderVisibleHeap::releaseBindless(uint_fast32_t index, uint64_t fence)
+    {
+        if (!bindless_)
+            throw std::runtime_error{ "DX12ShaderVisibleHeap::releaseBindless, bindless is disabled" };
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        bindless_->release(static_cast<uint32_t>(index), fence);
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE DX12ShaderVisibleHeap::getBindlessCPU(uint_fast32_t index) const
+    {
+        D3D12_CPU_DESCRIPTOR_HANDLE res;
+
+        res.ptr = cpuStart_.ptr + index * descriptorSize_;
+
+        return res;
+    }
+
+    DescriptorHeapStats DX12ShaderVisibleHeap::getBindlessStats()
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        DescriptorHeapStats res;
+
+        if (bindless_) {
+            res.numHeaps = 1;
+            res.capacity = bindlessCapacity_;
+            res.used = bindless_->getNumUsed();
+            res.peak = bindlessPeak_;
+        }
+
+        return res;
+    }
+
+    DescriptorHeapStats DX12ShaderVisibleHeap::getStats()
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        DescriptorHeapStats res;
+
+        res.numHeaps = 1;
+        res.capacity = ring_->getCapacity();
+        res.used = ring_->getCapacity() - ring_->getNumFree();
+        res.peak = peak_;
+
+        return res;
+    }
+
+    DescriptorHeapStats DX12ShaderVisibleHeap::getTableCacheStats()
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+        DescriptorHeapStats res;
+
+        if (tableCache_) {
+            auto& ranges = tableCache_->getRanges();
+
+            res.numHeaps = 1;
+            res.capacity = tableCache_->getCapacity();
+            res.used = tableCache_->getNumUsed();
+            res.peak = tableCachePeak_;
+            res.numFreeBlocks = ranges.getNumFreeBlocks();
+            res.largestFreeBlock = ranges.getLargestFree();
+
+            if (ranges.getNumFree() > 0)
+                res.fragmentation = 1.f - static_cast<float>(res.largestFreeBlock) / static_cast<float>(ranges.getNumFree());
+        }
+
+        return res;
+    }
+
+    void DX12ShaderVisibleHeap::retire(uint64_t completedFence)
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        ring_->retire(completedFence);
+
+        if (bindless_)
+            bindless_->retire(completedFence);
+
+        if (tableCache_)
+            tableCache_->retire(completedFence);
+    }
+} // namespace Takoyaki
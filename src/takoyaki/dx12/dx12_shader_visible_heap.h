@@ -0,0 +1,89 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "../utility/descriptor_ring.h"
+#include "../utility/descriptor_table_cache.h"
+#include "../utility/fenced_index_allocator.h"
+#include "../public/definitions.h"
+
+namespace Takoyaki
+{
+    // The only CBV/SRV/UAV heap bound to command lists, persistent descriptors live in CPU only
+    // heaps and the tables used by a command are copied here in a ring reclaimed with the frame fence
+    // The start of the heap is the bindless array, resources registered there are indexed directly
+    // by shaders and indices are reused once the fence given at release completed
+    // Tables copied with a binding set are kept after the bindless array so binding the same set again
+    // is a lookup, they fall back to the ring when the cache is full of tables still in flight
+    // Thread-safe
+    class DX12ShaderVisibleHeap
+    {
+        DX12ShaderVisibleHeap(const DX12ShaderVisibleHeap&) = delete;
+        DX12ShaderVisibleHeap& operator=(const DX12ShaderVisibleHeap&) = delete;
+        DX12ShaderVisibleHeap(DX12ShaderVisibleHeap&&) = delete;
+        DX12ShaderVisibleHeap& operator=(DX12ShaderVisibleHeap&&) = delete;
+
+    public:
+        DX12ShaderVisibleHeap() noexcept;
+        ~DX12ShaderVisibleHeap() = default;
+
+        void create(ID3D12Device*, uint_fast32_t, uint_fast32_t, uint_fast32_t);
+
+        // copy descriptors into a contiguous table, the ticket must be given a fence after submission
+        D3D12_GPU_DESCRIPTOR_HANDLE copyTable(const D3D12_CPU_DESCRIPTOR_HANDLE*, uint_fast32_t, uint64_t&);
+
+        // same but reuse the table of a previous copy with the same binding set, which must identify the content
+        D3D12_GPU_DESCRIPTOR_HANDLE copyTable(const std::vector<uint64_t>&, const D3D12_CPU_DESCRIPTOR_HANDLE*, uint_fast32_t, uint64_t&);
+        void setFence(const std::vector<uint64_t>&, uint64_t);
+        void retire(uint64_t);
+
+        // bindless
+        uint_fast32_t allocateBindless();
+        void releaseBindless(uint_fast32_t, uint64_t);
+        D3D12_CPU_DESCRIPTOR_HANDLE getBindlessCPU(uint_fast32_t) const;
+        inline D3D12_GPU_DESCRIPTOR_HANDLE getBindlessTable() const { return gpuStart_; }
+
+        DescriptorHeapStats getBindlessStats();
+        DescriptorHeapStats getStats();
+        DescriptorHeapStats getTableCacheStats();
+        inline ID3D12DescriptorHeap* getHeap() { return heap_.Get(); }
+
+    private:
+        void copyDescriptors(uint_fast32_t, const D3D12_CPU_DESCRIPTOR_HANDLE*, uint_fast32_t);
+        D3D12_GPU_DESCRIPTOR_HANDLE getGPU(uint_fast32_t) const;
+
+    private:
+        std::mutex mutex_;
+        ID3D12Device* device_;
+        Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> heap_;
+        std::unique_ptr<DescriptorRing> ring_;
+        std::unique_ptr<FencedIndexAllocator> bindless_;    // nullptr when disabled
+        std::unique_ptr<DescriptorTableCache> tableCache_;  // nullptr when disabled
+        D3D12_CPU_DESCRIPTOR_HANDLE cpuStart_;
+        D3D12_GPU_DESCRIPTOR_HANDLE gpuStart_;
+        uint_fast32_t descriptorSize_;
+        uint_fast32_t bindlessCapacity_;
+        uint_fast32_t ringStart_;
+        uint_fast32_t peak_;
+        uint_fast32_t bindlessPeak_;
+        uint_fast32_t tableCachePeak_;
+    };
+} // namespace Takoyaki
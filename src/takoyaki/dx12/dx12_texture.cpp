@@ -24,13 +24,22 @@
 #include <intsafe.h>
 
 #include "dx12_context.h"
+#include "dx12_device.h"
+#include "dx12_upload_manager.h"
+#include "DXUtility.h"
 #include "../public/definitions.h"
+#include "../utility/copy_engine.h"
 
 namespace Takoyaki
 {
     DX12Texture::DX12Texture(DX12Context* owner) noexcept
         : owner_{ owner }
+        , allocator_{ nullptr }
+        , rtvIndex_{ DESCRIPTOR_INVALID }
         , initialState_{ D3D12_RESOURCE_STATE_PRESENT }
+        , layout_{}
+        , format_{ DXGI_FORMAT_UNKNOWN }
+        , residentMip_{ 0 }
     {
         // for swap chain creation
         cpuHandle_.ptr = ULONG_PTR_MAX;
@@ -39,7 +48,12 @@ namespace Takoyaki
     DX12Texture::DX12Texture(DX12Context* owner, const TextureDesc& desc, D3D12_RESOURCE_STATES initialState) noexcept
         : owner_{ owner }
         , intermediate_{ std::make_unique<Intermediate>() }
+        , allocator_{ nullptr }
+        , rtvIndex_{ DESCRIPTOR_INVALID }
         , initialState_{ initialState }
+        , layout_{}
+        , format_{ DXGI_FORMAT_UNKNOWN }
+        , residentMip_{ 0 }
     {
         cpuHandle_.ptr = ULONG_PTR_MAX;
         intermediate_->desc = desc;
@@ -49,42 +63,44 @@ namespace Takoyaki
         : owner_{ other.owner_ }
         , intermediate_{ std::move(other.intermediate_) }
         , resource_{ std::move(other.resource_) }
+        , allocator_{ other.allocator_ }
+        , allocation_{ other.allocation_ }
         , cpuHandle_{ std::move(other.cpuHandle_) }
+        , rtvIndex_{ other.rtvIndex_ }
         , initialState_{ other.initialState_ }
+        , layout_{ other.layout_ }
+        , format_{ other.format_ }
+        , residentMip_{ other.residentMip_.load() }
     {
         other.cpuHandle_.ptr = ULONG_PTR_MAX;
+        other.rtvIndex_ = DESCRIPTOR_INVALID;
+        other.allocator_ = nullptr;
     }
 
     DX12Texture::~DX12Texture()
     {
-        if (cpuHandle_.ptr != ULONG_PTR_MAX) {
-            owner_->getRTVDescHeapCollection().releaseOne(cpuHandle_);
+        if (rtvIndex_ != DESCRIPTOR_INVALID) {
+            owner_->getRTVDescHeapCollection().releaseOne(rtvIndex_);
         }
+
+        // the memory can only be reused once the placed resource is gone
+        resource_.Reset();
+
+        if (allocator_ != nullptr)
+            allocator_->release(allocation_);
     }
 
     void DX12Texture::create(DX12Device* device)
     {
-        D3D12_HEAP_PROPERTIES prop;
         const TextureDesc& texDesc = intermediate_->desc;
 
         // default values let the drivers decided what is best
-        D3D12_CPU_PAGE_PROPERTY cpu = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
         D3D12_TEXTURE_LAYOUT layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 
         if (texDesc.usage == EUsageType::CPU_READ) {
-            //cpu = D3D12_CPU_PAGE_PROPERTY_WRITE_BACK;
             //layout = D3D12_TEXTURE_LAYOUT_64KB_STANDARD_SWIZZLE;
         }
 
-        // texture can only be default type
-        prop.Type = UsageTypeToDX(texDesc.usage);
-        prop.CPUPageProperty = cpu;
-        prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-
-        // no multi-gpu support for now
-        prop.CreationNodeMask = 1;
-        prop.VisibleNodeMask = 1;
-
         // https://msdn.microsoft.com/en-us/library/windows/desktop/dn903813(v=vs.85).aspx
         D3D12_RESOURCE_DESC desc;
 
@@ -115,12 +131,77 @@ namespace Takoyaki
             desc.Width = texDesc.width;
         }
 
-        // multi-thread safe, no need to lock
-        DXCheckThrow(device->getDXDevice()->CreateCommittedResource(&prop, D3D12_HEAP_FLAG_NONE, &desc, initialState_, nullptr, IID_PPV_ARGS(&resource_)));
+        allocator_ = &device->getMemoryAllocator();
+        allocation_ = allocator_->createResource(desc, UsageTypeToDX(texDesc.usage), initialState_, resource_);
+
+        // mipmaps 0 means the whole chain, the resource knows how many there are
+        auto resDesc = resource_->GetDesc();
+
+        layout_.width = static_cast<uint32_t>(resDesc.Width);
+        layout_.height = resDesc.Height;
+        layout_.depth = (resDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D) ? resDesc.DepthOrArraySize : 1;
+        layout_.arraySize = (resDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D) ? 1 : resDesc.DepthOrArraySize;
+        layout_.mipLevels = resDesc.MipLevels;
+        layout_.bytesPerTexel = static_cast<uint32_t>(GetFormatSize(texDesc.format));
+        layout_.blockSize = 1;
+        format_ = resDesc.Format;
 
         intermediate_.reset();
     }
 
+    void DX12Texture::upload(DX12Device* device, const SubresourceData* data)
+    {
+        if ((initialState_ != D3D12_RESOURCE_STATE_COMMON) || (layout_.bytesPerTexel == 0))
+            throw std::runtime_error{ "DX12Texture::upload, only GPU_ONLY textures of a known format can be uploaded" };
+
+        std::vector<uint_fast32_t> subresources(layout_.mipLevels * layout_.arraySize);
+        auto& engine = device->getCopyEngine();
+
+        std::iota(subresources.begin(), subresources.end(), 0);
+
+        // pitch conversion from the application layout in the same pass
+        auto writer = [&engine, data](uint_fast32_t subresource, uint8_t* dst, const SubresourceFootprint& fp)
+        {
+            auto& src = data[subresource];
+            CopyRegion region;
+
+            region.dst = dst;
+            region.src = static_cast<const uint8_t*>(src.data);
+            region.dstRowPitch = fp.rowPitch;
+            region.dstSlicePitch = static_cast<size_t>(fp.rowPitch) * fp.numRows;
+            region.srcRowPitch = src.rowPitch;
+            region.srcSlicePitch = src.slicePitch;
+            region.rowSizeByte = fp.rowSizeByte;
+            region.numRows = fp.numRows;
+            region.numSlices = fp.depth;
+
+            engine.copy(region);
+        };
+
+        device->getUploadManager().uploadTexture(resource_.Get(), format_, layout_, subresources, writer, nullptr);
+    }
+
+    void DX12Texture::uploadMips(DX12Device* device, uint_fast32_t firstMip, uint_fast32_t lastMip, const TextureWriter& writer, std::function<void()> onComplete)
+    {
+        if ((initialState_ != D3D12_RESOURCE_STATE_COMMON) || (layout_.bytesPerTexel == 0))
+            throw std::runtime_error{ "DX12Texture::uploadMips, only GPU_ONLY textures of a known format can be uploaded" };
+
+        std::vector<uint_fast32_t> subresources;
+        auto mipLevels = layout_.mipLevels;
+
+        for (uint32_t slice = 0; slice < layout_.arraySize; ++slice) {
+            for (auto mip = firstMip; mip < lastMip; ++mip)
+                subresources.push_back(CalcSubresource(mip, slice, mipLevels));
+        }
+
+        auto adapter = [&writer, mipLevels](uint_fast32_t subresource, uint8_t* dst, const SubresourceFootprint& fp)
+        {
+            writer(subresource % mipLevels, subresource / mipLevels, dst, fp.rowPitch, fp.rowPitch * fp.numRows);
+        };
+
+        device->getUploadManager().uploadTexture(resource_.Get(), format_, layout_, subresources, adapter, std::move(onComplete));
+    }
+
     bool DX12Texture::destroy(void* command, void*)
     {
         auto cmd = static_cast<TaskCommand*>(command);
@@ -137,6 +218,7 @@ namespace Takoyaki
             auto tuple = owner_->getRTVDescHeapCollection().createOne();
 
             cpuHandle_ = std::get<0>(tuple);
+            rtvIndex_ = std::get<3>(tuple);
 
             ID3D12Device* pDevice;
 
@@ -159,17 +241,4 @@ namespace Takoyaki
 
         return size;
     }
-
-    void DX12Texture::read(uint8_t* dest, uint_fast32_t size) const
-    {
-        auto desc = resource_->GetDesc();
-        uint_fast64_t rowSize = 0;
-        ID3D12Device* pDevice;
-
-        resource_->GetDevice(__uuidof(*pDevice), reinterpret_cast<void**>(&pDevice));
-        pDevice->GetCopyableFootprints(&desc, 0, 1, 0, nullptr, nullptr, &rowSize, nullptr);
-        pDevice->Release();
-
-        resource_->ReadFromSubresource(dest, (uint_fast32_t)rowSize, size, 0, nullptr);
-    }
 } // namespace Takoyaki
\ No newline at end of file
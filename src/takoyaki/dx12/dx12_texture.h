@@ -20,7 +20,9 @@
 
 #pragma once
 
+#include "dx12_memory_allocator.h"
 #include "../public/definitions.h"
+#include "../utility/texture_layout.h"
 
 namespace Takoyaki
 {
@@ -45,10 +47,20 @@ namespace Takoyaki
         void create(DX12Device*);
         bool destroy(void*, void*);
 
+        // through the upload manager, the texture must be GPU_ONLY
+        // data has one entry per subresource, mips [firstMip, lastMip) of every array slice are written by the writer
+        void upload(DX12Device*, const SubresourceData*);
+        void uploadMips(DX12Device*, uint_fast32_t, uint_fast32_t, const TextureWriter&, std::function<void()>);
+
         inline bool isReady() const { return resource_.Get() != nullptr; }
         inline Microsoft::WRL::ComPtr<ID3D12Resource>& getCOM() { return resource_; } // for swap chain creation
         inline D3D12_RESOURCE_STATES getInitialState() const { return initialState_; }
         inline ID3D12Resource* getResource() { return resource_.Get(); }
+        inline const TextureLayoutDesc& getLayout() const { return layout_; }
+
+        // mips from this one are resident, larger ones are still streaming
+        inline uint_fast32_t getResidentMip() const { return residentMip_.load(); }
+        inline void setResidentMip(uint_fast32_t mip) { residentMip_ = mip; }
 
         //////////////////////////////////////////////////////////////////////////
         // Internal & External:
@@ -57,7 +69,6 @@ namespace Takoyaki
 
         //////////////////////////////////////////////////////////////////////////
         // External:
-        void read(uint8_t*, uint_fast32_t size) const;
 
         uint_fast64_t getSizeByte() const;
 
@@ -70,7 +81,13 @@ namespace Takoyaki
         DX12Context* owner_;
         std::unique_ptr<Intermediate> intermediate_;
         Microsoft::WRL::ComPtr<ID3D12Resource> resource_;
+        DX12MemoryAllocator* allocator_;           // nullptr for swap chain buffers
+        DX12Allocation allocation_;
         D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle_;
+        uint_fast32_t rtvIndex_;
         D3D12_RESOURCE_STATES initialState_;
+        TextureLayoutDesc layout_;
+        DXGI_FORMAT format_;
+        std::atomic<uint_fast32_t> residentMip_;
     };
 } // namespace Takoyaki
\ No newline at end of file
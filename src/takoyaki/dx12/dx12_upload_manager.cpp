@@ -0,0 +1,370 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dx12_upload_manager.h"
+
+#include "dx12_buffer.h"
+#include "dx12_device.h"
+#include "dxutility.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        // staging offsets are multiples of this, the placement alignment required by texture copies
+        constexpr uint_fast32_t STAGING_BLOCK_SIZE = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+    }
+
+    DX12UploadManager::DX12UploadManager() noexcept
+        : device_{ nullptr }
+        , stagingAddr_{ nullptr }
+        , fenceValue_{ 0 }
+        , fenceEvent_{ nullptr }
+    {
+    }
+
+    DX12UploadManager::~DX12UploadManager()
+    {
+        // staging memory and destination resources must outlive the copies
+        if (fence_ != nullptr)
+            waitFor(fenceValue_);
+
+        if (fenceEvent_ != nullptr)
+            CloseHandle(fenceEvent_);
+    }
+
+    void DX12UploadManager::create(DX12Device* device, uint_fast32_t stagingSize)
+    {
+        if (stagingSize < STAGING_BLOCK_SIZE) {
+            auto fmt = boost::format{ "DX12UploadManager::create, staging size must be at least %1% bytes" } % STAGING_BLOCK_SIZE;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        device_ = device;
+
+        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+
+        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+
+        auto dxDevice = device->getDXDevice();
+
+        DXCheckThrow(dxDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&queue_)));
+        DXCheckThrow(dxDevice->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_)));
+        fenceEvent_ = CreateEventEx(nullptr, FALSE, FALSE, EVENT_ALL_ACCESS);
+        queue_->SetName(L"Upload Copy Queue");
+
+        staging_ = std::make_unique<DX12Buffer>(D3D12_HEAP_TYPE_UPLOAD, stagingSize, D3D12_RESOURCE_STATE_GENERIC_READ);
+        staging_->create(device);
+        ring_ = std::make_unique<DescriptorRing>(stagingSize / STAGING_BLOCK_SIZE);
+
+        auto res = staging_->getResource();
+        D3D12_RANGE readRange = { 0, 0 };
+
+        res->SetName(L"Upload Staging");
+
+        // the CPU never reads from it, keep it mapped for its whole lifetime
+        DXCheckThrow(res->Map(0, &readRange, reinterpret_cast<void**>(&stagingAddr_)));
+    }
+
+    uint_fast64_t DX12UploadManager::allocateStaging(uint_fast32_t sizeByte, uint64_t& ticket)
+    {
+        auto count = static_cast<uint32_t>((sizeByte + STAGING_BLOCK_SIZE - 1) / STAGING_BLOCK_SIZE);
+
+        if ((count == 0) || (count > ring_->getCapacity())) {
+            auto fmt = boost::format{ "DX12UploadManager, cannot upload %1% bytes, the staging memory is %2% bytes, increase FrameworkDesc::uploadStagingSize" } % sizeByte % (ring_->getCapacity() * STAGING_BLOCK_SIZE);
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        for (;;) {
+            auto offset = ring_->allocate(count, ticket);
+
+            if (offset != RING_INVALID)
+                return static_cast<uint_fast64_t>(offset) * STAGING_BLOCK_SIZE;
+
+            // full, send what is waiting so it can be reclaimed or wait for the oldest copies
+            if (!pending_.empty()) {
+                submitPending();
+            } else if (!inFlight_.empty()) {
+                waitFor(inFlight_.front().fence);
+                retireCompleted();
+            } else {
+                throw std::runtime_error{ "DX12UploadManager, staging memory is held by writers that haven't finished" };
+            }
+        }
+    }
+
+    void DX12UploadManager::retire()
+    {
+        std::vector<std::function<void()>> callbacks;
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            retireCompleted();
+            callbacks.swap(completed_);
+        }
+
+        // outside of the lock, callbacks are free to request more uploads
+        for (auto& callback : callbacks)
+            callback();
+    }
+
+    void DX12UploadManager::retireCompleted()
+    {
+        auto completed = fence_->GetCompletedValue();
+
+        ring_->retire(completed);
+
+        while (!inFlight_.empty() && (inFlight_.front().fence <= completed)) {
+            auto& batch = inFlight_.front();
+
+            freeAllocators_.push_back(std::move(batch.allocator));
+
+            for (auto& callback : batch.callbacks)
+                completed_.push_back(std::move(callback));
+
+            inFlight_.pop_front();
+        }
+    }
+
+    uint64_t DX12UploadManager::submit()
+    {
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        return submitPending();
+    }
+
+    uint64_t DX12UploadManager::submitPending()
+    {
+        streamOwned();
+
+        if (pending_.empty())
+            return 0;
+
+        Batch batch;
+
+        if (freeAllocators_.empty()) {
+            auto lock = device_->getDeviceLock();
+
+            DXCheckThrow(device_->getDXDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&batch.allocator)));
+        } else {
+            batch.allocator = std::move(freeAllocators_.back());
+            freeAllocators_.pop_back();
+            DXCheckThrow(batch.allocator->Reset());
+        }
+
+        if (commandList_ == nullptr) {
+            auto lock = device_->getDeviceLock();
+
+            DXCheckThrow(device_->getDXDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, batch.allocator.Get(), nullptr, IID_PPV_ARGS(&commandList_)));
+        } else {
+            DXCheckThrow(commandList_->Reset(batch.allocator.Get(), nullptr));
+        }
+
+        // everything requested since the last submit goes in one list
+        auto staging = staging_->getResource();
+
+        for (auto& copy : pending_) {
+            if (copy.footprint.Format == DXGI_FORMAT_UNKNOWN) {
+                commandList_->CopyBufferRegion(copy.dst, copy.dstOffset, staging, copy.srcOffset, copy.size);
+            } else {
+                D3D12_TEXTURE_COPY_LOCATION dst;
+                D3D12_TEXTURE_COPY_LOCATION src;
+
+                dst.pResource = copy.dst;
+                dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+                dst.SubresourceIndex = static_cast<UINT>(copy.dstOffset);
+
+                src.pResource = staging;
+                src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+                src.PlacedFootprint.Offset = copy.srcOffset;
+                src.PlacedFootprint.Footprint = copy.footprint;
+
+                commandList_->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+            }
+        }
+
+        DXCheckThrow(commandList_->Close());
+
+        ID3D12CommandList* lists[] = { commandList_.Get() };
+
+        queue_->ExecuteCommandLists(1, lists);
+        DXCheckThrow(queue_->Signal(fence_.Get(), ++fenceValue_));
+
+        for (auto ticket : pendingTickets_)
+            ring_->setFence(ticket, fenceValue_);
+
+        batch.callbacks.swap(pendingCallbacks_);
+        batch.fence = fenceValue_;
+        inFlight_.push_back(std::move(batch));
+        pending_.clear();
+        pendingTickets_.clear();
+
+        return fenceValue_;
+    }
+
+    void DX12UploadManager::streamOwned()
+    {
+        // chunks leave room for the other uploads, what doesn't fit waits for the next submit
+        auto maxChunk = (std::max)(ring_->getCapacity() / 4, 1U) * static_cast<size_t>(STAGING_BLOCK_SIZE);
+
+        while (!owned_.empty()) {
+            auto& upload = owned_.front();
+            auto chunk = (std::min)(upload.data.size() - upload.copied, maxChunk);
+            uint64_t ticket;
+            auto offset = ring_->allocate(static_cast<uint32_t>((chunk + STAGING_BLOCK_SIZE - 1) / STAGING_BLOCK_SIZE), ticket);
+
+            if (offset == RING_INVALID)
+                break;
+
+            auto stagingOffset = static_cast<uint_fast64_t>(offset) * STAGING_BLOCK_SIZE;
+
+            device_->getCopyEngine().copy(stagingAddr_ + stagingOffset, &upload.data[upload.copied], chunk);
+            pending_.push_back({ upload.dst, upload.dstOffset + upload.copied, stagingOffset, chunk });
+            pendingTickets_.push_back(ticket);
+            upload.copied += chunk;
+
+            if (upload.copied == upload.data.size()) {
+                if (upload.callback)
+                    pendingCallbacks_.push_back(std::move(upload.callback));
+
+                owned_.pop_front();
+            }
+        }
+    }
+
+    void DX12UploadManager::uploadBuffer(ID3D12Resource* dst, uint_fast64_t dstOffset, const void* data, uint_fast32_t sizeByte, std::function<void()> onComplete)
+    {
+        auto& engine = device_->getCopyEngine();
+
+        uploadBuffer(dst, dstOffset, sizeByte, [&engine, data](uint8_t* staging, uint_fast32_t size) { engine.copy(staging, data, size); }, std::move(onComplete));
+    }
+
+    void DX12UploadManager::uploadBuffer(ID3D12Resource* dst, uint_fast64_t dstOffset, uint_fast32_t sizeByte, const UploadWriter& writer, std::function<void()> onComplete)
+    {
+        uint64_t ticket;
+        uint_fast64_t offset;
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            offset = allocateStaging(sizeByte, ticket);
+        }
+
+        // the ticket isn't pending yet so a submit from another thread leaves this block alone
+        try {
+            writer(stagingAddr_ + offset, sizeByte);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            // nothing to copy, the block can be reclaimed right away
+            ring_->setFence(ticket, 0);
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        pending_.push_back({ dst, dstOffset, offset, sizeByte });
+        pendingTickets_.push_back(ticket);
+
+        if (onComplete)
+            pendingCallbacks_.push_back(std::move(onComplete));
+    }
+
+    void DX12UploadManager::uploadBuffer(ID3D12Resource* dst, uint_fast64_t dstOffset, std::vector<uint8_t>&& data, std::function<void()> onComplete)
+    {
+        if (data.empty())
+            throw std::runtime_error{ "DX12UploadManager::uploadBuffer, no data to upload" };
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        owned_.push_back({ dst, dstOffset, std::move(data), 0, std::move(onComplete) });
+    }
+
+    void DX12UploadManager::uploadTexture(ID3D12Resource* dst, DXGI_FORMAT format, const TextureLayoutDesc& layout, const std::vector<uint_fast32_t>& subresources, const SubresourceWriter& writer, std::function<void()> onComplete)
+    {
+        auto count = static_cast<uint32_t>(subresources.size());
+        std::vector<SubresourceFootprint> footprints(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+            footprints[i] = GetFootprint(layout, static_cast<uint32_t>(subresources[i]));
+
+        // staging blocks are placement aligned, footprints can be placed from the start of the allocation
+        auto sizeByte = PlaceFootprints(footprints.data(), count, 0);
+
+        if ((count == 0) || (sizeByte > UINT32_MAX))
+            throw std::runtime_error{ "DX12UploadManager::uploadTexture, nothing to upload or too large for a single upload" };
+
+        uint64_t ticket;
+        uint_fast64_t offset;
+
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            offset = allocateStaging(static_cast<uint_fast32_t>(sizeByte), ticket);
+        }
+
+        try {
+            for (uint32_t i = 0; i < count; ++i)
+                writer(subresources[i], stagingAddr_ + offset + footprints[i].offset, footprints[i]);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            ring_->setFence(ticket, 0);
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lock{ mutex_ };
+
+        for (uint32_t i = 0; i < count; ++i) {
+            auto& fp = footprints[i];
+            Copy copy;
+
+            copy.dst = dst;
+            copy.dstOffset = subresources[i];
+            copy.srcOffset = offset + fp.offset;
+            copy.size = GetFootprintSize(fp);
+            copy.footprint.Format = format;
+            copy.footprint.Width = fp.width;
+            copy.footprint.Height = fp.height;
+            copy.footprint.Depth = fp.depth;
+            copy.footprint.RowPitch = fp.rowPitch;
+
+            pending_.push_back(copy);
+        }
+
+        pendingTickets_.push_back(ticket);
+
+        if (onComplete)
+            pendingCallbacks_.push_back(std::move(onComplete));
+    }
+
+    void DX12UploadManager::waitFor(uint64_t value)
+    {
+        if (fence_->GetCompletedValue() < value) {
+            DXCheckThrow(fence_->SetEventOnCompletion(value, fenceEvent_));
+            WaitForSingleObjectEx(fenceEvent_, INFINITE, FALSE);
+        }
+    }
+} // namespace Takoyaki
@@ -0,0 +1,132 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "../utility/descriptor_ring.h"
+#include "../utility/texture_layout.h"
+#include "../public/definitions.h"
+
+namespace Takoyaki
+{
+    class DX12Buffer;
+    class DX12Device;
+
+    // Upload of static resource data on a dedicated copy queue
+    // Data is copied in a staging ring as soon as it is requested, the copies are then recorded in a single
+    // command list once per frame. The direct queue waits on the copy fence on the GPU so resources can be
+    // used in the same frame, completion callbacks are called on the render thread once the copy is done
+    // Destination resources must be created in the COMMON state, buffers decay back to it after the copy
+    class DX12UploadManager
+    {
+        DX12UploadManager(const DX12UploadManager&) = delete;
+        DX12UploadManager& operator=(const DX12UploadManager&) = delete;
+        DX12UploadManager(DX12UploadManager&&) = delete;
+        DX12UploadManager& operator=(DX12UploadManager&&) = delete;
+
+    public:
+        DX12UploadManager() noexcept;
+        ~DX12UploadManager();
+
+        void create(DX12Device*, uint_fast32_t);
+
+        // all thread-safe
+        // copy data in the staging memory, it can be released once this returns
+        void uploadBuffer(ID3D12Resource*, uint_fast64_t, const void*, uint_fast32_t, std::function<void()>);
+
+        // the writer fills the staging memory directly, it runs outside of the lock
+        void uploadBuffer(ID3D12Resource*, uint_fast64_t, uint_fast32_t, const UploadWriter&, std::function<void()>);
+
+        // keep the data and stream it in chunks when submitting, never wait for staging memory and
+        // can be larger than it, the destination must stay alive until the callback is called
+        void uploadBuffer(ID3D12Resource*, uint_fast64_t, std::vector<uint8_t>&&, std::function<void()>);
+
+        // subresources of a texture, the writer fills each one at the footprint it is given in one staging
+        // allocation so the whole set must fit in it, the texture decays back to COMMON after the copy too
+        using SubresourceWriter = std::function<void(uint_fast32_t subresource, uint8_t* dst, const SubresourceFootprint&)>;
+
+        void uploadTexture(ID3D12Resource*, DXGI_FORMAT, const TextureLayoutDesc&, const std::vector<uint_fast32_t>&, const SubresourceWriter&, std::function<void()>);
+
+        // record and execute what has been requested since the last call, return the fence value
+        // the direct queue must wait on or 0 if nothing was submitted
+        uint64_t submit();
+
+        // call the callbacks of completed copies and release their staging memory
+        void retire();
+
+        inline ID3D12Fence* getFence() const { return fence_.Get(); }
+
+    private:
+        struct Copy
+        {
+            ID3D12Resource* dst;
+            uint_fast64_t dstOffset;                // subresource index for textures
+            uint_fast64_t srcOffset;
+            uint_fast64_t size;
+            D3D12_SUBRESOURCE_FOOTPRINT footprint;  // DXGI_FORMAT_UNKNOWN for buffers
+        };
+
+        struct OwnedUpload
+        {
+            ID3D12Resource* dst;
+            uint_fast64_t dstOffset;
+            std::vector<uint8_t> data;
+            size_t copied;
+            std::function<void()> callback;
+        };
+
+        struct Batch
+        {
+            Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+            std::vector<std::function<void()>> callbacks;
+            uint64_t fence;
+        };
+
+        uint_fast64_t allocateStaging(uint_fast32_t, uint64_t&);
+        void streamOwned();
+        uint64_t submitPending();
+        void retireCompleted();
+        void waitFor(uint64_t);
+
+    private:
+        DX12Device* device_;
+        Microsoft::WRL::ComPtr<ID3D12CommandQueue> queue_;
+        Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_;
+        std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> freeAllocators_;
+
+        // staging memory, counted in blocks so any offset is aligned for texture copies too
+        std::unique_ptr<DX12Buffer> staging_;
+        std::unique_ptr<DescriptorRing> ring_;
+        uint8_t* stagingAddr_;
+
+        // requested since the last submit
+        std::vector<Copy> pending_;
+        std::vector<uint64_t> pendingTickets_;
+        std::vector<std::function<void()>> pendingCallbacks_;
+        std::deque<OwnedUpload> owned_;
+        std::deque<Batch> inFlight_;
+        std::vector<std::function<void()>> completed_;
+
+        std::mutex mutex_;
+        Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
+        uint64_t fenceValue_;
+        HANDLE fenceEvent_;
+    };
+} // namespace Takoyaki
@@ -0,0 +1,75 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dx12_upload_ring.h"
+
+#include "dx12_buffer.h"
+#include "dx12_device.h"
+#include "dxutility.h"
+
+namespace Takoyaki
+{
+    DX12UploadRing::~DX12UploadRing() = default;
+
+    void DX12UploadRing::create(DX12Device* device, uint_fast64_t pageSize, uint_fast32_t frameCount)
+    {
+        pages_.resize(frameCount);
+
+        for (uint_fast32_t i = 0; i < frameCount; ++i) {
+            auto& page = pages_[i];
+            auto fmt = boost::wformat{ L"Upload Ring %1%" } % i;
+
+            page.buffer = std::make_unique<DX12Buffer>(D3D12_HEAP_TYPE_UPLOAD, pageSize, D3D12_RESOURCE_STATE_GENERIC_READ);
+            page.buffer->create(device);
+            page.allocator = std::make_unique<LinearAllocator>(pageSize, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+            auto res = page.buffer->getResource();
+
+            res->SetName(boost::str(fmt).c_str());
+            page.gpu = res->GetGPUVirtualAddress();
+
+            // upload heaps can stay mapped for their whole lifetime, the CPU never reads from it
+            D3D12_RANGE readRange = { 0, 0 };
+
+            DXCheckThrow(res->Map(0, &readRange, reinterpret_cast<void**>(&page.cpu)));
+        }
+    }
+
+    UploadAllocation DX12UploadRing::allocate(uint_fast32_t frame, uint_fast32_t sizeByte)
+    {
+        auto& page = pages_[frame];
+        auto offset = page.allocator->allocate(sizeByte);
+
+        if (offset == LINEAR_INVALID) {
+            auto fmt = boost::format{ "DX12UploadRing::allocate, cannot allocate %1% bytes, the %2% bytes page of this frame is full, increase FrameworkDesc::uploadPageSize" } % sizeByte % page.allocator->getCapacity();
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        UploadAllocation res;
+
+        res.cpu = page.cpu + offset;
+        res.gpu = page.gpu + offset;
+        res.size = sizeByte;
+
+        return res;
+    }
+} // namespace Takoyaki
@@ -0,0 +1,62 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "../utility/linear_allocator.h"
+#include "../public/definitions.h"
+
+namespace Takoyaki
+{
+    class DX12Buffer;
+    class DX12Device;
+
+    // Transient upload memory for data that only lives for one frame, one persistently mapped page per frame
+    // allocations are lock-free and the page of a frame is reset once the fence of that frame completed
+    // 256 bytes aligned so any allocation can be bound as a root constant buffer view
+    class DX12UploadRing
+    {
+        DX12UploadRing(const DX12UploadRing&) = delete;
+        DX12UploadRing& operator=(const DX12UploadRing&) = delete;
+        DX12UploadRing(DX12UploadRing&&) = delete;
+        DX12UploadRing& operator=(DX12UploadRing&&) = delete;
+
+    public:
+        DX12UploadRing() = default;
+        ~DX12UploadRing();
+
+        void create(DX12Device*, uint_fast64_t, uint_fast32_t);
+
+        // throw when the page is full
+        UploadAllocation allocate(uint_fast32_t, uint_fast32_t);
+        inline void reset(uint_fast32_t frame) { pages_[frame].allocator->reset(); }
+
+    private:
+        struct Page
+        {
+            std::unique_ptr<DX12Buffer> buffer;
+            std::unique_ptr<LinearAllocator> allocator;
+            uint8_t* cpu;
+            D3D12_GPU_VIRTUAL_ADDRESS gpu;
+        };
+
+        std::vector<Page> pages_;
+    };
+} // namespace Takoyaki
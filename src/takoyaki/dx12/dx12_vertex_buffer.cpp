@@ -23,102 +23,107 @@
 
 #include "dx12_device.h"
 #include "dx12_buffer.h"
+#include "dx12_dynamic_buffer.h"
 #include "dx12_worker.h"
-#include "dxsystem.h"
 #include "dxutility.h"
-#include "../thread_pool.h"
 
 namespace Takoyaki
 {
-    DX12VertexBuffer::DX12VertexBuffer(uint8_t* vertices, uint_fast32_t stride, uint_fast32_t sizeByte, uint_fast32_t id) noexcept
-        : vertexBuffer_{ std::make_unique<DX12Buffer>(D3D12_HEAP_TYPE_DEFAULT, sizeByte, D3D12_RESOURCE_STATE_COPY_DEST) }
-        , uploadBuffer_{ std::make_unique<DX12Buffer>(D3D12_HEAP_TYPE_UPLOAD, sizeByte, D3D12_RESOURCE_STATE_GENERIC_READ) }
-        , intermediate_{ std::make_unique<Intermediate>() }
+    DX12VertexBuffer::DX12VertexBuffer(uint_fast32_t stride, uint_fast32_t sizeByte, uint_fast32_t id) noexcept
+        : vertexBuffer_{ std::make_unique<DX12Buffer>(D3D12_HEAP_TYPE_DEFAULT, sizeByte, D3D12_RESOURCE_STATE_COMMON) }
+        , id_{ id }
+        , ready_{ false }
     {
-        // we cannot guarantee that data will still be valid so make a copy of data
-        // TODO: UpdateSubresourcesHeapAlloc will also make a copy, so merge them
-        intermediate_->data.resize(sizeByte);
-
-        memcpy_s(&intermediate_->data.front(), intermediate_->data.size(), vertices, sizeByte);
-
-        intermediate_->dataDesc.pData = &intermediate_->data.front();
-        intermediate_->dataDesc.RowPitch = sizeByte;
-        intermediate_->dataDesc.SlicePitch = sizeByte;
-        intermediate_->id = id;
-
         view_.StrideInBytes = stride;
         view_.SizeInBytes = sizeByte;
     }
 
     DX12VertexBuffer::DX12VertexBuffer(DX12VertexBuffer&& other) noexcept
         : vertexBuffer_{ std::move(other.vertexBuffer_) }
-        , uploadBuffer_{ std::move(other.uploadBuffer_) }
-        , intermediate_{ std::move(other.intermediate_) }
+        , dynamic_{ std::move(other.dynamic_) }
         , view_{ std::move(other.view_) }
+        , id_{ other.id_ }
+        , ready_{ other.ready_.load() }
     {
     }
 
-    bool DX12VertexBuffer::create(void* command, void* dev)
-    {
-        auto device = static_cast<DX12Device*>(dev);
-        auto cmd = static_cast<TaskCommand*>(command);
+    DX12VertexBuffer::~DX12VertexBuffer() = default;
 
+    ID3D12Resource* DX12VertexBuffer::createResource(DX12Device* device)
+    {
         vertexBuffer_->create(device);
-        uploadBuffer_->create(device);
+
+        auto res = vertexBuffer_->getResource();
 
         // finish the view
-        view_.BufferLocation = vertexBuffer_->getResource()->GetGPUVirtualAddress();
+        view_.BufferLocation = res->GetGPUVirtualAddress();
 
         // set a name for debug purposes
-        auto fmt = boost::wformat{ L"Vertex Buffer %1%" } % intermediate_->id;
+        auto fmt = boost::wformat{ L"Vertex Buffer %1%" } % id_;
 
-        vertexBuffer_->getResource()->SetName(boost::str(fmt).c_str());
-        fmt = boost::wformat{ L"Vertex Buffer %1% Intermediate" } % intermediate_->id;
-        uploadBuffer_->getResource()->SetName(boost::str(fmt).c_str());
+        res->SetName(boost::str(fmt).c_str());
 
-        // upload data to the gpu
-        UpdateSubresourceDesc desc;
+        return res;
+    }
 
-        desc.device = device;
-        desc.cmdList = cmd->commands.Get();
-        desc.destinationResource = vertexBuffer_->getResource();
-        desc.intermediate = uploadBuffer_->getResource();
-        desc.intermediateOffset = 0;
-        desc.firstSubResource = 0;
-        desc.numSubResource = 1;
-        desc.srcData = &intermediate_->dataDesc;
+    // copied on the copy queue, buffers in the COMMON state are promoted to the state the direct queue need
+    void DX12VertexBuffer::create(DX12Device* device, const uint8_t* data)
+    {
+        auto res = createResource(device);
 
-        UpdateSubresourcesHeapAlloc(desc);
+        device->getUploadManager().uploadBuffer(res, 0, data, view_.SizeInBytes, [this]() { ready_ = true; });
+    }
 
-        // on the gpu, copy data from upload buffer to vertex buffer
-        D3D12_RESOURCE_BARRIER barrier = TransitionBarrier(vertexBuffer_->getResource(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    void DX12VertexBuffer::create(DX12Device* device, std::vector<uint8_t>&& data)
+    {
+        auto res = createResource(device);
 
-        cmd->commands->ResourceBarrier(1, &barrier);
-        DXCheckThrow(cmd->commands->Close());
+        device->getUploadManager().uploadBuffer(res, 0, std::move(data), [this]() { ready_ = true; });
+    }
 
-        return true;
+    void DX12VertexBuffer::create(DX12Device* device, const UploadWriter& writer)
+    {
+        auto res = createResource(device);
+
+        device->getUploadManager().uploadBuffer(res, 0, view_.SizeInBytes, writer, [this]() { ready_ = true; });
     }
 
-    bool DX12VertexBuffer::cleanupCreate(void* command, void*)
+    void DX12VertexBuffer::createDynamic(DX12Device* device)
     {
-        auto cmd = static_cast<TaskCommand*>(command);
+        auto fmt = boost::wformat{ L"Dynamic Vertex Buffer %1%" } % id_;
 
-        cmd->commands->DiscardResource(uploadBuffer_->getResource(), nullptr);
-        DXCheckThrow(cmd->commands->Close());
+        // the default heap buffer is never used
+        vertexBuffer_.reset();
+        dynamic_ = std::make_unique<DX12DynamicBuffer>(view_.SizeInBytes, device->getFrameCount());
+        dynamic_->create(device, boost::str(fmt));
+        ready_ = true;
+    }
 
-        return true;
+    D3D12_VERTEX_BUFFER_VIEW DX12VertexBuffer::getView() const
+    {
+        if (!dynamic_)
+            return view_;
+
+        auto view = view_;
+
+        view.BufferLocation = dynamic_->getAddress();
+
+        return view;
     }
 
-    void DX12VertexBuffer::cleanupIntermediate()
+    ID3D12Resource* DX12VertexBuffer::getResource() const
     {
-        intermediate_.reset();
+        return dynamic_ ? dynamic_->getResource() : vertexBuffer_->getResource();
     }
 
     bool DX12VertexBuffer::destroy(void* command, void*)
     {
         auto cmd = static_cast<TaskCommand*>(command);
 
-        cmd->commands->DiscardResource(vertexBuffer_->getResource(), nullptr);
+        // nothing to discard for upload heaps
+        if (!dynamic_)
+            cmd->commands->DiscardResource(vertexBuffer_->getResource(), nullptr);
+
         DXCheckThrow(cmd->commands->Close());
 
         return true;
@@ -44,6 +44,10 @@ namespace Takoyaki
 
     void DX12Worker::clear()
     {
+        // tables of discarded commands will never be submitted
+        for (auto& cmd : commandList_)
+            device_->getShaderVisibleHeap().setFence(cmd.descriptorTickets, 0);
+
         commandList_.clear();
 
         // also reset any memory that might have been used by the allocators
@@ -71,7 +75,7 @@ namespace Takoyaki
 
             if (threadPool_->tryPopGPUTask(gpuCmd)) {
                 TaskCommand cmd;
-                cmd.priority = 0;
+                cmd.sortKey = 0;
                 {
                     ID3D12PipelineState* ps = nullptr;
 
@@ -90,6 +94,7 @@ namespace Takoyaki
                 } else {
                     // something went wrong, cancel current command creation
                     cmd.commands->Close();
+                    device_->getShaderVisibleHeap().setFence(cmd.descriptorTickets, 0);
                 }
             } else if (threadPool_->tryPopGenericTask(genericCmd)) {
                 genericCmd();
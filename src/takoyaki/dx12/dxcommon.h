@@ -20,14 +20,18 @@
 
 #pragma once
 
+#include "../utility/resource_state_tracker.h"
+
 namespace Takoyaki
 {
     class DX12Device;
 
     struct TaskCommand
     {
-        uint_fast32_t priority;
+        uint64_t sortKey;
         Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commands;
+        ResourceStateTracker states;
+        std::vector<uint64_t> descriptorTickets;       // tables copied in the shader visible heap
     };
 
     class DX12Synchronisation
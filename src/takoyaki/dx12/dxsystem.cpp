@@ -25,17 +25,22 @@
 
 namespace Takoyaki
 {
-    void MemcpySubresource(D3D12_MEMCPY_DEST* dst, D3D12_SUBRESOURCE_DATA* src, uint_fast32_t numRows, uint_fast64_t rowSizeByte, uint_fast32_t numSlices)
+    void MemcpySubresource(CopyEngine& engine, D3D12_MEMCPY_DEST* dst, D3D12_SUBRESOURCE_DATA* src, uint_fast32_t numRows, uint_fast64_t rowSizeByte, uint_fast32_t numSlices)
     {
-        // Row-by-row copy
-        for (uint_fast32_t z = 0; z < numSlices; ++z) {
-            uint8_t* dstSlice = reinterpret_cast<uint8_t*>(dst->pData) + dst->SlicePitch * z;
-            const uint8_t* srcSlice = reinterpret_cast<const uint8_t*>(src->pData) + src->SlicePitch * z;
-
-            for (uint_fast32_t y = 0; y < numRows; ++y) {
-                memcpy(dstSlice + dst->RowPitch * y, srcSlice + src->RowPitch * y, rowSizeByte);
-            }
-        }
+        CopyRegion region;
+
+        region.dst = reinterpret_cast<uint8_t*>(dst->pData);
+        region.src = reinterpret_cast<const uint8_t*>(src->pData);
+        region.dstRowPitch = dst->RowPitch;
+        region.dstSlicePitch = dst->SlicePitch;
+        region.srcRowPitch = src->RowPitch;
+        region.srcSlicePitch = src->SlicePitch;
+        region.rowSizeByte = static_cast<size_t>(rowSizeByte);
+        region.numRows = numRows;
+        region.numSlices = numSlices;
+
+        // pitch conversion in the same pass, split across the workers when large
+        engine.copy(region);
     }
 
     uint_fast64_t UpdateSubresources(const UpdateSubresourceDesc& params, uint_fast64_t requiredSize, const D3D12_PLACED_SUBRESOURCE_FOOTPRINT* layouts, const uint_fast32_t* numRows, const uint_fast64_t* rowSizesInBytes)
@@ -63,7 +68,7 @@ namespace Takoyaki
             dstData.RowPitch = layouts[i].Footprint.RowPitch;
             dstData.SlicePitch = layouts[i].Footprint.RowPitch * numRows[i];
 
-            MemcpySubresource(&dstData, &params.srcData[i], numRows[i], rowSizesInBytes[i], layouts[i].Footprint.Depth);
+            MemcpySubresource(params.device->getCopyEngine(), &dstData, &params.srcData[i], numRows[i], rowSizesInBytes[i], layouts[i].Footprint.Depth);
         }
 
         params.intermediate->Unmap(0, nullptr);
@@ -22,29 +22,42 @@
 #include "command_impl.h"
 
 #include "renderer_impl.h"
+#include "../dx12/dx12_context.h"
+#include "../public/sort_key.h"
 
 namespace Takoyaki
 {
     CommandDesc::CommandDesc()
-        : priority{ 0 }
-        , renderTarget{ UINT_FAST32_MAX }
+        : sortKey{ 0 }
+        , renderTarget{ nullptr }
     {
         commands.reserve(16);
     }
 
-    CommandImpl::CommandImpl(const std::shared_ptr<RendererImpl>& renderer) noexcept
-        : CommandImpl{ renderer, std::string() }
+    CommandImpl::CommandImpl(const std::shared_ptr<RendererImpl>& renderer, const std::shared_ptr<DX12Context>& context) noexcept
+        : CommandImpl{ renderer, context, std::string() }
     {
     }
 
-    CommandImpl::CommandImpl(const std::shared_ptr<RendererImpl>& renderer, const std::string& pipelineState) noexcept
+    CommandImpl::CommandImpl(const std::shared_ptr<RendererImpl>& renderer, const std::shared_ptr<DX12Context>& context, const std::string& pipelineState) noexcept
+        : CommandImpl{ renderer, context, pipelineState, true }
+    {
+    }
+
+    CommandImpl::CommandImpl(const std::shared_ptr<RendererImpl>& renderer, const std::shared_ptr<DX12Context>& context, const std::string& pipelineState, bool submitOnDestruction) noexcept
         : renderer_{ renderer }
+        , context_{ context }
         , pipelineState_{ pipelineState }
+        , submitOnDestruction_{ submitOnDestruction }
     {
     }
 
     CommandImpl::~CommandImpl()
     {
+        // anything left in a command buffer that was never submitted is discarded
+        if (!submitOnDestruction_)
+            return;
+
         auto renderer = renderer_.lock();
 
         renderer->buildCommand(desc_, pipelineState_);
@@ -62,7 +75,26 @@ namespace Takoyaki
 
     void CommandImpl::copyTextureRegion(const CopyTexRegionParams& params)
     {
-        desc_.commands.push_back(std::make_pair(ECommandType::COPY_REGION_TEXTURE2D, params));
+        CommandDesc::CopyRegionParams copy;
+
+        copy.region = params;
+        copy.dst = &context_->getTexture(params.dstHandle);
+        copy.src = &context_->getTexture(params.srcHandle);
+
+        // states are tracked per resource, the builder cannot have one subresource in COPY_DEST and another in COPY_SOURCE
+        if (copy.dst == copy.src) {
+            auto fmt = boost::format{ "CommandImpl::copyTextureRegion, cannot copy between subresources of the same texture \"%1%\" (subresource %2% to %3%)" } % params.srcHandle % params.srcSubresource % params.dstSubresource;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+#ifdef _DEBUG
+        desc_.handles.textures.push_back(params.dstHandle);
+        desc_.handles.textures.push_back(params.srcHandle);
+        validateCopy(copy);
+#endif
+
+        desc_.commands.push_back(std::make_pair(ECommandType::COPY_REGION_TEXTURE2D, copy));
     }
 
     void CommandImpl::drawIndexed(uint_fast32_t indexCount, uint_fast32_t startIndex, int_fast32_t baseVertex)
@@ -70,24 +102,172 @@ namespace Takoyaki
         desc_.commands.push_back(std::make_pair(ECommandType::DRAW_INDEXED, std::make_tuple(indexCount, startIndex, baseVertex)));
     }
 
+    void CommandImpl::multiDraw(uint_fast32_t rootIndex, uint_fast32_t numConstants, const DrawIndexedRecord* records, uint_fast32_t count)
+    {
+        if (numConstants > MAX_DRAW_ROOT_CONSTANTS) {
+            auto fmt = boost::format{ "CommandImpl::multiDraw, cannot set more than %1% root constants per draw" } % MAX_DRAW_ROOT_CONSTANTS;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        if (count == 0)
+            return;
+
+        CommandDesc::MultiDrawParams params;
+
+        params.rootIndex = rootIndex;
+        params.numConstants = numConstants;
+        params.records.assign(records, records + count);
+
+        desc_.commands.push_back(std::make_pair(ECommandType::MULTI_DRAW_INDEXED, std::move(params)));
+    }
+
+    void CommandImpl::readTexture(uint_fast32_t handle, uint_fast32_t subresource, const ReadbackCallback& callback)
+    {
+        if (!callback)
+            throw std::runtime_error{ "CommandImpl::readTexture, callback is empty" };
+
+        CommandDesc::ReadbackParams params;
+
+        params.src = &context_->getTexture(handle);
+
+#ifdef _DEBUG
+        desc_.handles.textures.push_back(handle);
+#endif
+        params.subresource = subresource;
+        params.callback = callback;
+
+        desc_.commands.push_back(std::make_pair(ECommandType::READBACK_TEXTURE, std::move(params)));
+    }
+
+    std::future<std::vector<uint8_t>> CommandImpl::readTexture(uint_fast32_t handle, uint_fast32_t subresource)
+    {
+        // std::function has to be copyable so the promise is shared
+        auto promise = std::make_shared<std::promise<std::vector<uint8_t>>>();
+        auto future = promise->get_future();
+
+        readTexture(handle, subresource, [promise](const uint8_t* data, uint_fast32_t rowSizeByte, uint_fast32_t rowPitch, uint_fast32_t numRows)
+        {
+            std::vector<uint8_t> res(static_cast<size_t>(rowSizeByte) * numRows);
+
+            for (uint_fast32_t row = 0; row < numRows; ++row)
+                std::memcpy(&res[row * rowSizeByte], data + row * rowPitch, rowSizeByte);
+
+            promise->set_value(std::move(res));
+        });
+
+        return future;
+    }
+
+    CommandDesc CommandImpl::releaseDesc()
+    {
+        CommandDesc desc{ std::move(desc_) };
+
+        desc_ = CommandDesc{};
+
+        return desc;
+    }
+
+    void CommandImpl::setBindlessIndex(uint_fast32_t rootIndex, uint_fast32_t bindlessIndex, uint_fast32_t offset)
+    {
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_BINDLESS_INDEX, std::make_tuple(rootIndex, bindlessIndex, offset)));
+    }
+
+    void CommandImpl::setBindlessTable(uint_fast32_t rootIndex)
+    {
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_BINDLESS_TABLE, rootIndex));
+    }
+
     void CommandImpl::setIndexBuffer(uint_fast32_t handle)
     {
-        desc_.commands.push_back(std::make_pair(ECommandType::SET_INDEX_BUFFER, handle));
+        // dynamic buffers move every frame, keep the contents unmapped at record time
+        auto view = context_->getIndexBuffer(handle).getView();
+
+#ifdef _DEBUG
+        desc_.handles.indexBuffers.push_back(handle);
+#endif
+
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_INDEX_BUFFER, view));
+    }
+
+    void CommandImpl::setPriority(uint_fast32_t priority)
+    {
+        // encodeSortKey would silently truncate it
+        if (priority >= (1u << SORT_KEY_PASS_BITS)) {
+            auto fmt = boost::format{ "CommandImpl::setPriority, priority %1% does not fit the %2% bits of the pass field" } % priority % SORT_KEY_PASS_BITS;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        SortKeyDesc key;
+
+        key.pass = priority;
+        desc_.sortKey = encodeSortKey(key);
     }
 
     void CommandImpl::setRenderTarget(uint_fast32_t handle)
     {
-        desc_.renderTarget = handle;
+        desc_.renderTarget = &context_->getTexture(handle);
+
+#ifdef _DEBUG
+        desc_.handles.textures.push_back(handle);
+#endif
+    }
+
+    void CommandImpl::setRootConstantBufferView(uint_fast32_t rootIndex, const UploadAllocation& allocation)
+    {
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_ROOT_CONSTANT_BUFFER_VIEW, CommandDesc::RootCBVParams(rootIndex, allocation.gpu)));
+    }
+
+    void CommandImpl::setRootConstants(uint_fast32_t rootIndex, const uint32_t* values, uint_fast32_t count, uint_fast32_t offset)
+    {
+        if ((offset > MAX_ROOT_CONSTANTS) || (count > MAX_ROOT_CONSTANTS - offset)) {
+            auto fmt = boost::format{ "CommandImpl::setRootConstants, %1% constants at offset %2% exceed the %3% a root signature can hold" } % count % offset % MAX_ROOT_CONSTANTS;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        if (count == 0)
+            return;
+
+        CommandDesc::RootConstantsParams params;
+
+        params.rootIndex = rootIndex;
+        params.offset = offset;
+        params.values.assign(values, values + count);
+
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_ROOT_CONSTANTS, std::move(params)));
     }
 
     void CommandImpl::setRootSignature(const std::string& name)
     {
-        desc_.commands.push_back(std::make_pair(ECommandType::SET_ROOT_SIGNATURE, name));
+        // only the pointer is kept, the lock is released once we are done here
+        auto pair = context_->getRootSignature(name);
+        DX12RootSignature* rs = &pair.first;
+
+#ifdef _DEBUG
+        desc_.handles.rootSignatures.push_back(std::make_pair(name, rs));
+#endif
+
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_ROOT_SIGNATURE, rs));
     }
 
     void CommandImpl::setRootSignatureConstantBuffer(uint_fast32_t index, const std::string& name)
     {
-        desc_.commands.push_back(std::make_pair(ECommandType::SET_ROOT_SIGNATURE_CONSTANT_BUFFER, std::make_pair(index, name)));
+        auto pair = context_->getConstantBuffer(name);
+
+#ifdef _DEBUG
+        desc_.handles.constantBuffers.push_back(std::make_pair(name, &pair.first));
+#endif
+
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_ROOT_SIGNATURE_CONSTANT_BUFFER, CommandDesc::RSCBParams(index, &pair.first)));
+    }
+
+    void CommandImpl::setSamplerTable(uint_fast32_t rootIndex, uint_fast32_t sampler)
+    {
+        auto table = context_->getSamplerCache().getTable(sampler);
+
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_SAMPLER_TABLE, CommandDesc::SamplerTableParams(rootIndex, table)));
     }
 
     void CommandImpl::setScissor(const glm::uvec4& scissor)
@@ -102,12 +282,57 @@ namespace Takoyaki
 
     void CommandImpl::setVertexBuffer(uint_fast32_t handle)
     {
-        desc_.commands.push_back(std::make_pair(ECommandType::SET_VERTEX_BUFFER, handle));
+        // dynamic buffers move every frame, keep the contents unmapped at record time
+        auto view = context_->getVertexBuffer(handle).getView();
+
+#ifdef _DEBUG
+        desc_.handles.vertexBuffers.push_back(handle);
+#endif
+
+        desc_.commands.push_back(std::make_pair(ECommandType::SET_VERTEX_BUFFER, view));
     }
 
     void CommandImpl::setViewport(const glm::vec4& viewport)
     {
         desc_.commands.push_back(std::make_pair(ECommandType::SET_VIEWPORT, viewport));
     }
+
+    void CommandImpl::transition(uint_fast32_t handle, EResourceState state)
+    {
+        DX12Texture* tex = &context_->getTexture(handle);
+
+#ifdef _DEBUG
+        desc_.handles.textures.push_back(handle);
+#endif
+
+        desc_.commands.push_back(std::make_pair(ECommandType::TRANSITION, CommandDesc::TransitionParams(tex, state)));
+    }
+
+#ifdef _DEBUG
+    void CommandImpl::validateCopy(const CommandDesc::CopyRegionParams& params) const
+    {
+        auto& region = params.region;
+
+        auto checkSubresource = [](DX12Texture* tex, uint_fast32_t handle, uint_fast32_t subresource)
+        {
+            // textures still being created will be caught by the debug layer instead
+            if (!tex->isReady())
+                return;
+
+            auto desc = tex->getResource()->GetDesc();
+            uint_fast32_t arraySize = (desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D) ? 1 : desc.DepthOrArraySize;
+            uint_fast32_t count = desc.MipLevels * arraySize;
+
+            if (subresource >= count) {
+                auto fmt = boost::format{ "CommandImpl::copyTextureRegion, subresource %1% out of range for texture \"%2%\" (%3% subresources)" } % subresource % handle % count;
+
+                throw std::runtime_error{ boost::str(fmt) };
+            }
+        };
+
+        checkSubresource(params.dst, region.dstHandle, region.dstSubresource);
+        checkSubresource(params.src, region.srcHandle, region.srcSubresource);
+    }
+#endif
 }
 // namespace Takoyaki
\ No newline at end of file
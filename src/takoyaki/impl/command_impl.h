@@ -28,7 +28,11 @@
 
 namespace Takoyaki
 {
+    class DX12ConstantBuffer;
     class DX12Context;
+    class DX12IndexBuffer;
+    class DX12RootSignature;
+    class DX12Texture;
     class DX12VertexBuffer;
     class RendererImpl;
 
@@ -38,27 +42,95 @@ namespace Takoyaki
         //COPY_RENDERTARGET,
         COPY_REGION_TEXTURE2D,
         DRAW_INDEXED,
+        MULTI_DRAW_INDEXED,
+        READBACK_TEXTURE,
+        SET_BINDLESS_INDEX,
+        SET_BINDLESS_TABLE,
         SET_INDEX_BUFFER,
         SET_ROOT_SIGNATURE,
+        SET_ROOT_CONSTANT_BUFFER_VIEW,
+        SET_ROOT_CONSTANTS,
         SET_ROOT_SIGNATURE_CONSTANT_BUFFER,
+        SET_SAMPLER_TABLE,
         SET_PRIMITIVE_TOPOLOGY,
         SET_SCISSOR,
         SET_VERTEX_BUFFER,
-        SET_VIEWPORT
+        SET_VIEWPORT,
+        TRANSITION
     };
 
+    // Resources are resolved when the command is recorded, the pointers are stable until the resource
+    // is destroyed so resources have to outlive the commands recording them until they are submitted
     struct CommandDesc
     {
-        // index, name
-        using RSCBParams = std::pair<uint_fast32_t, std::string>;
+        // root index, constant buffer
+        using RSCBParams = std::pair<uint_fast32_t, DX12ConstantBuffer*>;
+
+        // root index, GPU address of the constant data
+        using RootCBVParams = std::pair<uint_fast32_t, D3D12_GPU_VIRTUAL_ADDRESS>;
+
+        struct RootConstantsParams
+        {
+            uint_fast32_t rootIndex;
+            uint_fast32_t offset;
+            std::vector<uint32_t> values;
+        };
+
+        // root index, sampler table
+        using SamplerTableParams = std::pair<uint_fast32_t, D3D12_GPU_DESCRIPTOR_HANDLE>;
+
+        // texture, state required by the following commands
+        using TransitionParams = std::pair<DX12Texture*, EResourceState>;
+
+        struct CopyRegionParams
+        {
+            CopyTexRegionParams region;
+            DX12Texture* dst;
+            DX12Texture* src;
+        };
+
+        struct ReadbackParams
+        {
+            DX12Texture* src;
+            uint_fast32_t subresource;
+            ReadbackCallback callback;
+        };
+
+        // root index, bindless index, offset in the root constants
+        using BindlessIndexParams = std::tuple<uint_fast32_t, uint_fast32_t, uint_fast32_t>;
 
         // indexCount, startIndex, baseVertex
         using DrawIndexedParams = std::tuple<uint_fast32_t, uint_fast32_t, int_fast32_t>;
 
+        struct MultiDrawParams
+        {
+            uint_fast32_t rootIndex;
+            uint_fast32_t numConstants;
+            std::vector<DrawIndexedRecord> records;
+        };
+
         CommandDesc();
-        uint_fast32_t priority;
-        uint_fast32_t renderTarget;
+        uint64_t sortKey;
+
+        // nullptr use the current swap chain buffer
+        DX12Texture* renderTarget;
         std::vector<std::pair<ECommandType, boost::any>> commands;
+
+#ifdef _DEBUG
+        // handles resolved while recording, checked again when the command is built
+        struct ResolvedHandles
+        {
+            std::vector<uint_fast32_t> indexBuffers;
+            std::vector<uint_fast32_t> textures;
+            std::vector<uint_fast32_t> vertexBuffers;
+
+            // by name, with the object the name resolved to
+            std::vector<std::pair<std::string, const DX12ConstantBuffer*>> constantBuffers;
+            std::vector<std::pair<std::string, const DX12RootSignature*>> rootSignatures;
+        };
+
+        ResolvedHandles handles;
+#endif
     };
 
     class CommandImpl
@@ -69,28 +141,62 @@ namespace Takoyaki
         CommandImpl& operator=(CommandImpl&&) = delete;
 
     public:
-        CommandImpl(const std::shared_ptr<RendererImpl>&) noexcept;
-        CommandImpl(const std::shared_ptr<RendererImpl>&, const std::string&) noexcept;
+        CommandImpl(const std::shared_ptr<RendererImpl>&, const std::shared_ptr<DX12Context>&) noexcept;
+        CommandImpl(const std::shared_ptr<RendererImpl>&, const std::shared_ptr<DX12Context>&, const std::string&) noexcept;
+        CommandImpl(const std::shared_ptr<RendererImpl>&, const std::shared_ptr<DX12Context>&, const std::string&, bool) noexcept;
         ~CommandImpl();
 
+        //////////////////////////////////////////////////////////////////////////
+        // Internal usage:
+
+        // command buffers are submitted explicitly, this hand over what was recorded
+        // and reset the command so it can be recorded again
+        CommandDesc releaseDesc();
+        inline const std::string& getPipelineState() const { return pipelineState_; }
+
+        // used by the render graph, barriers are still merged by the builder
+        void transition(uint_fast32_t, EResourceState);
+
+        //////////////////////////////////////////////////////////////////////////
+        // External usage:
+
         void clearRenderTarget(const glm::vec4&);
         //void copyRenderTargetToTexture(uint_fast32_t);
         void copyTextureRegion(const CopyTexRegionParams&);
         void drawIndexed(uint_fast32_t, uint_fast32_t, int_fast32_t);
+        void multiDraw(uint_fast32_t, uint_fast32_t, const DrawIndexedRecord*, uint_fast32_t);
+        void readTexture(uint_fast32_t, uint_fast32_t, const ReadbackCallback&);
+        std::future<std::vector<uint8_t>> readTexture(uint_fast32_t, uint_fast32_t);
+        void setBindlessIndex(uint_fast32_t, uint_fast32_t, uint_fast32_t);
+        void setBindlessTable(uint_fast32_t);
         void setIndexBuffer(uint_fast32_t);
-        inline void setPriority(uint_fast32_t priority) { desc_.priority = priority; }
+        void setPriority(uint_fast32_t);
         void setRenderTarget(uint_fast32_t);
+        void setRootConstantBufferView(uint_fast32_t, const UploadAllocation&);
+        void setRootConstants(uint_fast32_t, const uint32_t*, uint_fast32_t, uint_fast32_t);
         void setRootSignature(const std::string&);
         void setRootSignatureConstantBuffer(uint_fast32_t, const std::string&);
+        void setSamplerTable(uint_fast32_t, uint_fast32_t);
         void setScissor(const glm::uvec4&);
+        inline void setSortKey(uint64_t key) { desc_.sortKey = key; }
         void setTopology(ETopology);
         void setVertexBuffer(uint_fast32_t);
         void setViewport(const glm::vec4&);
 
+    private:
+#ifdef _DEBUG
+        // too costly to keep for release builds, handles are still checked when resolved
+        void validateCopy(const CommandDesc::CopyRegionParams&) const;
+#endif
+
     private:
         std::weak_ptr<RendererImpl> renderer_;
+        std::shared_ptr<DX12Context> context_;
         std::string pipelineState_;
         CommandDesc desc_;
+
+        // false for command buffers
+        bool submitOnDestruction_;
     };
 }
 // namespace Takoyaki
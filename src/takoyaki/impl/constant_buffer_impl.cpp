@@ -34,12 +34,29 @@ namespace Takoyaki
     {
     }
 
+    FieldHandle ConstantBufferImpl::addVariable(const std::string& name, uint_fast32_t offset, uint_fast32_t sizeByte)
+    {
+        return cbuffer_.addVariable(name, offset, sizeByte);
+    }
+
+    FieldHandle ConstantBufferImpl::getField(const std::string& name) const
+    {
+        return cbuffer_.getField(name);
+    }
+
+    void ConstantBufferImpl::setField(FieldHandle handle, const void* data, uint_fast32_t sizeByte)
+    {
+        cbuffer_.setField(handle, data, sizeByte);
+    }
+
     void ConstantBufferImpl::setMatrix4x4(const std::string& name, const glm::mat4x4& value)
     {
-        auto context = context_.lock();
-        auto device = device_.lock();
+        cbuffer_.setMatrix4x4(name, value);
+    }
 
-        cbuffer_.setMatrix4x4(name, value, device->getCurrentFrame());
+    void ConstantBufferImpl::setRange(uint_fast32_t offset, const void* data, uint_fast32_t sizeByte)
+    {
+        cbuffer_.setRange(offset, data, sizeByte);
     }
 }
 // namespace Takoyaki
\ No newline at end of file
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "../public/definitions.h"
+
 namespace Takoyaki
 {
     class DX12Context;
@@ -37,7 +39,11 @@ namespace Takoyaki
         ConstantBufferImpl(const std::shared_ptr<DX12Context>&, const std::shared_ptr<DX12Device>&, DX12ConstantBuffer&, std::shared_lock<std::shared_timed_mutex>) noexcept;
         ~ConstantBufferImpl() = default;
 
+        FieldHandle addVariable(const std::string&, uint_fast32_t, uint_fast32_t);
+        FieldHandle getField(const std::string&) const;
+        void setField(FieldHandle, const void*, uint_fast32_t);
         void setMatrix4x4(const std::string&, const glm::mat4x4&);
+        void setRange(uint_fast32_t, const void*, uint_fast32_t);
 
     private:
         std::weak_ptr<DX12Context> context_;    // must own pointer to context for destruction
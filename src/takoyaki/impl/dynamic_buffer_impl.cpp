@@ -0,0 +1,58 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dynamic_buffer_impl.h"
+
+#include "../dx12/dx12_device.h"
+#include "../dx12/dx12_dynamic_buffer.h"
+
+namespace Takoyaki
+{
+    DynamicBufferImpl::DynamicBufferImpl(const std::shared_ptr<DX12Context>& context, const std::shared_ptr<DX12Device>& device, DX12DynamicBuffer& buffer, DX12Context::EResourceType type, uint_fast32_t handle, uint_fast32_t sizeByte) noexcept
+        : context_{ context }
+        , device_{ device }
+        , buffer_{ buffer }
+        , type_{ type }
+        , handle_{ handle }
+        , size_{ sizeByte }
+    {
+    }
+
+    DynamicBufferImpl::~DynamicBufferImpl()
+    {
+        auto context = context_.lock();
+
+        context->destroyResource(type_, handle_);
+    }
+
+    uint8_t* DynamicBufferImpl::map(bool discard)
+    {
+        auto device = device_.lock();
+
+        return buffer_.map(device.get(), discard);
+    }
+
+    void DynamicBufferImpl::unmap()
+    {
+        buffer_.unmap();
+    }
+}
+// namespace Takoyaki
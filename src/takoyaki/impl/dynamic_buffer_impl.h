@@ -0,0 +1,57 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "../dx12/dx12_context.h"
+
+namespace Takoyaki
+{
+    class DX12Device;
+    class DX12DynamicBuffer;
+
+    class DynamicBufferImpl
+    {
+        DynamicBufferImpl(const DynamicBufferImpl&) = delete;
+        DynamicBufferImpl& operator=(const DynamicBufferImpl&) = delete;
+        DynamicBufferImpl(DynamicBufferImpl&&) = delete;
+        DynamicBufferImpl& operator=(DynamicBufferImpl&&) = delete;
+
+    public:
+        explicit DynamicBufferImpl(const std::shared_ptr<DX12Context>&, const std::shared_ptr<DX12Device>&, DX12DynamicBuffer&, DX12Context::EResourceType, uint_fast32_t, uint_fast32_t) noexcept;
+        ~DynamicBufferImpl();
+
+        inline uint_fast32_t getHandle() const { return handle_; }
+        inline uint_fast32_t getSize() const { return size_; }
+
+        uint8_t* map(bool);
+        void unmap();
+
+    private:
+        // must own pointer to context for destruction
+        std::weak_ptr<DX12Context> context_;
+        std::weak_ptr<DX12Device> device_;
+        DX12DynamicBuffer& buffer_;
+        DX12Context::EResourceType type_;
+        uint_fast32_t handle_;
+        uint_fast32_t size_;
+    };
+}
+// namespace Takoyaki
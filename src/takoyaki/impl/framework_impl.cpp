@@ -50,7 +50,7 @@ namespace Takoyaki
 
         if ((desc.type == EDeviceType::DX12_WIN_32) || (desc.type == EDeviceType::DX12_WIN_RT) || (desc.type == EDeviceType::WARP_WIN_32)) {
             device_.reset(new DX12Device());
-            context_ = std::make_shared<DX12Context>(device_, threadPool_);
+            context_ = std::make_shared<DX12Context>(device_, threadPool_, desc);
 
             device_->create(desc, context_);
             device_->createSwapChain();
@@ -63,6 +63,19 @@ namespace Takoyaki
             workerDesc.numFrames = desc.bufferCount;
 
             threadPool_->initialize<DX12Worker, DX12WorkerDesc>(workerDesc);
+
+            // large upload copies and sorts are shared with the workers, the caller takes part so it cannot stall on them
+            std::weak_ptr<ThreadPool> pool = threadPool_;
+            auto dispatch = [pool](std::function<void()> task)
+            {
+                auto threadPool = pool.lock();
+
+                if (threadPool)
+                    threadPool->submitGeneric(std::move(task), 0);
+            };
+
+            device_->getCopyEngine().initialize(dispatch, static_cast<uint32_t>(desc.numWorkerThreads));
+            device_->getSorter().initialize(dispatch, static_cast<uint32_t>(desc.numWorkerThreads));
         }
 
         renderer_.reset(new RendererImpl{ device_, context_, threadPool_ });
@@ -70,6 +83,11 @@ namespace Takoyaki
         LOGC_INDENT_END << "Initialization complete.";
     }
 
+    DescriptorHeapStats FrameworkImpl::getDescriptorHeapStats(EDescriptorHeapType type) const
+    {
+        return context_->getDescriptorHeapStats(type);
+    }
+
     void FrameworkImpl::present()
     {
         // TODO: this design is preventing the creation of multiples frame before they can me rendered
@@ -83,8 +101,18 @@ namespace Takoyaki
         }
 
         threadPool_->submitGPUCommandLists();
+        context_->streamTextures();
         device_->executeCommandList();
         device_->present();
+
+        // commands being recorded allocate from the current frame's upload page, which is reset here
+        {
+            auto rendererLock = renderer_->getLock();
+
+            device_->nextFrame();
+        }
+
+        context_->flushDescriptorCaches();
     }
 
     void FrameworkImpl::setWindowSize(const glm::vec2& size)
@@ -48,6 +48,7 @@ namespace Takoyaki
         void terminate();
         void validateDevice() const;
 
+        DescriptorHeapStats getDescriptorHeapStats(EDescriptorHeapType) const;
         inline std::shared_ptr<RendererImpl>& getRenderer() { return renderer_; }
 
         inline const glm::vec2& getWindowSize() const { return device_->getWindowSize(); }
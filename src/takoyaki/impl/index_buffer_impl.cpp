@@ -33,6 +33,11 @@ namespace Takoyaki
     {
     }
 
+    bool IndexBufferImpl::isReady() const
+    {
+        return buffer_.isReady();
+    }
+
     IndexBufferImpl::~IndexBufferImpl()
     {
         auto context = context_.lock();
@@ -39,6 +39,7 @@ namespace Takoyaki
         ~IndexBufferImpl();
 
         inline uint_fast32_t getHandle() const { return handle_; }
+        bool isReady() const;
 
     private:
         // must own pointer to context for destruction
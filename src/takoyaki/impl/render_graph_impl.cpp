@@ -0,0 +1,231 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "render_graph_impl.h"
+
+#include "command_impl.h"
+#include "renderer_impl.h"
+#include "texture_impl.h"
+#include "../public/command_buffer.h"
+#include "../public/sort_key.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        bool SameTextureDesc(const TextureDesc& lhs, const TextureDesc& rhs)
+        {
+            return (lhs.format == rhs.format) && (lhs.flags == rhs.flags) && (lhs.usage == rhs.usage) &&
+                (lhs.arraySize == rhs.arraySize) && (lhs.depth == rhs.depth) && (lhs.height == rhs.height) &&
+                (lhs.mipmaps == rhs.mipmaps) && (lhs.width == rhs.width);
+        }
+    }
+
+    RenderGraphImpl::RenderGraphImpl(const std::shared_ptr<RendererImpl>& renderer) noexcept
+        : renderer_{ renderer }
+        , compiled_{ false }
+    {
+    }
+
+    RenderGraphImpl::~RenderGraphImpl() = default;
+
+    uint_fast32_t RenderGraphImpl::addPass(const std::string& pipelineState, const PassFunc& func)
+    {
+        PassInfo pass;
+
+        pass.pipelineState = pipelineState;
+        pass.func = func;
+        pass.renderTarget = UINT_FAST32_MAX;
+        passes_.push_back(std::move(pass));
+        compiled_ = false;
+
+        return graph_.addPass();
+    }
+
+    void RenderGraphImpl::checkAccess(uint_fast32_t pass, uint_fast32_t resource) const
+    {
+        if ((pass >= passes_.size()) || (resource >= resources_.size())) {
+            auto fmt = boost::format{ "RenderGraphImpl, invalid pass %1% or resource %2%" } % pass % resource;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+    }
+
+    void RenderGraphImpl::clear()
+    {
+        graph_.clear();
+        passes_.clear();
+        resources_.clear();
+        physical_.clear();
+        compiled_ = false;
+    }
+
+    void RenderGraphImpl::compile()
+    {
+        graph_.compile();
+
+        auto& order = graph_.getOrder();
+
+        // execution order is enforced with the pass field of the sort key
+        if (order.size() > (1 << SORT_KEY_PASS_BITS)) {
+            auto fmt = boost::format{ "RenderGraphImpl::compile, cannot execute more than %1% passes" } % (1 << SORT_KEY_PASS_BITS);
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        // one texture for each physical slot, resources with disjoint lifetimes share it
+        physical_.clear();
+        physical_.resize(graph_.getNumPhysical());
+
+        for (uint_fast32_t i = 0; i < resources_.size(); ++i) {
+            auto slot = graph_.getPhysical(static_cast<uint32_t>(i));
+
+            if ((slot != FRAME_GRAPH_INVALID) && !physical_[slot])
+                physical_[slot] = renderer_->createTexture(resources_[i].desc);
+        }
+
+        // command buffers are kept from one frame to the other
+        for (auto index : order) {
+            auto& pass = passes_[index];
+
+            if (!pass.buffer)
+                pass.buffer = std::make_unique<CommandBuffer>(renderer_->createCommandBuffer(pass.pipelineState));
+        }
+
+        compiled_ = true;
+    }
+
+    uint_fast32_t RenderGraphImpl::createTexture(const TextureDesc& desc)
+    {
+        // transient textures are pooled by description, only identical ones can share a texture
+        uint64_t poolKey = resources_.size();
+
+        for (uint_fast32_t i = 0; i < resources_.size(); ++i) {
+            if (resources_[i].transient && SameTextureDesc(resources_[i].desc, desc)) {
+                poolKey = i;
+                break;
+            }
+        }
+
+        resources_.push_back(ResourceInfo{ desc, UINT_FAST32_MAX, true });
+        compiled_ = false;
+
+        return graph_.addResource(static_cast<uint32_t>(EResourceState::COMMON), poolKey, true);
+    }
+
+    void RenderGraphImpl::execute()
+    {
+        if (!compiled_)
+            throw std::runtime_error{ "RenderGraphImpl::execute, graph must be compiled first" };
+
+        auto& order = graph_.getOrder();
+
+        submitted_.clear();
+
+        for (uint_fast32_t position = 0; position < order.size(); ++position) {
+            auto index = order[position];
+            auto& pass = passes_[index];
+            auto impl = pass.buffer->impl_.get();
+            SortKeyDesc key;
+
+            key.pass = position;
+            impl->setSortKey(encodeSortKey(key));
+
+            for (auto& transition : graph_.getTransitions(index))
+                impl->transition(getTextureHandle(transition.resource), static_cast<EResourceState>(transition.after));
+
+            if (pass.renderTarget != UINT_FAST32_MAX)
+                impl->setRenderTarget(getTextureHandle(pass.renderTarget));
+
+            if (pass.func)
+                pass.func(*pass.buffer);
+
+            submitted_.push_back(impl);
+        }
+
+        renderer_->submit(submitted_.data(), static_cast<uint_fast32_t>(submitted_.size()));
+    }
+
+    uint_fast32_t RenderGraphImpl::getNumCulledPasses() const
+    {
+        if (!compiled_)
+            return 0;
+
+        return static_cast<uint_fast32_t>(passes_.size() - graph_.getOrder().size());
+    }
+
+    uint_fast32_t RenderGraphImpl::getTextureHandle(uint_fast32_t resource) const
+    {
+        auto& res = resources_[resource];
+
+        if (!res.transient)
+            return (res.handle == UINT_FAST32_MAX) ? renderer_->getDefaultRenderTargetHandle() : res.handle;
+
+        auto slot = graph_.getPhysical(static_cast<uint32_t>(resource));
+
+        if ((slot == FRAME_GRAPH_INVALID) || !physical_[slot]) {
+            auto fmt = boost::format{ "RenderGraphImpl::getTextureHandle, resource %1% is not used by any executed pass" } % resource;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        return physical_[slot]->getHandle();
+    }
+
+    uint_fast32_t RenderGraphImpl::importTexture(uint_fast32_t handle)
+    {
+        resources_.push_back(ResourceInfo{ TextureDesc{}, handle, false });
+        compiled_ = false;
+
+        return graph_.addResource(static_cast<uint32_t>(EResourceState::COMMON), 0, false);
+    }
+
+    void RenderGraphImpl::markOutput(uint_fast32_t resource)
+    {
+        if (resource >= resources_.size()) {
+            auto fmt = boost::format{ "RenderGraphImpl::markOutput, invalid resource %1%" } % resource;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        graph_.markOutput(static_cast<uint32_t>(resource));
+        compiled_ = false;
+    }
+
+    void RenderGraphImpl::read(uint_fast32_t pass, uint_fast32_t resource, EResourceState state)
+    {
+        checkAccess(pass, resource);
+        graph_.read(static_cast<uint32_t>(pass), static_cast<uint32_t>(resource), static_cast<uint32_t>(state));
+        compiled_ = false;
+    }
+
+    void RenderGraphImpl::write(uint_fast32_t pass, uint_fast32_t resource, EResourceState state)
+    {
+        checkAccess(pass, resource);
+
+        if ((state == EResourceState::RENDER_TARGET) && (passes_[pass].renderTarget == UINT_FAST32_MAX))
+            passes_[pass].renderTarget = resource;
+
+        graph_.write(static_cast<uint32_t>(pass), static_cast<uint32_t>(resource), static_cast<uint32_t>(state));
+        compiled_ = false;
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,96 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <functional>
+
+#include "../public/definitions.h"
+#include "../utility/frame_graph.h"
+
+namespace Takoyaki
+{
+    class Command;
+    class CommandBuffer;
+    class CommandImpl;
+    class RendererImpl;
+    class TextureImpl;
+
+    class RenderGraphImpl
+    {
+        RenderGraphImpl(const RenderGraphImpl&) = delete;
+        RenderGraphImpl& operator=(const RenderGraphImpl&) = delete;
+        RenderGraphImpl(RenderGraphImpl&&) = delete;
+        RenderGraphImpl& operator=(RenderGraphImpl&&) = delete;
+
+    public:
+        using PassFunc = std::function<void(Command&)>;
+
+        explicit RenderGraphImpl(const std::shared_ptr<RendererImpl>&) noexcept;
+        ~RenderGraphImpl();
+
+        uint_fast32_t addPass(const std::string&, const PassFunc&);
+        void clear();
+        void compile();
+        uint_fast32_t createTexture(const TextureDesc&);
+        void execute();
+        uint_fast32_t getNumCulledPasses() const;
+        inline uint_fast32_t getNumTransientTextures() const { return static_cast<uint_fast32_t>(physical_.size()); }
+        uint_fast32_t getTextureHandle(uint_fast32_t) const;
+        uint_fast32_t importTexture(uint_fast32_t);
+        void markOutput(uint_fast32_t);
+        void read(uint_fast32_t, uint_fast32_t, EResourceState);
+        void write(uint_fast32_t, uint_fast32_t, EResourceState);
+
+    private:
+        void checkAccess(uint_fast32_t, uint_fast32_t) const;
+
+    private:
+        struct PassInfo
+        {
+            std::string pipelineState;
+            PassFunc func;
+            uint_fast32_t renderTarget;
+            std::unique_ptr<CommandBuffer> buffer;
+        };
+
+        struct ResourceInfo
+        {
+            TextureDesc desc;
+            uint_fast32_t handle;  // imported only, UINT_FAST32_MAX for the back buffer
+            bool transient;
+        };
+
+    private:
+        std::shared_ptr<RendererImpl> renderer_;
+        FrameGraph graph_;
+        std::vector<PassInfo> passes_;
+        std::vector<ResourceInfo> resources_;
+
+        // one texture per physical slot, indexed by FrameGraph::getPhysical
+        // this is pooling by description, not memory aliasing: slots are committed textures reused by
+        // transients with the same description. Placing different descriptions in one heap would need
+        // render target heaps (separate on tier 1), aliasing barriers and a discard on first use
+        std::vector<std::unique_ptr<TextureImpl>> physical_;
+        std::vector<CommandImpl*> submitted_;
+        bool compiled_;
+    };
+}
+// namespace Takoyaki
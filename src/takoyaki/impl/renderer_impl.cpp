@@ -22,8 +22,10 @@
 #include "renderer_impl.h"
 
 #include "constant_buffer_impl.h"
+#include "dynamic_buffer_impl.h"
 #include "index_buffer_impl.h"
 #include "input_layout_impl.h"
+#include "render_graph_impl.h"
 #include "root_signature_impl.h"
 #include "texture_impl.h"
 #include "vertex_buffer_impl.h"
@@ -63,12 +65,17 @@ namespace Takoyaki
 
     std::unique_ptr<CommandImpl>  RendererImpl::createCommand()
     {
-        return std::make_unique<CommandImpl>(shared_from_this());
+        return std::make_unique<CommandImpl>(shared_from_this(), context_);
     }
 
     std::unique_ptr<CommandImpl> RendererImpl::createCommand(const std::string& pipelineState)
     {
-        return std::make_unique<CommandImpl>(shared_from_this(), pipelineState);
+        return std::make_unique<CommandImpl>(shared_from_this(), context_, pipelineState);
+    }
+
+    std::unique_ptr<CommandImpl> RendererImpl::createCommandBuffer(const std::string& pipelineState)
+    {
+        return std::make_unique<CommandImpl>(shared_from_this(), context_, pipelineState, false);
     }
 
     std::unique_ptr<ConstantBufferImpl> RendererImpl::createConstantBuffer(const std::string& name, uint_fast32_t size)
@@ -80,6 +87,24 @@ namespace Takoyaki
         return std::make_unique<ConstantBufferImpl>(context_, device_, pair.first, std::move(pair.second));
     }
 
+    std::unique_ptr<DynamicBufferImpl> RendererImpl::createDynamicIndexBuffer(EFormat format, uint_fast32_t sizeByte)
+    {
+        auto id = uidGenerator_.fetch_add(1);
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+        auto& buffer = context_->createDynamicBuffer(DX12Context::EResourceType::INDEX_BUFFER, id, format, 0, sizeByte);
+
+        return std::make_unique<DynamicBufferImpl>(context_, device_, buffer, DX12Context::EResourceType::INDEX_BUFFER, id, sizeByte);
+    }
+
+    std::unique_ptr<DynamicBufferImpl> RendererImpl::createDynamicVertexBuffer(uint_fast32_t stride, uint_fast32_t sizeByte)
+    {
+        auto id = uidGenerator_.fetch_add(1);
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+        auto& buffer = context_->createDynamicBuffer(DX12Context::EResourceType::VERTEX_BUFFER, id, EFormat::UNKNOWN, stride, sizeByte);
+
+        return std::make_unique<DynamicBufferImpl>(context_, device_, buffer, DX12Context::EResourceType::VERTEX_BUFFER, id, sizeByte);
+    }
+
     std::unique_ptr<IndexBufferImpl> RendererImpl::createIndexBuffer(uint8_t* data, EFormat format, uint_fast32_t sizeByte)
     {
         auto id = uidGenerator_.fetch_add(1);
@@ -90,6 +115,27 @@ namespace Takoyaki
         return std::make_unique<IndexBufferImpl>(context_, context_->getIndexBuffer(id), id);
     }
 
+    std::unique_ptr<IndexBufferImpl> RendererImpl::createIndexBuffer(std::vector<uint8_t>&& data, EFormat format)
+    {
+        auto id = uidGenerator_.fetch_add(1);
+        auto sizeByte = static_cast<uint_fast32_t>(data.size());
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        context_->createBuffer(DX12Context::EResourceType::INDEX_BUFFER, id, std::move(data), format, 0, sizeByte);
+
+        return std::make_unique<IndexBufferImpl>(context_, context_->getIndexBuffer(id), id);
+    }
+
+    std::unique_ptr<IndexBufferImpl> RendererImpl::createIndexBuffer(const UploadWriter& writer, EFormat format, uint_fast32_t sizeByte)
+    {
+        auto id = uidGenerator_.fetch_add(1);
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        context_->createBuffer(DX12Context::EResourceType::INDEX_BUFFER, id, writer, format, 0, sizeByte);
+
+        return std::make_unique<IndexBufferImpl>(context_, context_->getIndexBuffer(id), id);
+    }
+
     std::unique_ptr<InputLayoutImpl> RendererImpl::createInputLayout(const std::string& name)
     {
         context_->createInputLayout(name);
@@ -104,6 +150,16 @@ namespace Takoyaki
         context_->createPipelineState(name, desc);
     }
 
+    uint_fast32_t RendererImpl::createSampler(const SamplerDesc& desc)
+    {
+        return context_->getSamplerCache().getSampler(desc);
+    }
+
+    std::unique_ptr<RenderGraphImpl> RendererImpl::createRenderGraph()
+    {
+        return std::make_unique<RenderGraphImpl>(shared_from_this());
+    }
+
     std::unique_ptr<RootSignatureImpl> RendererImpl::createRootSignature(const std::string& name)
     {
         context_->createRootSignature(name);
@@ -123,6 +179,26 @@ namespace Takoyaki
         return std::make_unique<TextureImpl>(context_, context_->getTexture(id), id);
     }
 
+    std::unique_ptr<TextureImpl> RendererImpl::createTexture(const TextureDesc& desc, const SubresourceData* data)
+    {
+        auto id = uidGenerator_.fetch_add(1);
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        context_->createTexture(id, desc, data);
+
+        return std::make_unique<TextureImpl>(context_, context_->getTexture(id), id);
+    }
+
+    std::unique_ptr<TextureImpl> RendererImpl::createStreamingTexture(const TextureDesc& desc, const TextureWriter& writer)
+    {
+        auto id = uidGenerator_.fetch_add(1);
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        context_->createStreamingTexture(id, desc, writer);
+
+        return std::make_unique<TextureImpl>(context_, context_->getTexture(id), id);
+    }
+
     std::unique_ptr<VertexBufferImpl> RendererImpl::createVertexBuffer(uint8_t* data, uint_fast32_t stride, uint_fast32_t sizeByte)
     {
         auto id = uidGenerator_.fetch_add(1);
@@ -133,6 +209,53 @@ namespace Takoyaki
         return std::make_unique<VertexBufferImpl>(context_, context_->getVertexBuffer(id), id);
     }
 
+    std::unique_ptr<VertexBufferImpl> RendererImpl::createVertexBuffer(std::vector<uint8_t>&& data, uint_fast32_t stride)
+    {
+        auto id = uidGenerator_.fetch_add(1);
+        auto sizeByte = static_cast<uint_fast32_t>(data.size());
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        context_->createBuffer(DX12Context::EResourceType::VERTEX_BUFFER, id, std::move(data), EFormat::UNKNOWN, stride, sizeByte);
+
+        return std::make_unique<VertexBufferImpl>(context_, context_->getVertexBuffer(id), id);
+    }
+
+    std::unique_ptr<VertexBufferImpl> RendererImpl::createVertexBuffer(const UploadWriter& writer, uint_fast32_t stride, uint_fast32_t sizeByte)
+    {
+        auto id = uidGenerator_.fetch_add(1);
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        context_->createBuffer(DX12Context::EResourceType::VERTEX_BUFFER, id, writer, EFormat::UNKNOWN, stride, sizeByte);
+
+        return std::make_unique<VertexBufferImpl>(context_, context_->getVertexBuffer(id), id);
+    }
+
+    void RendererImpl::submit(CommandImpl* const* commands, uint_fast32_t count)
+    {
+        std::vector<ThreadPool::GPUDrawFunc> tasks;
+
+        tasks.reserve(count);
+
+        for (uint_fast32_t i = 0; i < count; ++i) {
+            auto desc = commands[i]->releaseDesc();
+
+            if (desc.commands.empty())
+                continue;
+
+            // one task per buffer, workers will build them in parallel
+            auto lamda = [this, desc = std::move(desc)](void* cmd, void* dev)
+            {
+                auto taskCmd = static_cast<TaskCommand*>(cmd);
+
+                return context_->buildCommand(desc, taskCmd);
+            };
+
+            tasks.push_back(ThreadPool::GPUDrawFunc(commands[i]->getPipelineState(), std::move(lamda)));
+        }
+
+        threadPool_->submitGPUBatch(tasks, 0);
+    }
+
     //std::unique_ptr<ConstantBufferImpl> RendererImpl::getConstantBuffer(const std::string& name)
     //{
     //    auto pair = context_->getConstantBuffer(name);
@@ -145,9 +268,45 @@ namespace Takoyaki
     //        return nullptr;
     //}
 
+    UploadAllocation RendererImpl::allocateUpload(uint_fast32_t sizeByte)
+    {
+        // FrameworkImpl::present holds the writer lock while the frame advances and its page is reset
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        return device_->getUploadRing().allocate(device_->getCurrentFrame(), sizeByte);
+    }
+
     uint_fast32_t RendererImpl::getDefaultRenderTargetHandle() const
     {
         return device_->getCurrentFrame();
     }
+
+    uint_fast32_t RendererImpl::registerBindlessIndexBuffer(uint_fast32_t handle)
+    {
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        return context_->registerBindless(DX12Context::EResourceType::INDEX_BUFFER, handle);
+    }
+
+    uint_fast32_t RendererImpl::registerBindlessTexture(uint_fast32_t handle)
+    {
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        return context_->registerBindless(DX12Context::EResourceType::TEXTURE, handle);
+    }
+
+    uint_fast32_t RendererImpl::registerBindlessVertexBuffer(uint_fast32_t handle)
+    {
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        return context_->registerBindless(DX12Context::EResourceType::VERTEX_BUFFER, handle);
+    }
+
+    void RendererImpl::unregisterBindless(uint_fast32_t index)
+    {
+        std::shared_lock<std::shared_timed_mutex> readLock{ rwMutex_ };
+
+        context_->unregisterBindless(index);
+    }
 }
 // namespace Takoyaki
\ No newline at end of file
@@ -30,11 +30,13 @@ namespace Takoyaki
 {
     class CommandImpl;
     class ConstantBufferImpl;
+    class DynamicBufferImpl;
     class IndexBufferImpl;
     class InputLayoutImpl;
     class DX12Context;
     class DX12Device;
     class DX12Texture;
+    class RenderGraphImpl;
     class RootSignatureImpl;
     class TextureImpl;
     class ThreadPool;
@@ -61,17 +63,36 @@ namespace Takoyaki
         // External usage:
         std::unique_ptr<CommandImpl> createCommand();
         std::unique_ptr<CommandImpl> createCommand(const std::string&);
+        std::unique_ptr<CommandImpl> createCommandBuffer(const std::string&);
         std::unique_ptr<ConstantBufferImpl> createConstantBuffer(const std::string&, uint_fast32_t);
+        std::unique_ptr<DynamicBufferImpl> createDynamicIndexBuffer(EFormat, uint_fast32_t);
+        std::unique_ptr<DynamicBufferImpl> createDynamicVertexBuffer(uint_fast32_t, uint_fast32_t);
         std::unique_ptr<IndexBufferImpl> createIndexBuffer(uint8_t*, EFormat, uint_fast32_t);
+        std::unique_ptr<IndexBufferImpl> createIndexBuffer(std::vector<uint8_t>&&, EFormat);
+        std::unique_ptr<IndexBufferImpl> createIndexBuffer(const UploadWriter&, EFormat, uint_fast32_t);
         std::unique_ptr<InputLayoutImpl> createInputLayout(const std::string&);
+        std::unique_ptr<RenderGraphImpl> createRenderGraph();
         std::unique_ptr<RootSignatureImpl> createRootSignature(const std::string&);
         std::unique_ptr<TextureImpl> createTexture(const TextureDesc&);
+        std::unique_ptr<TextureImpl> createTexture(const TextureDesc&, const SubresourceData*);
+        std::unique_ptr<TextureImpl> createStreamingTexture(const TextureDesc&, const TextureWriter&);
         std::unique_ptr<VertexBufferImpl> createVertexBuffer(uint8_t*, uint_fast32_t, uint_fast32_t);
+        std::unique_ptr<VertexBufferImpl> createVertexBuffer(std::vector<uint8_t>&&, uint_fast32_t);
+        std::unique_ptr<VertexBufferImpl> createVertexBuffer(const UploadWriter&, uint_fast32_t, uint_fast32_t);
 
         void createPipelineState(const std::string&, const PipelineStateDesc&);
+        uint_fast32_t createSampler(const SamplerDesc&);
 
         void compilePipelineStateObjects();
 
+        void submit(CommandImpl* const*, uint_fast32_t);
+
+        uint_fast32_t registerBindlessIndexBuffer(uint_fast32_t);
+        uint_fast32_t registerBindlessTexture(uint_fast32_t);
+        uint_fast32_t registerBindlessVertexBuffer(uint_fast32_t);
+        void unregisterBindless(uint_fast32_t);
+
+        UploadAllocation allocateUpload(uint_fast32_t);
         uint_fast32_t getDefaultRenderTargetHandle() const;
 
     private:
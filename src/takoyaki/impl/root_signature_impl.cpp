@@ -62,6 +62,11 @@ namespace Takoyaki
         rs_.addDescriptorRange(index, type, numDescriptors, baseShaderRegister);
     }
 
+    void RootSignatureImpl::addStaticSampler(const SamplerDesc& desc, uint_fast32_t shaderRegister)
+    {
+        rs_.addStaticSampler(desc, shaderRegister);
+    }
+
     void RootSignatureImpl::setFlags(uint_fast32_t flags)
     {
         rs_.setFlags(flags);
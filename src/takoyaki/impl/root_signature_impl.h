@@ -43,6 +43,7 @@ namespace Takoyaki
         void addDescriptorShaderResource(uint_fast32_t);
         uint_fast32_t addDescriptorTable();
         void addDescriptorRange(uint_fast32_t, EDescriptorType, uint_fast32_t, uint_fast32_t);
+        void addStaticSampler(const SamplerDesc&, uint_fast32_t);
         void setFlags(uint_fast32_t);
 
     private:
@@ -45,9 +45,9 @@ namespace Takoyaki
         return texture_.getSizeByte();
     }
 
-    void TextureImpl::read(uint8_t* dst, uint_fast32_t size) const
+    uint_fast32_t TextureImpl::getResidentMip() const
     {
-        texture_.read(dst, size);
+        return texture_.getResidentMip();
     }
 }
 // namespace Takoyaki
\ No newline at end of file
@@ -37,8 +37,7 @@ namespace Takoyaki
 
         inline uint_fast32_t getHandle() const { return handle_; }
         uint_fast64_t getSizeByte() const;
-
-        void read(uint8_t*, uint_fast32_t) const;
+        uint_fast32_t getResidentMip() const;
 
     private:
         // must own pointer to context for destruction
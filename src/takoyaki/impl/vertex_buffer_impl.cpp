@@ -34,6 +34,11 @@ namespace Takoyaki
 
     }
 
+    bool VertexBufferImpl::isReady() const
+    {
+        return buffer_.isReady();
+    }
+
     VertexBufferImpl::~VertexBufferImpl()
     {
         auto context = context_.lock();
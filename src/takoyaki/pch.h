@@ -38,13 +38,21 @@
 
 // STL
 #include <atomic>
+#include <algorithm>
 #include <array>
+#include <cfloat>
+#include <deque>
 #include <exception>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <thread>
 #include <queue>
+#include <set>
 #include <shared_mutex>
 #include <unordered_map>
 #include <vector>
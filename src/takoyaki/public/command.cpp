@@ -47,11 +47,36 @@ namespace Takoyaki
         impl_->copyTextureRegion(params);
     }
 
+    void Command::readTexture(uint_fast32_t handle, uint_fast32_t subresource, const ReadbackCallback& callback)
+    {
+        impl_->readTexture(handle, subresource, callback);
+    }
+
+    std::future<std::vector<uint8_t>> Command::readTexture(uint_fast32_t handle, uint_fast32_t subresource)
+    {
+        return impl_->readTexture(handle, subresource);
+    }
+
     void Command::drawIndexed(uint_fast32_t indexCount, uint_fast32_t startIndex, int_fast32_t baseVertex)
     {
         impl_->drawIndexed(indexCount, startIndex, baseVertex);
     }
 
+    void Command::multiDraw(uint_fast32_t rootIndex, uint_fast32_t numConstants, const DrawIndexedRecord* records, uint_fast32_t count)
+    {
+        impl_->multiDraw(rootIndex, numConstants, records, count);
+    }
+
+    void Command::setBindlessIndex(uint_fast32_t rootIndex, uint_fast32_t bindlessIndex, uint_fast32_t offset)
+    {
+        impl_->setBindlessIndex(rootIndex, bindlessIndex, offset);
+    }
+
+    void Command::setBindlessTable(uint_fast32_t rootIndex)
+    {
+        impl_->setBindlessTable(rootIndex);
+    }
+
     void Command::setIndexBuffer(uint_fast32_t handle)
     {
         impl_->setIndexBuffer(handle);
@@ -67,6 +92,16 @@ namespace Takoyaki
         impl_->setRenderTarget(handle);
     }
 
+    void Command::setRootConstantBufferView(uint_fast32_t index, const UploadAllocation& allocation)
+    {
+        impl_->setRootConstantBufferView(index, allocation);
+    }
+
+    void Command::setRootConstants(uint_fast32_t index, const uint32_t* values, uint_fast32_t count, uint_fast32_t offset)
+    {
+        impl_->setRootConstants(index, values, count, offset);
+    }
+
     void Command::setRootSignature(const std::string& name)
     {
         impl_->setRootSignature(name);
@@ -77,11 +112,21 @@ namespace Takoyaki
         impl_->setRootSignatureConstantBuffer(index, name);
     }
 
+    void Command::setSamplerTable(uint_fast32_t rootIndex, uint_fast32_t sampler)
+    {
+        impl_->setSamplerTable(rootIndex, sampler);
+    }
+
     void Command::setScissor(const glm::uvec4& scissor)
     {
         impl_->setScissor(scissor);
     }
 
+    void Command::setSortKey(uint64_t key)
+    {
+        impl_->setSortKey(key);
+    }
+
     void Command::setTopology(ETopology topology)
     {
         impl_->setTopology(topology);
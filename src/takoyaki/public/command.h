@@ -20,7 +20,9 @@
 
 #pragma once
 
+#include <future>
 #include <memory>
+#include <vector>
 
 #include "definitions.h"
 
@@ -39,23 +41,54 @@ namespace Takoyaki
         Command(std::unique_ptr<CommandImpl>) noexcept;
         ~Command() noexcept;
 
+        // Commands are executed in ascending key order, see sort_key.h for the layout
+        // setPriority only fills the pass field and leave the rest of the key to 0, throw above 255
         void setPriority(uint_fast32_t priority);
+        void setSortKey(uint64_t key);
 
         //void copyRenderTargetToTexture(uint_fast32_t dstTex);
+
+        // source and destination must be different textures
         void copyTextureRegion(const CopyTexRegionParams& params);
 
+        // Copy a subresource back to the CPU without stalling, the copy is recorded with this command and
+        // the result is handed over from Framework::present once the GPU is done with the frame, a few frames later
+        // the future gets the rows tightly packed
+        void readTexture(uint_fast32_t handle, uint_fast32_t subresource, const ReadbackCallback& callback);
+        std::future<std::vector<uint8_t>> readTexture(uint_fast32_t handle, uint_fast32_t subresource = 0);
+
         // draw commands
         void drawIndexed(uint_fast32_t indexCount, uint_fast32_t startIndex, int_fast32_t baseVertex);
 
+        // Issue one draw per record, setting numConstants root constants at rootIndex before each of them
+        // records are copied in one block so the array can be released once the call returns
+        // draws are ordered by their sort key when the command is built on the worker threads
+        void multiDraw(uint_fast32_t rootIndex, uint_fast32_t numConstants, const DrawIndexedRecord* records, uint_fast32_t count);
+
         // geometry
         void setTopology(ETopology topology);
         void setIndexBuffer(uint_fast32_t handle);
         void setVertexBuffer(uint_fast32_t handle);
 
         // root signature
+        // the allocation must come from Renderer::allocateUpload of the same frame, index must be a root CBV
+        void setRootConstantBufferView(uint_fast32_t index, const UploadAllocation& allocation);
+
+        // count 32-bit values written at offset in the root constants at index, copied when recorded
+        // cheapest way to pass small per draw data, nothing to allocate or bind
+        void setRootConstants(uint_fast32_t index, const uint32_t* values, uint_fast32_t count, uint_fast32_t offset);
+
         void setRootSignature(const std::string& name);
         void setRootSignatureConstantBuffer(uint_fast32_t index, const std::string& name);
 
+        // sampler from Renderer::createSampler, the table must have a single SAMPLER range
+        void setSamplerTable(uint_fast32_t rootIndex, uint_fast32_t sampler);
+
+        // bindless, the table is the whole array registered with the Renderer and must be declared with
+        // a BINDLESS_UNBOUNDED range, indices are passed to shaders as a 32-bit root constant
+        void setBindlessTable(uint_fast32_t rootIndex);
+        void setBindlessIndex(uint_fast32_t rootIndex, uint_fast32_t bindlessIndex, uint_fast32_t offset);
+
         // viewport
         void setScissor(const glm::uvec4& scissor);
         void setViewport(const glm::vec4& viewport);
@@ -64,7 +97,7 @@ namespace Takoyaki
         void setRenderTarget(uint_fast32_t handle);
         void clearRenderTarget(const glm::vec4& color);
 
-    private:
+    protected:
         std::unique_ptr<CommandImpl> impl_;
     };
 }
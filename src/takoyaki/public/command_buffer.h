@@ -0,0 +1,44 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "command.h"
+
+namespace Takoyaki
+{
+    class RenderGraphImpl;
+    class Renderer;
+
+    // Same recording interface as Command but nothing is sent to the GPU until Renderer::submit
+    // Each thread should record in its own buffer, buffers can be reused after submission
+    // Resources are resolved while recording, they must not be destroyed before the buffer is submitted
+    // and the frame is presented, debug builds throw when such a command is built
+    class CommandBuffer : public Command
+    {
+        friend class Renderer;
+        friend class RenderGraphImpl;
+
+    public:
+        explicit CommandBuffer(std::unique_ptr<CommandImpl>) noexcept;
+        ~CommandBuffer() noexcept;
+    };
+}
+// namespace Takoyaki
@@ -34,10 +34,30 @@ namespace Takoyaki
 
     ConstantBuffer::~ConstantBuffer() = default;
 
+    FieldHandle ConstantBuffer::addVariable(const std::string& name, uint_fast32_t offset, uint_fast32_t sizeByte)
+    {
+        return impl_->addVariable(name, offset, sizeByte);
+    }
+
+    FieldHandle ConstantBuffer::getField(const std::string& name) const
+    {
+        return impl_->getField(name);
+    }
+
+    void ConstantBuffer::setField(FieldHandle handle, const void* data, uint_fast32_t sizeByte)
+    {
+        impl_->setField(handle, data, sizeByte);
+    }
+
     void ConstantBuffer::setMatrix4x4(const std::string& name, const glm::mat4x4& value)
     {
         if (impl_)
             impl_->setMatrix4x4(name, value);
     }
+
+    void ConstantBuffer::setRange(uint_fast32_t offset, const void* data, uint_fast32_t sizeByte)
+    {
+        impl_->setRange(offset, data, sizeByte);
+    }
 }
 // namespace Takoyaki
\ No newline at end of file
@@ -22,8 +22,11 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <glm/fwd.hpp>
 
+#include "definitions.h"
+
 namespace Takoyaki
 {
     class ConstantBufferImpl;
@@ -39,6 +42,27 @@ namespace Takoyaki
         ConstantBuffer(std::unique_ptr<ConstantBufferImpl>) noexcept;
         ~ConstantBuffer() noexcept;
 
+        // layout, usually from the shader reflection, must be done before the first write
+        FieldHandle addVariable(const std::string& name, uint_fast32_t offset, uint_fast32_t sizeByte);
+
+        // FIELD_INVALID if there is no such variable, resolve once and keep the handle
+        FieldHandle getField(const std::string& name) const;
+
+        template <typename T>
+        void set(FieldHandle handle, const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "ConstantBuffer::set, T must be trivially copyable");
+            setField(handle, &value, sizeof(T));
+        }
+
+        // write sizeByte at a field, at most its size
+        // writes are kept on the CPU and copied to the GPU the next time the buffer is bound
+        void setField(FieldHandle handle, const void* data, uint_fast32_t sizeByte);
+
+        // bulk write at any offset, for arrays or to update several variables at once
+        void setRange(uint_fast32_t offset, const void* data, uint_fast32_t sizeByte);
+
+        // name lookup on each call, prefer set with a handle
         void setMatrix4x4(const std::string& name, const glm::mat4x4& value);
 
     private:
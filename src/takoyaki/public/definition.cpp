@@ -51,8 +51,44 @@ namespace Takoyaki
     {
     }
 
+    DescriptorHeapDesc::DescriptorHeapDesc() noexcept
+        : capacity{ 128 }
+        , growth{ EDescriptorHeapGrowth::GEOMETRIC }
+    {
+    }
+
+    DescriptorHeapStats::DescriptorHeapStats() noexcept
+        : numHeaps{ 0 }
+        , capacity{ 0 }
+        , used{ 0 }
+        , peak{ 0 }
+        , reserved{ 0 }
+        , numFreeBlocks{ 0 }
+        , largestFreeBlock{ 0 }
+        , fragmentation{ 0.f }
+    {
+    }
+
+    DrawIndexedRecord::DrawIndexedRecord() noexcept
+        : sortKey{ 0 }
+        , indexCount{ 0 }
+        , startIndex{ 0 }
+        , baseVertex{ 0 }
+        , constants{}
+    {
+    }
+
     FrameworkDesc::FrameworkDesc() noexcept
-        : bufferCount{ 3 }
+        : bindlessCapacity{ 4096 }
+        , bufferCount{ 3 }
+        , mipStreamingBudget{ 4 * 1024 * 1024 }
+        , readbackPageSize{ 8 * 1024 * 1024 }
+        , resourceHeapSize{ 64 * 1024 * 1024 }
+        , samplerHeapSize{ 256 }
+        , shaderVisibleHeapSize{ 16384 }
+        , tableCacheSize{ 4096 }
+        , uploadPageSize{ 4 * 1024 * 1024 }
+        , uploadStagingSize{ 32 * 1024 * 1024 }
         , currentOrientation{ EDisplayOrientation::LANDSCAPE }
         , nativeOrientation{ EDisplayOrientation::LANDSCAPE }
         , numWorkerThreads{ 4 }
@@ -103,6 +139,20 @@ namespace Takoyaki
     {
     }
 
+    SamplerDesc::SamplerDesc() noexcept
+        : filter{ EFilter::LINEAR }
+        , addressU{ ETextureAddressMode::CLAMP }
+        , addressV{ ETextureAddressMode::CLAMP }
+        , addressW{ ETextureAddressMode::CLAMP }
+        , mipLODBias{ 0.f }
+        , maxAnisotropy{ 16 }
+        , comparisonFunc{ ECompFunc::LESS_EQUAL }
+        , borderColor{ EBorderColor::OPAQUE_WHITE }
+        , minLOD{ 0.f }
+        , maxLOD{ FLT_MAX }
+    {
+    }
+
     StencilOpDesc::StencilOpDesc() noexcept
         : fail{ EStencilOp::KEEP }
         , depthFail{ EStencilOp::KEEP }
@@ -118,4 +168,11 @@ namespace Takoyaki
         , mipmaps{ 1 }
     {
     }
+
+    UploadAllocation::UploadAllocation() noexcept
+        : cpu{ nullptr }
+        , gpu{ 0 }
+        , size{ 0 }
+    {
+    }
 } // namespace Takoyaki
\ No newline at end of file
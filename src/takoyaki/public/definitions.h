@@ -51,6 +51,14 @@ namespace Takoyaki
         MAX
     };
 
+    // static samplers can only use these
+    enum class EBorderColor
+    {
+        TRANSPARENT_BLACK,
+        OPAQUE_BLACK,
+        OPAQUE_WHITE
+    };
+
     enum class EColorMask : uint8_t
     {
         RED = 1,
@@ -79,6 +87,23 @@ namespace Takoyaki
         NONE
     };
 
+    // how a descriptor heap collection size new heaps once the previous ones are full
+    enum class EDescriptorHeapGrowth
+    {
+        FIXED,          // every heap has the initial capacity
+        GEOMETRIC       // each heap doubles the previous one
+    };
+
+    enum class EDescriptorHeapType
+    {
+        CBV_SRV_UAV,    // CPU only staging heaps
+        RTV,
+        SHADER_VISIBLE, // transient tables bound to command lists
+        BINDLESS,
+        SAMPLER,
+        TABLE_CACHE     // tables reused by binding set, in the shader visible heap
+    };
+
     enum class EDescriptorType
     {
         CONSTANT_BUFFER,
@@ -109,6 +134,17 @@ namespace Takoyaki
         WIREFRAME,
     };
 
+    // comparison filters use SamplerDesc::comparisonFunc
+    enum class EFilter
+    {
+        POINT,
+        LINEAR,
+        ANISOTROPIC,
+        COMPARISON_POINT,
+        COMPARISON_LINEAR,
+        COMPARISON_ANISOTROPIC
+    };
+
     // will add as needed
     enum class EFormat
     {
@@ -145,6 +181,16 @@ namespace Takoyaki
         RF_RENDERTARGET = 0x1
     };
 
+    // states a texture can be declared in by render graph passes
+    enum class EResourceState
+    {
+        COMMON,
+        COPY_DEST,
+        COPY_SOURCE,
+        RENDER_TARGET,
+        SHADER_READ
+    };
+
     // just mirror dx12 for now
     enum ERootSignatureFlag
     {
@@ -183,6 +229,15 @@ namespace Takoyaki
         DECR
     };
 
+    enum class ETextureAddressMode
+    {
+        WRAP,
+        MIRROR,
+        CLAMP,
+        BORDER,
+        MIRROR_ONCE
+    };
+
     // will add as needed
     enum class ETopology
     {
@@ -259,11 +314,46 @@ namespace Takoyaki
         ECompFunc backFunc;
     };
 
+    struct DescriptorHeapDesc
+    {
+        DescriptorHeapDesc() noexcept;
+
+        uint_fast32_t           capacity;       // descriptors in the first heap
+        EDescriptorHeapGrowth   growth;
+    };
+
+    // occupancy of one descriptor heap type, used include the reserved slots sitting in thread caches
+    // fragmentation is 1 - largest free block / free slots of the range heaps
+    struct DescriptorHeapStats
+    {
+        DescriptorHeapStats() noexcept;
+
+        uint_fast32_t           numHeaps;
+        uint_fast32_t           capacity;
+        uint_fast32_t           used;
+        uint_fast32_t           peak;
+        uint_fast32_t           reserved;               // counted in used, held by thread caches until taken or the frame ends
+        uint_fast32_t           numFreeBlocks;
+        uint_fast32_t           largestFreeBlock;
+        float                   fragmentation;
+    };
+
     struct FrameworkDesc
     {
         FrameworkDesc() noexcept;
 
+        uint_fast32_t           bindlessCapacity;       // 0 disable bindless
         uint_fast32_t           bufferCount;
+        DescriptorHeapDesc      cbvSrvUavHeap;
+        uint_fast32_t           mipStreamingBudget;     // bytes of streamed mips started per frame
+        uint_fast32_t           readbackPageSize;       // bytes of texture data read back per frame, 0 disable readback
+        uint_fast32_t           resourceHeapSize;       // power of two, heaps buffers and textures are placed in, 0 commit each resource
+        DescriptorHeapDesc      rtvHeap;
+        uint_fast32_t           samplerHeapSize;        // unique samplers from Renderer::createSampler, 2048 max
+        uint_fast32_t           shaderVisibleHeapSize;
+        uint_fast32_t           tableCacheSize;         // 0 disable the descriptor table cache
+        uint_fast32_t           uploadPageSize;         // bytes of transient upload memory per frame
+        uint_fast32_t           uploadStagingSize;      // bytes of staging memory for buffer and texture data, largest single upload
         EDisplayOrientation     currentOrientation;
         EDisplayOrientation     nativeOrientation;
         uint_fast32_t           numWorkerThreads;
@@ -319,6 +409,23 @@ namespace Takoyaki
         ETopologyType topology;
     };
 
+    // https://msdn.microsoft.com/en-us/library/windows/desktop/dn986754(v=vs.85).aspx
+    struct SamplerDesc
+    {
+        SamplerDesc() noexcept;
+
+        EFilter filter;
+        ETextureAddressMode addressU;
+        ETextureAddressMode addressV;
+        ETextureAddressMode addressW;
+        float mipLODBias;
+        uint_fast32_t maxAnisotropy;
+        ECompFunc comparisonFunc;
+        EBorderColor borderColor;
+        float minLOD;
+        float maxLOD;
+    };
+
     struct TextureDesc
     {
         TextureDesc() noexcept;
@@ -333,9 +440,25 @@ namespace Takoyaki
         uint_fast32_t width;
     };
 
+    //////////////////////////////////////////////////////////////////////////
+    // Constant buffer
+
+    // Index of a constant buffer variable, resolve once with ConstantBuffer::getField and reuse
+    using FieldHandle = uint_fast32_t;
+    constexpr FieldHandle FIELD_INVALID = UINT_FAST32_MAX;
+
     //////////////////////////////////////////////////////////////////////////
     // Command param desc
 
+    // numDescriptors of RootSignature::addDescriptorRange for the bindless array, must be the last range of its table
+    constexpr uint_fast32_t BINDLESS_UNBOUNDED = UINT32_MAX;
+
+    // A root signature holds at most 64 DWORDs, each root constant uses one of them
+    constexpr uint_fast32_t MAX_ROOT_CONSTANTS = 64;
+
+    // Number of 32-bit root constants that can be passed with each draw of a multiDraw
+    constexpr uint_fast32_t MAX_DRAW_ROOT_CONSTANTS = 4;
+
     struct CopyTexRegionParams
     {
         CopyTexRegionParams() noexcept;
@@ -348,4 +471,47 @@ namespace Takoyaki
         glm::ivec3 srcAreaMin;
         glm::ivec3 srcAreaMax;
     };
+
+    // Transient upload memory from Renderer::allocateUpload, valid until the end of the frame
+    // write only, the memory is write-combined
+    struct UploadAllocation
+    {
+        UploadAllocation() noexcept;
+
+        uint8_t* cpu;
+        uint64_t gpu;
+        uint_fast32_t size;
+    };
+
+    // Fill sizeByte bytes of upload memory for a buffer creation, write only and preferably in order
+    // since the memory is write-combined
+    using UploadWriter = std::function<void(uint8_t* dst, uint_fast32_t sizeByte)>;
+
+    // One subresource of texture data, rows are rowPitch bytes apart and depth slices slicePitch bytes apart
+    struct SubresourceData
+    {
+        const void* data;
+        uint_fast32_t rowPitch;
+        uint_fast32_t slicePitch;
+    };
+
+    // Same as UploadWriter for one subresource of a texture, rows and depth slices must be written at the given pitches
+    using TextureWriter = std::function<void(uint_fast32_t mip, uint_fast32_t arraySlice, uint8_t* dst, uint_fast32_t rowPitch, uint_fast32_t slicePitch)>;
+
+    // Subresource copied back from the GPU, numRows rows of rowSizeByte bytes, rowPitch bytes apart
+    // the memory is only valid during the callback
+    using ReadbackCallback = std::function<void(const uint8_t* data, uint_fast32_t rowSizeByte, uint_fast32_t rowPitch, uint_fast32_t numRows)>;
+
+    // One draw of a multiDraw, constants are set to the root signature before the draw is issued
+    // draws are issued in sortKey order (see sort_key.h), records with the same key keep their order
+    struct DrawIndexedRecord
+    {
+        DrawIndexedRecord() noexcept;
+
+        uint64_t sortKey;
+        uint_fast32_t indexCount;
+        uint_fast32_t startIndex;
+        int_fast32_t baseVertex;
+        std::array<uint32_t, MAX_DRAW_ROOT_CONSTANTS> constants;
+    };
 } // namespace Takoyaki
\ No newline at end of file
@@ -0,0 +1,55 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "dynamic_buffer.h"
+
+#include "../impl/dynamic_buffer_impl.h"
+
+namespace Takoyaki
+{
+    DynamicBuffer::DynamicBuffer(std::unique_ptr<DynamicBufferImpl> impl) noexcept
+        : impl_{ std::move(impl) }
+    {
+    }
+
+    DynamicBuffer::~DynamicBuffer() noexcept = default;
+
+    uint_fast32_t DynamicBuffer::getHandle() const
+    {
+        return impl_->getHandle();
+    }
+
+    uint_fast32_t DynamicBuffer::getSize() const
+    {
+        return impl_->getSize();
+    }
+
+    uint8_t* DynamicBuffer::map(bool discard)
+    {
+        return impl_->map(discard);
+    }
+
+    void DynamicBuffer::unmap()
+    {
+        impl_->unmap();
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,57 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <memory>
+
+namespace Takoyaki
+{
+    class DynamicBufferImpl;
+
+    // Vertex or index buffer rewritten by the CPU every frame, particles, UI, debug lines..
+    // each frame in flight has its own copy so writing never waits on the GPU
+    // contents do not persist from one frame to the next, map and write the whole buffer every frame
+    // and record Command::setVertexBuffer or Command::setIndexBuffer after unmap, commands keep the
+    // contents unmapped when they were recorded
+    class DynamicBuffer
+    {
+        DynamicBuffer(const DynamicBuffer&) = delete;
+        DynamicBuffer& operator=(const DynamicBuffer&) = delete;
+        DynamicBuffer(DynamicBuffer&&) = delete;
+        DynamicBuffer& operator=(DynamicBuffer&&) = delete;
+
+    public:
+        explicit DynamicBuffer(std::unique_ptr<DynamicBufferImpl>) noexcept;
+        ~DynamicBuffer() noexcept;
+
+        uint_fast32_t getHandle() const;
+        uint_fast32_t getSize() const;
+
+        // write-combined memory, write sequentially and never read from it
+        // discard when mapping again in the same frame, commands already recorded keep the previous contents
+        uint8_t* map(bool discard = false);
+        void unmap();
+
+    private:
+        std::unique_ptr<DynamicBufferImpl> impl_;
+    };
+}
+// namespace Takoyaki
@@ -38,6 +38,11 @@ namespace Takoyaki
         return std::make_unique<Renderer>(impl_->getRenderer());
     }
 
+    DescriptorHeapStats Framework::getDescriptorHeapStats(EDescriptorHeapType type) const
+    {
+        return impl_->getDescriptorHeapStats(type);
+    }
+
     const glm::vec2& Framework::getWindowSize() const
     {
         return impl_->getWindowSize();
@@ -50,6 +50,9 @@ namespace Takoyaki
 
         std::unique_ptr<Renderer> getRenderer();
 
+        // live occupancy, to size FrameworkDesc heaps to the content
+        DescriptorHeapStats getDescriptorHeapStats(EDescriptorHeapType type) const;
+
         const glm::vec2& getWindowSize() const;
 
         void setDisplayDpi(float dpi);
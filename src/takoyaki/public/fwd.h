@@ -22,8 +22,10 @@
 namespace Takoyaki
 {
     class Command;
+    class CommandBuffer;
     class Framework;
     class IndexBuffer;
+    class RenderGraph;
     class Renderer;
     class VertexBuffer;
     class Texture;
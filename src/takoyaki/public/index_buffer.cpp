@@ -36,5 +36,10 @@ namespace Takoyaki
     {
         return impl_->getHandle();
     }
+
+    bool IndexBuffer::isReady() const
+    {
+        return impl_->isReady();
+    }
 }
 // namespace Takoyaki
\ No newline at end of file
@@ -39,6 +39,9 @@ namespace Takoyaki
 
         uint_fast32_t getHandle() const;
 
+        // the data has been copied to the GPU, the buffer can be used in commands before that
+        bool isReady() const;
+
     private:
         std::unique_ptr<IndexBufferImpl> impl_;
     };
@@ -0,0 +1,100 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "render_graph.h"
+
+#include "../impl/render_graph_impl.h"
+
+namespace Takoyaki
+{
+    RenderGraph::RenderGraph(std::unique_ptr<RenderGraphImpl> impl) noexcept
+        : impl_{ std::move(impl) }
+    {
+    }
+
+    RenderGraph::~RenderGraph() noexcept = default;
+
+    uint_fast32_t RenderGraph::addPass(const std::string& pipelineState, const PassFunc& func)
+    {
+        return impl_->addPass(pipelineState, func);
+    }
+
+    void RenderGraph::clear()
+    {
+        impl_->clear();
+    }
+
+    void RenderGraph::compile()
+    {
+        impl_->compile();
+    }
+
+    uint_fast32_t RenderGraph::createTexture(const TextureDesc& desc)
+    {
+        return impl_->createTexture(desc);
+    }
+
+    void RenderGraph::execute()
+    {
+        impl_->execute();
+    }
+
+    uint_fast32_t RenderGraph::getNumCulledPasses() const
+    {
+        return impl_->getNumCulledPasses();
+    }
+
+    uint_fast32_t RenderGraph::getNumTransientTextures() const
+    {
+        return impl_->getNumTransientTextures();
+    }
+
+    uint_fast32_t RenderGraph::getTextureHandle(uint_fast32_t resource) const
+    {
+        return impl_->getTextureHandle(resource);
+    }
+
+    uint_fast32_t RenderGraph::importBackBuffer()
+    {
+        return impl_->importTexture(UINT_FAST32_MAX);
+    }
+
+    uint_fast32_t RenderGraph::importTexture(uint_fast32_t handle)
+    {
+        return impl_->importTexture(handle);
+    }
+
+    void RenderGraph::markOutput(uint_fast32_t resource)
+    {
+        impl_->markOutput(resource);
+    }
+
+    void RenderGraph::read(uint_fast32_t pass, uint_fast32_t resource, EResourceState state)
+    {
+        impl_->read(pass, resource, state);
+    }
+
+    void RenderGraph::write(uint_fast32_t pass, uint_fast32_t resource, EResourceState state)
+    {
+        impl_->write(pass, resource, state);
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,80 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "definitions.h"
+
+namespace Takoyaki
+{
+    class Command;
+    class RenderGraphImpl;
+
+    // Frame graph on top of the renderer
+    // Passes declare the textures they read and write, compile() then cull the passes which
+    // do not contribute to an imported or output texture, order the others, reuse one texture for
+    // transients with the same description whose lifetimes do not overlap and plan the state transitions
+    class RenderGraph
+    {
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+        RenderGraph(RenderGraph&&) = delete;
+        RenderGraph& operator=(RenderGraph&&) = delete;
+
+    public:
+        using PassFunc = std::function<void(Command&)>;
+
+        explicit RenderGraph(std::unique_ptr<RenderGraphImpl>) noexcept;
+        ~RenderGraph() noexcept;
+
+        // resources
+        uint_fast32_t createTexture(const TextureDesc& desc);
+        uint_fast32_t importBackBuffer();
+        uint_fast32_t importTexture(uint_fast32_t handle);
+        void markOutput(uint_fast32_t resource);
+
+        // passes are declared in the order they would be submitted without the graph
+        // the render target of a pass is the first texture it writes as RENDER_TARGET
+        uint_fast32_t addPass(const std::string& pipelineState, const PassFunc& func);
+        void read(uint_fast32_t pass, uint_fast32_t resource, EResourceState state);
+        void write(uint_fast32_t pass, uint_fast32_t resource, EResourceState state);
+
+        void clear();
+        void compile();
+
+        // record and submit all the passes of the frame
+        void execute();
+
+        // texture backing a resource, valid after compile
+        uint_fast32_t getTextureHandle(uint_fast32_t resource) const;
+
+        // stats
+        uint_fast32_t getNumCulledPasses() const;
+        uint_fast32_t getNumTransientTextures() const;
+
+    private:
+        std::unique_ptr<RenderGraphImpl> impl_;
+    };
+}
+// namespace Takoyaki
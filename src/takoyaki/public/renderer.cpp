@@ -22,17 +22,22 @@
 #include "renderer.h"
 
 #include "command.h"
+#include "command_buffer.h"
 #include "constant_buffer.h"
+#include "dynamic_buffer.h"
 #include "index_buffer.h"
 #include "input_layout.h"
+#include "render_graph.h"
 #include "root_signature.h"
 #include "texture.h"
 #include "vertex_buffer.h"
 
 #include "../impl/command_impl.h"
 #include "../impl/constant_buffer_impl.h"
+#include "../impl/dynamic_buffer_impl.h"
 #include "../impl/index_buffer_impl.h"
 #include "../impl/input_layout_impl.h"
+#include "../impl/render_graph_impl.h"
 #include "../impl/renderer_impl.h"
 #include "../impl/root_signature_impl.h"
 #include "../impl/texture_impl.h"
@@ -62,26 +67,66 @@ namespace Takoyaki
         return std::make_unique<Command>(impl_->createCommand(pipelineState));
     }
 
+    std::unique_ptr<CommandBuffer> Renderer::createCommandBuffer()
+    {
+        return std::make_unique<CommandBuffer>(impl_->createCommandBuffer(std::string()));
+    }
+
+    std::unique_ptr<CommandBuffer> Renderer::createCommandBuffer(const std::string& pipelineState)
+    {
+        return std::make_unique<CommandBuffer>(impl_->createCommandBuffer(pipelineState));
+    }
+
     std::unique_ptr<ConstantBuffer> Renderer::createConstantBuffer(const std::string& name, uint_fast32_t size)
     {
         return std::make_unique<ConstantBuffer>(impl_->createConstantBuffer(name, size));
     }
 
+    std::unique_ptr<DynamicBuffer> Renderer::createDynamicIndexBuffer(EFormat format, uint_fast32_t sizeByte)
+    {
+        return std::make_unique<DynamicBuffer>(impl_->createDynamicIndexBuffer(format, sizeByte));
+    }
+
+    std::unique_ptr<DynamicBuffer> Renderer::createDynamicVertexBuffer(uint_fast32_t stride, uint_fast32_t sizeByte)
+    {
+        return std::make_unique<DynamicBuffer>(impl_->createDynamicVertexBuffer(stride, sizeByte));
+    }
+
     std::unique_ptr<IndexBuffer> Renderer::createIndexBuffer(uint8_t* indexes, EFormat format, uint_fast32_t sizeByte)
     {
         return std::make_unique<IndexBuffer>(impl_->createIndexBuffer(indexes, format, sizeByte));
     }
 
+    std::unique_ptr<IndexBuffer> Renderer::createIndexBuffer(std::vector<uint8_t>&& indexes, EFormat format)
+    {
+        return std::make_unique<IndexBuffer>(impl_->createIndexBuffer(std::move(indexes), format));
+    }
+
+    std::unique_ptr<IndexBuffer> Renderer::createIndexBuffer(const UploadWriter& writer, EFormat format, uint_fast32_t sizeByte)
+    {
+        return std::make_unique<IndexBuffer>(impl_->createIndexBuffer(writer, format, sizeByte));
+    }
+
     std::unique_ptr<InputLayout> Renderer::createInputLayout(const std::string& name)
     {
         return std::make_unique<InputLayout>(impl_->createInputLayout(name));
     }
 
+    std::unique_ptr<RenderGraph> Renderer::createRenderGraph()
+    {
+        return std::make_unique<RenderGraph>(impl_->createRenderGraph());
+    }
+
     void Renderer::createPipelineState(const std::string& name, const PipelineStateDesc& desc)
     {
         impl_->createPipelineState(name, desc);
     }
 
+    uint_fast32_t Renderer::createSampler(const SamplerDesc& desc)
+    {
+        return impl_->createSampler(desc);
+    }
+
     std::unique_ptr<RootSignature> Renderer::createRootSignature(const std::string& name)
     {
         return std::make_unique<RootSignature>(impl_->createRootSignature(name));
@@ -98,14 +143,75 @@ namespace Takoyaki
         return std::make_unique<Texture>(impl_->createTexture(desc));
     }
 
+    std::unique_ptr<Texture> Renderer::createTexture(const TextureDesc& desc, const SubresourceData* data)
+    {
+        if ((desc.arraySize > 1) && (desc.depth > 1))
+            throw std::runtime_error("TextureDesc arraySize and depth cannot both be > 1");
+
+        return std::make_unique<Texture>(impl_->createTexture(desc, data));
+    }
+
+    std::unique_ptr<Texture> Renderer::createStreamingTexture(const TextureDesc& desc, const TextureWriter& writer)
+    {
+        if ((desc.arraySize > 1) && (desc.depth > 1))
+            throw std::runtime_error("TextureDesc arraySize and depth cannot both be > 1");
+
+        return std::make_unique<Texture>(impl_->createStreamingTexture(desc, writer));
+    }
+
     std::unique_ptr<VertexBuffer> Renderer::createVertexBuffer(uint8_t* vertices, uint_fast32_t stride, uint_fast32_t sizeByte)
     {
         return std::make_unique<VertexBuffer>(impl_->createVertexBuffer(vertices, stride, sizeByte));
     }
 
+    std::unique_ptr<VertexBuffer> Renderer::createVertexBuffer(std::vector<uint8_t>&& vertices, uint_fast32_t stride)
+    {
+        return std::make_unique<VertexBuffer>(impl_->createVertexBuffer(std::move(vertices), stride));
+    }
+
+    std::unique_ptr<VertexBuffer> Renderer::createVertexBuffer(const UploadWriter& writer, uint_fast32_t stride, uint_fast32_t sizeByte)
+    {
+        return std::make_unique<VertexBuffer>(impl_->createVertexBuffer(writer, stride, sizeByte));
+    }
+
+    UploadAllocation Renderer::allocateUpload(uint_fast32_t sizeByte)
+    {
+        return impl_->allocateUpload(sizeByte);
+    }
+
     uint_fast32_t Renderer::getDefaultRenderTarget() const
     {
         return impl_->getDefaultRenderTargetHandle();
     }
+
+    void Renderer::submit(CommandBuffer** buffers, uint_fast32_t count)
+    {
+        std::vector<CommandImpl*> impls(count);
+
+        for (uint_fast32_t i = 0; i < count; ++i)
+            impls[i] = buffers[i]->impl_.get();
+
+        impl_->submit(impls.data(), count);
+    }
+
+    uint_fast32_t Renderer::registerBindlessIndexBuffer(uint_fast32_t handle)
+    {
+        return impl_->registerBindlessIndexBuffer(handle);
+    }
+
+    uint_fast32_t Renderer::registerBindlessTexture(uint_fast32_t handle)
+    {
+        return impl_->registerBindlessTexture(handle);
+    }
+
+    uint_fast32_t Renderer::registerBindlessVertexBuffer(uint_fast32_t handle)
+    {
+        return impl_->registerBindlessVertexBuffer(handle);
+    }
+
+    void Renderer::unregisterBindless(uint_fast32_t index)
+    {
+        impl_->unregisterBindless(index);
+    }
 }
 // namespace Takoyaki
\ No newline at end of file
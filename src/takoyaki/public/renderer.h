@@ -22,15 +22,19 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "definitions.h"
 
 namespace Takoyaki
 {
     class Command;
+    class CommandBuffer;
     class ConstantBuffer;
+    class DynamicBuffer;
     class IndexBuffer;
     class InputLayout;
+    class RenderGraph;
     class RendererImpl;
     class RootSignature;
     class Texture;
@@ -50,15 +54,42 @@ namespace Takoyaki
 
         std::unique_ptr<Command> createCommand();
         std::unique_ptr<Command> createCommand(const std::string& pipelineState);
+        std::unique_ptr<CommandBuffer> createCommandBuffer();
+        std::unique_ptr<CommandBuffer> createCommandBuffer(const std::string& pipelineState);
         std::unique_ptr<ConstantBuffer> createConstantBuffer(const std::string& name, uint_fast32_t size);
+
+        // per-frame CPU written buffers, use the handle with Command::setVertexBuffer and Command::setIndexBuffer
+        // cannot be registered as bindless
+        std::unique_ptr<DynamicBuffer> createDynamicIndexBuffer(EFormat format, uint_fast32_t sizeByte);
+        std::unique_ptr<DynamicBuffer> createDynamicVertexBuffer(uint_fast32_t stride, uint_fast32_t sizeByte);
+
         std::unique_ptr<IndexBuffer> createIndexBuffer(uint8_t* indexes, EFormat format, uint_fast32_t sizeByte);
+        std::unique_ptr<IndexBuffer> createIndexBuffer(std::vector<uint8_t>&& indexes, EFormat format);
+        std::unique_ptr<IndexBuffer> createIndexBuffer(const UploadWriter& writer, EFormat format, uint_fast32_t sizeByte);
         std::unique_ptr<InputLayout> createInputLayout(const std::string& name);
+        std::unique_ptr<RenderGraph> createRenderGraph();
         std::unique_ptr<RootSignature> createRootSignature(const std::string& name);
         std::unique_ptr<Texture> createTexture(const TextureDesc&);
+
+        // GPU_ONLY textures with their content, data has one entry per subresource, all mips of a slice then the next slice
+        // a streaming texture starts with its smallest mips, the writer is then called from present() for one larger
+        // mip at a time, at most FrameworkDesc::mipStreamingBudget bytes per frame, until mip 0 is resident
+        std::unique_ptr<Texture> createTexture(const TextureDesc&, const SubresourceData* data);
+        std::unique_ptr<Texture> createStreamingTexture(const TextureDesc&, const TextureWriter& writer);
         std::unique_ptr<VertexBuffer> createVertexBuffer(uint8_t* vertices, uint_fast32_t stride, uint_fast32_t sizeByte);
 
+        // buffer creation without an extra copy, data is either written by the writer straight into upload memory
+        // during the call, or moved in and streamed to the GPU over the next frames, which also allows buffers
+        // larger than FrameworkDesc::uploadStagingSize
+        std::unique_ptr<VertexBuffer> createVertexBuffer(std::vector<uint8_t>&& vertices, uint_fast32_t stride);
+        std::unique_ptr<VertexBuffer> createVertexBuffer(const UploadWriter& writer, uint_fast32_t stride, uint_fast32_t sizeByte);
+
         void createPipelineState(const std::string& name, const PipelineStateDesc&);
 
+        // Samplers that have to change between draws, use RootSignature::addStaticSampler otherwise
+        // identical descs return the same id, bind with Command::setSamplerTable
+        uint_fast32_t createSampler(const SamplerDesc&);
+
         // Compile pipeline state objects
         // Called once the root signatures and pipeline state objects have been defined
         // commit should happen only once per application
@@ -66,6 +97,23 @@ namespace Takoyaki
 
         uint_fast32_t getDefaultRenderTarget() const;
 
+        // Transient upload memory for per draw data, 256 bytes aligned and valid until the end of the frame
+        // bind with Command::setRootConstantBufferView, cheaper than a named constant buffer per object
+        UploadAllocation allocateUpload(uint_fast32_t sizeByte);
+
+        // Submit recorded command buffers for this frame, each buffer is built into its own command list
+        // buffers can be recorded on any thread but must not be recording while submitted
+        void submit(CommandBuffer** buffers, uint_fast32_t count);
+
+        // Bindless, register a resource once in the persistent descriptor array and index it from
+        // shaders with the returned value, see Command::setBindlessTable and Command::setBindlessIndex
+        // buffers are viewed as ByteAddressBuffer and usable from the next frame
+        // unregister before destroying the resource, the index is reused once the GPU is done with the frame
+        uint_fast32_t registerBindlessIndexBuffer(uint_fast32_t handle);
+        uint_fast32_t registerBindlessTexture(uint_fast32_t handle);
+        uint_fast32_t registerBindlessVertexBuffer(uint_fast32_t handle);
+        void unregisterBindless(uint_fast32_t index);
+
     private:
         std::shared_ptr<RendererImpl> impl_;
     };
@@ -65,6 +65,11 @@ namespace Takoyaki
         impl_->addDescriptorRange(index, type, numDescriptors, baseShaderRegister);
     }
 
+    void RootSignature::addStaticSampler(const SamplerDesc& desc, uint_fast32_t shaderRegister)
+    {
+        impl_->addStaticSampler(desc, shaderRegister);
+    }
+
     void RootSignature::setFlags(uint_fast32_t flags)
     {
         impl_->setFlags(flags);
@@ -49,9 +49,13 @@ namespace Takoyaki
         // return an index to be used with addDescriptorRange
         uint_fast32_t addDescriptorTable();
 
-        // only when using descriptor tables
+        // only when using descriptor tables, use BINDLESS_UNBOUNDED as numDescriptors for the bindless table
         void addDescriptorRange(uint_fast32_t index, EDescriptorType type, uint_fast32_t numDescriptors, uint_fast32_t baseShaderRegister);
 
+        // sampler declared in the root signature, costs no descriptor heap space or per draw binding
+        // prefer it to Renderer::createSampler unless the sampler has to change between draws
+        void addStaticSampler(const SamplerDesc& desc, uint_fast32_t shaderRegister);
+
         void setFlags(uint_fast32_t flags);
 
 
@@ -0,0 +1,76 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "sort_key.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        constexpr uint64_t FieldMask(uint_fast32_t bits)
+        {
+            return (uint64_t{ 1 } << bits) - 1;
+        }
+    }
+
+    SortKeyDesc::SortKeyDesc() noexcept
+        : pass{ 0 }
+        , pipelineState{ 0 }
+        , material{ 0 }
+        , depth{ 0 }
+    {
+    }
+
+    uint64_t encodeSortKey(const SortKeyDesc& desc)
+    {
+        uint64_t key = 0;
+
+        key |= (desc.pass & FieldMask(SORT_KEY_PASS_BITS)) << SORT_KEY_PASS_SHIFT;
+        key |= (desc.pipelineState & FieldMask(SORT_KEY_PIPELINE_BITS)) << SORT_KEY_PIPELINE_SHIFT;
+        key |= (desc.material & FieldMask(SORT_KEY_MATERIAL_BITS)) << SORT_KEY_MATERIAL_SHIFT;
+        key |= (desc.depth & FieldMask(SORT_KEY_DEPTH_BITS)) << SORT_KEY_DEPTH_SHIFT;
+
+        return key;
+    }
+
+    SortKeyDesc decodeSortKey(uint64_t key)
+    {
+        SortKeyDesc desc;
+
+        desc.pass = static_cast<uint_fast32_t>((key >> SORT_KEY_PASS_SHIFT) & FieldMask(SORT_KEY_PASS_BITS));
+        desc.pipelineState = static_cast<uint_fast32_t>((key >> SORT_KEY_PIPELINE_SHIFT) & FieldMask(SORT_KEY_PIPELINE_BITS));
+        desc.material = static_cast<uint_fast32_t>((key >> SORT_KEY_MATERIAL_SHIFT) & FieldMask(SORT_KEY_MATERIAL_BITS));
+        desc.depth = static_cast<uint_fast32_t>((key >> SORT_KEY_DEPTH_SHIFT) & FieldMask(SORT_KEY_DEPTH_BITS));
+
+        return desc;
+    }
+
+    uint_fast32_t quantizeSortDepth(float depth, bool backToFront)
+    {
+        constexpr float maxDepth = static_cast<float>(FieldMask(SORT_KEY_DEPTH_BITS));
+
+        auto clamped = glm::clamp(depth, 0.f, 1.f);
+        auto res = static_cast<uint_fast32_t>(clamped * maxDepth + 0.5f);
+
+        return (backToFront) ? static_cast<uint_fast32_t>(FieldMask(SORT_KEY_DEPTH_BITS)) - res : res;
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,57 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace Takoyaki
+{
+    // Draw ordering is done with a packed 64-bit key, higher bits are sorted first
+    // | pass (8) | pipeline state (16) | material (24) | depth (16) |
+    constexpr uint_fast32_t SORT_KEY_PASS_BITS = 8;
+    constexpr uint_fast32_t SORT_KEY_PIPELINE_BITS = 16;
+    constexpr uint_fast32_t SORT_KEY_MATERIAL_BITS = 24;
+    constexpr uint_fast32_t SORT_KEY_DEPTH_BITS = 16;
+
+    constexpr uint_fast32_t SORT_KEY_DEPTH_SHIFT = 0;
+    constexpr uint_fast32_t SORT_KEY_MATERIAL_SHIFT = SORT_KEY_DEPTH_SHIFT + SORT_KEY_DEPTH_BITS;
+    constexpr uint_fast32_t SORT_KEY_PIPELINE_SHIFT = SORT_KEY_MATERIAL_SHIFT + SORT_KEY_MATERIAL_BITS;
+    constexpr uint_fast32_t SORT_KEY_PASS_SHIFT = SORT_KEY_PIPELINE_SHIFT + SORT_KEY_PIPELINE_BITS;
+
+    struct SortKeyDesc
+    {
+        SortKeyDesc() noexcept;
+
+        uint_fast32_t pass;
+        uint_fast32_t pipelineState;
+        uint_fast32_t material;
+        uint_fast32_t depth;
+    };
+
+    // values larger than their field are truncated
+    uint64_t encodeSortKey(const SortKeyDesc& desc);
+    SortKeyDesc decodeSortKey(uint64_t key);
+
+    // convert a [0, 1] view depth into the depth field
+    // front to back is what you want for opaque geometry, back to front for transparent one
+    uint_fast32_t quantizeSortDepth(float depth, bool backToFront);
+}
+// namespace Takoyaki
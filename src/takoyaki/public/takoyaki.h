@@ -22,12 +22,16 @@
 #pragma comment(lib, "Takoyaki.lib")
 
 #include <command.h>
+#include <command_buffer.h>
 #include <constant_buffer.h>
+#include <dynamic_buffer.h>
 #include <framework.h>
 #include <index_buffer.h>
 #include <input_layout.h>
 #include <math_utils.h>
+#include <render_graph.h>
 #include <renderer.h>
 #include <root_signature.h>
+#include <sort_key.h>
 #include <texture.h>
 #include <vertex_buffer.h>
\ No newline at end of file
@@ -41,9 +41,9 @@ namespace Takoyaki
         return impl_->getSizeByte();
     }
 
-    void Texture::read(uint8_t* dst, uint_fast32_t size) const
+    uint_fast32_t Texture::getResidentMip() const
     {
-        impl_->read(dst, size);
+        return impl_->getResidentMip();
     }
 }
 // namespace Takoyaki
\ No newline at end of file
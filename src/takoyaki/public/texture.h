@@ -39,7 +39,8 @@ namespace Takoyaki
         uint_fast32_t getHandle() const;
         uint_fast64_t getSizeByte() const;
 
-        void read(uint8_t* dst, uint_fast32_t size) const;
+        // most detailed mip that can be sampled, 0 unless the texture is still streaming
+        uint_fast32_t getResidentMip() const;
 
     private:
         std::unique_ptr<TextureImpl> impl_;
@@ -37,5 +37,10 @@ namespace Takoyaki
         return impl_->getHandle();
     }
 
+    bool VertexBuffer::isReady() const
+    {
+        return impl_->isReady();
+    }
+
 }
 // namespace Takoyaki
\ No newline at end of file
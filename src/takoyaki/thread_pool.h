@@ -109,6 +109,13 @@ namespace Takoyaki
             gpuQueues_[target].push(std::make_pair(pipelineState, std::move(f)));
         }
 
+        // tasks are moved from, the vector is left empty
+        void submitGPUBatch(std::vector<GPUDrawFunc>& tasks, uint_fast32_t target)
+        {
+            gpuQueues_[target].pushRange(tasks.begin(), tasks.end());
+            tasks.clear();
+        }
+
         void resume();
         void submitGPUCommandLists();
         void swapQueues();
@@ -74,6 +74,16 @@ namespace Takoyaki
             //cond_.notify_one();
         }
 
+        // push several values while taking the lock only once
+        template<typename Iterator>
+        void pushRange(Iterator first, Iterator last)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            for (; first != last; ++first)
+                queue_.push(std::move(*first));
+        }
+
         // not thread-safe
         void swap(ThreadSafeQueue<T>& other)
         {
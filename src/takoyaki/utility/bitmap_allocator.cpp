@@ -0,0 +1,132 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "bitmap_allocator.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Takoyaki
+{
+    namespace
+    {
+        inline uint32_t LowestBit(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+
+            _BitScanForward64(&index, value);
+
+            return static_cast<uint32_t>(index);
+#else
+            return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+        }
+    }
+
+    BitmapAllocator::BitmapAllocator(uint32_t capacity)
+        : capacity_{ capacity }
+        , numFree_{ capacity }
+    {
+        if (capacity == 0)
+            throw std::runtime_error{ "BitmapAllocator, capacity cannot be 0" };
+
+        uint32_t count = capacity;
+
+        // build levels until one word covers everything
+        do {
+            uint32_t words = (count + 63) / 64;
+            std::vector<uint64_t> level(words, 0);
+
+            for (uint32_t i = 0; i < count; ++i)
+                level[i / 64] |= uint64_t{ 1 } << (i % 64);
+
+            levels_.push_back(std::move(level));
+            count = words;
+        } while (count > 1);
+    }
+
+    uint32_t BitmapAllocator::allocate()
+    {
+        if (numFree_ == 0)
+            return BITMAP_INVALID;
+
+        uint32_t index = 0;
+
+        for (auto level = levels_.size(); level-- > 0;)
+            index = index * 64 + LowestBit(levels_[level][index]);
+
+        clearBit(index);
+        --numFree_;
+
+        return index;
+    }
+
+    void BitmapAllocator::clearBit(uint32_t index)
+    {
+        for (auto& level : levels_) {
+            auto& word = level[index / 64];
+
+            word &= ~(uint64_t{ 1 } << (index % 64));
+
+            // parent only change when the word becomes full
+            if (word != 0)
+                break;
+
+            index /= 64;
+        }
+    }
+
+    void BitmapAllocator::free(uint32_t index)
+    {
+        if ((index >= capacity_) || isFree(index)) {
+            auto fmt = boost::format{ "BitmapAllocator::free, invalid or double free of slot %1%" } % index;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        setBit(index);
+        ++numFree_;
+    }
+
+    bool BitmapAllocator::isFree(uint32_t index) const
+    {
+        return (levels_[0][index / 64] & (uint64_t{ 1 } << (index % 64))) != 0;
+    }
+
+    void BitmapAllocator::setBit(uint32_t index)
+    {
+        for (auto& level : levels_) {
+            auto& word = level[index / 64];
+            bool wasEmpty = (word == 0);
+
+            word |= uint64_t{ 1 } << (index % 64);
+
+            // parent already knows this word has free slots
+            if (!wasEmpty)
+                break;
+
+            index /= 64;
+        }
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,56 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Takoyaki
+{
+    constexpr uint32_t BITMAP_INVALID = UINT32_MAX;
+
+    // Fixed capacity slot allocator, each level keep one bit per word of the level below
+    // set when that word still has a free slot, so allocate and free are O(log64 capacity)
+    class BitmapAllocator
+    {
+    public:
+        explicit BitmapAllocator(uint32_t capacity);
+
+        // lowest free slot, BITMAP_INVALID when full
+        uint32_t allocate();
+        void free(uint32_t index);
+
+        bool isFree(uint32_t index) const;
+        inline uint32_t getCapacity() const { return capacity_; }
+        inline uint32_t getNumFree() const { return numFree_; }
+
+    private:
+        void clearBit(uint32_t index);
+        void setBit(uint32_t index);
+
+    private:
+        // levels_[0] has one bit per slot, the last level is a single word
+        std::vector<std::vector<uint64_t>> levels_;
+        uint32_t capacity_;
+        uint32_t numFree_;
+    };
+}
+// namespace Takoyaki
@@ -0,0 +1,177 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "buddy_allocator.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        constexpr uint32_t LEAF_NONE = UINT32_MAX;
+        constexpr uint8_t ORDER_NONE = UINT8_MAX;
+
+        inline bool IsPowerOfTwo(uint64_t value)
+        {
+            return (value != 0) && ((value & (value - 1)) == 0);
+        }
+    }
+
+    BuddyAllocator::BuddyAllocator(uint64_t capacity, uint64_t minBlockSize)
+        : capacity_{ capacity }
+        , minBlockSize_{ minBlockSize }
+        , numFree_{ capacity }
+        , maxOrder_{ 0 }
+    {
+        if (!IsPowerOfTwo(capacity) || !IsPowerOfTwo(minBlockSize) || (capacity < minBlockSize) || (capacity / minBlockSize > UINT32_MAX)) {
+            auto fmt = boost::format{ "BuddyAllocator, capacity %1% and block size %2% must be powers of two with capacity the largest" } % capacity % minBlockSize;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        auto numLeaves = static_cast<uint32_t>(capacity / minBlockSize);
+
+        while ((1ULL << maxOrder_) < numLeaves)
+            ++maxOrder_;
+
+        next_.resize(numLeaves, LEAF_NONE);
+        prev_.resize(numLeaves, LEAF_NONE);
+        freeOrder_.resize(numLeaves, ORDER_NONE);
+        allocOrder_.resize(numLeaves, ORDER_NONE);
+        heads_.resize(maxOrder_ + 1, LEAF_NONE);
+
+        pushFree(0, maxOrder_);
+    }
+
+    uint64_t BuddyAllocator::allocate(uint64_t size)
+    {
+        if ((size == 0) || (size > capacity_))
+            return BUDDY_INVALID;
+
+        uint32_t order = 0;
+
+        while ((minBlockSize_ << order) < size)
+            ++order;
+
+        // smallest free block that fits
+        auto found = order;
+
+        while ((found <= maxOrder_) && (heads_[found] == LEAF_NONE))
+            ++found;
+
+        if (found > maxOrder_)
+            return BUDDY_INVALID;
+
+        auto leaf = heads_[found];
+
+        removeFree(leaf, found);
+
+        // split, keeping the lower half and releasing the upper one
+        while (found > order) {
+            --found;
+            pushFree(leaf + (1U << found), found);
+        }
+
+        allocOrder_[leaf] = static_cast<uint8_t>(order);
+        numFree_ -= minBlockSize_ << order;
+
+        return leaf * minBlockSize_;
+    }
+
+    void BuddyAllocator::free(uint64_t offset)
+    {
+        auto leaf = static_cast<uint32_t>(offset / minBlockSize_);
+
+        if ((offset % minBlockSize_ != 0) || (offset >= capacity_) || (allocOrder_[leaf] == ORDER_NONE)) {
+            auto fmt = boost::format{ "BuddyAllocator::free, no allocation at offset %1%" } % offset;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        uint32_t order = allocOrder_[leaf];
+
+        allocOrder_[leaf] = ORDER_NONE;
+        numFree_ += minBlockSize_ << order;
+
+        // merge with the buddy as long as it is free as a whole
+        while (order < maxOrder_) {
+            auto buddy = leaf ^ (1U << order);
+
+            if (freeOrder_[buddy] != order)
+                break;
+
+            removeFree(buddy, order);
+            leaf = (std::min)(leaf, buddy);
+            ++order;
+        }
+
+        pushFree(leaf, order);
+    }
+
+    uint64_t BuddyAllocator::getLargestFree() const
+    {
+        for (auto order = maxOrder_ + 1; order > 0; --order) {
+            if (heads_[order - 1] != LEAF_NONE)
+                return minBlockSize_ << (order - 1);
+        }
+
+        return 0;
+    }
+
+    uint32_t BuddyAllocator::getNumFreeBlocks() const
+    {
+        uint32_t res = 0;
+
+        for (auto head : heads_) {
+            for (auto leaf = head; leaf != LEAF_NONE; leaf = next_[leaf])
+                ++res;
+        }
+
+        return res;
+    }
+
+    void BuddyAllocator::pushFree(uint32_t leaf, uint32_t order)
+    {
+        auto head = heads_[order];
+
+        next_[leaf] = head;
+        prev_[leaf] = LEAF_NONE;
+
+        if (head != LEAF_NONE)
+            prev_[head] = leaf;
+
+        heads_[order] = leaf;
+        freeOrder_[leaf] = static_cast<uint8_t>(order);
+    }
+
+    void BuddyAllocator::removeFree(uint32_t leaf, uint32_t order)
+    {
+        if (prev_[leaf] != LEAF_NONE)
+            next_[prev_[leaf]] = next_[leaf];
+        else
+            heads_[order] = next_[leaf];
+
+        if (next_[leaf] != LEAF_NONE)
+            prev_[next_[leaf]] = prev_[leaf];
+
+        freeOrder_[leaf] = ORDER_NONE;
+    }
+}
+// namespace Takoyaki
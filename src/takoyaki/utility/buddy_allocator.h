@@ -0,0 +1,68 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Takoyaki
+{
+    constexpr uint64_t BUDDY_INVALID = UINT64_MAX;
+
+    // Power of two block allocator, a block is split in halves until it fits and merged back with
+    // its buddy when both are free. Free blocks of each order are kept in intrusive lists indexed by
+    // their first leaf so allocate and free are O(number of orders)
+    class BuddyAllocator
+    {
+    public:
+        // both must be powers of two, capacity at least minBlockSize
+        BuddyAllocator(uint64_t capacity, uint64_t minBlockSize);
+
+        // offset of a block of the next power of two of size, BUDDY_INVALID when there is none free
+        uint64_t allocate(uint64_t size);
+        void free(uint64_t offset);
+
+        inline uint64_t getCapacity() const { return capacity_; }
+        inline uint64_t getMinBlockSize() const { return minBlockSize_; }
+        inline uint64_t getNumFree() const { return numFree_; }
+        inline bool isEmpty() const { return numFree_ == capacity_; }
+        uint64_t getLargestFree() const;
+        uint32_t getNumFreeBlocks() const;
+
+    private:
+        void pushFree(uint32_t leaf, uint32_t order);
+        void removeFree(uint32_t leaf, uint32_t order);
+
+    private:
+        // per leaf, only meaningful for the first leaf of a block
+        std::vector<uint32_t> next_;
+        std::vector<uint32_t> prev_;
+        std::vector<uint8_t> freeOrder_;        // order of the free block starting here
+        std::vector<uint8_t> allocOrder_;       // order of the allocated block starting here
+
+        std::vector<uint32_t> heads_;           // first free block of each order
+        uint64_t capacity_;
+        uint64_t minBlockSize_;
+        uint64_t numFree_;
+        uint32_t maxOrder_;
+    };
+}
+// namespace Takoyaki
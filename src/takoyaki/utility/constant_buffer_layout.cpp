@@ -0,0 +1,73 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "constant_buffer_layout.h"
+
+namespace Takoyaki
+{
+    ConstantBufferLayout::ConstantBufferLayout(uint_fast32_t sizeByte)
+        : size_{ sizeByte }
+    {
+    }
+
+    FieldHandle ConstantBufferLayout::addField(const std::string& name, uint_fast32_t offset, uint_fast32_t sizeByte)
+    {
+        if ((sizeByte == 0) || (offset > size_) || (sizeByte > size_ - offset)) {
+            auto fmt = boost::format{ "ConstantBufferLayout::addField, %1% (offset %2%, size %3%) doesn't fit in %4% bytes" } % name % offset % sizeByte % size_;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        auto handle = static_cast<FieldHandle>(fields_.size());
+
+        if (!names_.insert(std::make_pair(name, handle)).second) {
+            auto fmt = boost::format{ "ConstantBufferLayout::addField, %1% is already defined" } % name;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        fields_.push_back(Field{ offset, sizeByte });
+
+        return handle;
+    }
+
+    FieldHandle ConstantBufferLayout::getField(const std::string& name) const
+    {
+        auto found = names_.find(name);
+
+        if (found == names_.end())
+            return FIELD_INVALID;
+
+        return found->second;
+    }
+
+    uint_fast32_t ConstantBufferLayout::getWriteOffset(FieldHandle handle, uint_fast32_t sizeByte) const
+    {
+        if (!isValid(handle) || (sizeByte > fields_[handle].size)) {
+            auto fmt = boost::format{ "ConstantBufferLayout, invalid field %1% or %2% bytes is larger than the variable" } % handle % sizeByte;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        return fields_[handle].offset;
+    }
+}
+// namespace Takoyaki
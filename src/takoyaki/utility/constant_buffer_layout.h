@@ -0,0 +1,65 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../public/definitions.h"
+
+namespace Takoyaki
+{
+    // Variables of a constant buffer, usually built once from shader reflection
+    // handles are indices so writes don't need any lookup, names are only used to resolve them
+    class ConstantBufferLayout
+    {
+    public:
+        explicit ConstantBufferLayout(uint_fast32_t sizeByte);
+
+        // throw when the variable doesn't fit in the buffer or the name is already used
+        FieldHandle addField(const std::string& name, uint_fast32_t offset, uint_fast32_t sizeByte);
+
+        // FIELD_INVALID when there is no variable with that name
+        FieldHandle getField(const std::string& name) const;
+
+        // offset to write sizeByte at, throw when the handle is invalid or the write is larger than the variable
+        uint_fast32_t getWriteOffset(FieldHandle handle, uint_fast32_t sizeByte) const;
+
+        inline uint_fast32_t getOffset(FieldHandle handle) const { return fields_[handle].offset; }
+        inline uint_fast32_t getFieldSize(FieldHandle handle) const { return fields_[handle].size; }
+        inline uint_fast32_t getNumFields() const { return static_cast<uint_fast32_t>(fields_.size()); }
+        inline uint_fast32_t getSize() const { return size_; }
+        inline bool isValid(FieldHandle handle) const { return handle < fields_.size(); }
+
+    private:
+        struct Field
+        {
+            uint_fast32_t offset;
+            uint_fast32_t size;
+        };
+
+        std::vector<Field> fields_;
+        std::unordered_map<std::string, FieldHandle> names_;
+        uint_fast32_t size_;
+    };
+}
+// namespace Takoyaki
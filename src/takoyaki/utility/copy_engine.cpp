@@ -0,0 +1,275 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "copy_engine.h"
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TAKOYAKI_TARGET_AVX
+#else
+#define TAKOYAKI_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+namespace Takoyaki
+{
+    namespace
+    {
+        // a chunk is worth handing to another thread above this
+        constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+        // below this, partial cache lines would defeat the streaming stores
+        constexpr size_t STREAM_THRESHOLD = 256;
+
+        // bytes must be a multiple of 16 and dst 16 bytes aligned
+        void StreamSSE2(uint8_t* dst, const uint8_t* src, size_t bytes)
+        {
+            auto d = reinterpret_cast<__m128i*>(dst);
+            auto s = reinterpret_cast<const __m128i*>(src);
+            auto count = bytes / 16;
+            size_t i = 0;
+
+            // one cache line per iteration so write-combining buffers are filled completely
+            for (; i + 4 <= count; i += 4) {
+                auto a = _mm_loadu_si128(s + i);
+                auto b = _mm_loadu_si128(s + i + 1);
+                auto c = _mm_loadu_si128(s + i + 2);
+                auto e = _mm_loadu_si128(s + i + 3);
+
+                _mm_stream_si128(d + i, a);
+                _mm_stream_si128(d + i + 1, b);
+                _mm_stream_si128(d + i + 2, c);
+                _mm_stream_si128(d + i + 3, e);
+            }
+
+            for (; i < count; ++i)
+                _mm_stream_si128(d + i, _mm_loadu_si128(s + i));
+        }
+
+        // bytes must be a multiple of 128 and dst 32 bytes aligned
+        TAKOYAKI_TARGET_AVX void StreamAVX(uint8_t* dst, const uint8_t* src, size_t bytes)
+        {
+            auto d = reinterpret_cast<__m256i*>(dst);
+            auto s = reinterpret_cast<const __m256i*>(src);
+
+            // two cache lines per iteration
+            for (size_t i = 0; i < bytes / 32; i += 4) {
+                auto a = _mm256_loadu_si256(s + i);
+                auto b = _mm256_loadu_si256(s + i + 1);
+                auto c = _mm256_loadu_si256(s + i + 2);
+                auto e = _mm256_loadu_si256(s + i + 3);
+
+                _mm256_stream_si256(d + i, a);
+                _mm256_stream_si256(d + i + 1, b);
+                _mm256_stream_si256(d + i + 2, c);
+                _mm256_stream_si256(d + i + 3, e);
+            }
+
+            // avoid the AVX to SSE transition penalty in the caller
+            _mm256_zeroupper();
+        }
+
+        bool HasAVX()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+
+            __cpuid(info, 1);
+
+            // the OS must save the ymm registers too
+            auto osxsave = (info[2] & (1 << 27)) != 0;
+            auto avx = (info[2] & (1 << 28)) != 0;
+
+            return osxsave && avx && ((_xgetbv(0) & 6) == 6);
+#else
+            // may run before the constructor that fills the cpu model
+            __builtin_cpu_init();
+
+            return __builtin_cpu_supports("avx") != 0;
+#endif
+        }
+
+        const bool hasAVX = HasAVX();
+
+        // regular and streaming stores to the same line are very slow, only the unaligned start and
+        // the last few bytes of a row are written normally
+        void StreamRow(uint8_t* dst, const uint8_t* src, size_t bytes)
+        {
+            if (bytes < STREAM_THRESHOLD) {
+                memcpy(dst, src, bytes);
+                return;
+            }
+
+            auto head = static_cast<size_t>((16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15);
+
+            memcpy(dst, src, head);
+            dst += head;
+            src += head;
+            bytes -= head;
+
+            // upload heaps and texture rows are at least 256 bytes aligned so this is the common case
+            if (hasAVX && ((reinterpret_cast<uintptr_t>(dst) & 31) == 0)) {
+                auto body = bytes & ~static_cast<size_t>(127);
+
+                StreamAVX(dst, src, body);
+                dst += body;
+                src += body;
+                bytes -= body;
+            }
+
+            auto body = bytes & ~static_cast<size_t>(15);
+
+            StreamSSE2(dst, src, body);
+            memcpy(dst + body, src + body, bytes - body);
+        }
+
+        struct Job
+        {
+            CopyRegion region;
+            uint32_t totalRows;
+            uint32_t rowsPerChunk;
+            uint32_t numChunks;
+            std::atomic<uint32_t> next;
+            std::atomic<uint32_t> done;
+
+            void run()
+            {
+                uint32_t chunks = 0;
+
+                for (auto chunk = next.fetch_add(1); chunk < numChunks; chunk = next.fetch_add(1)) {
+                    auto first = chunk * rowsPerChunk;
+
+                    StreamCopyRows(region, first, (std::min)(rowsPerChunk, totalRows - first));
+                    ++chunks;
+                }
+
+                // the streamed data of this thread must be visible before the caller hands it to the GPU
+                if (chunks > 0) {
+                    StreamFence();
+                    done.fetch_add(chunks, std::memory_order_release);
+                }
+            }
+        };
+    }
+
+    void StreamCopyRows(const CopyRegion& region, uint32_t firstRow, uint32_t count)
+    {
+        auto slice = firstRow / region.numRows;
+        auto row = firstRow % region.numRows;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            auto dst = region.dst + slice * region.dstSlicePitch + row * region.dstRowPitch;
+            auto src = region.src + slice * region.srcSlicePitch + row * region.srcRowPitch;
+
+            StreamRow(dst, src, region.rowSizeByte);
+
+            if (++row == region.numRows) {
+                row = 0;
+                ++slice;
+            }
+        }
+    }
+
+    void StreamFence()
+    {
+        _mm_sfence();
+    }
+
+    CopyEngine::CopyEngine() noexcept
+        : numHelpers_{ 0 }
+    {
+    }
+
+    void CopyEngine::initialize(DispatchFunc dispatch, uint32_t numHelpers)
+    {
+        dispatch_ = std::move(dispatch);
+        numHelpers_ = numHelpers;
+    }
+
+    void CopyEngine::copy(const CopyRegion& region)
+    {
+        auto totalRows = region.numRows * region.numSlices;
+
+        if (totalRows == 0 || region.rowSizeByte == 0)
+            return;
+
+        auto rowsPerChunk = static_cast<uint32_t>((std::max)(CHUNK_SIZE / region.rowSizeByte, static_cast<size_t>(1)));
+        auto numChunks = (totalRows + rowsPerChunk - 1) / rowsPerChunk;
+
+        if (numChunks == 1 || numHelpers_ == 0 || !dispatch_) {
+            StreamCopyRows(region, 0, totalRows);
+            StreamFence();
+            return;
+        }
+
+        // helpers starting after everything is taken return right away, they only hold the job alive
+        auto job = std::make_shared<Job>();
+
+        job->region = region;
+        job->totalRows = totalRows;
+        job->rowsPerChunk = rowsPerChunk;
+        job->numChunks = numChunks;
+        job->next = 0;
+        job->done = 0;
+
+        auto numHelpers = (std::min)(numHelpers_, numChunks - 1);
+
+        for (uint32_t i = 0; i < numHelpers; ++i)
+            dispatch_([job]() { job->run(); });
+
+        job->run();
+
+        // every chunk has been taken, the remaining ones are being copied
+        while (job->done.load(std::memory_order_acquire) != numChunks)
+            std::this_thread::yield();
+    }
+
+    void CopyEngine::copy(uint8_t* dst, const void* src, size_t sizeByte)
+    {
+        // a linear copy is a region of CHUNK_SIZE rows
+        auto data = static_cast<const uint8_t*>(src);
+        auto numRows = sizeByte / CHUNK_SIZE;
+        auto tail = numRows * CHUNK_SIZE;
+
+        if (numRows > 0) {
+            CopyRegion region;
+
+            region.dst = dst;
+            region.src = data;
+            region.dstRowPitch = CHUNK_SIZE;
+            region.dstSlicePitch = tail;
+            region.srcRowPitch = CHUNK_SIZE;
+            region.srcSlicePitch = tail;
+            region.rowSizeByte = CHUNK_SIZE;
+            region.numRows = static_cast<uint32_t>(numRows);
+            region.numSlices = 1;
+
+            copy(region);
+        }
+
+        if (tail < sizeByte) {
+            StreamRow(dst + tail, data + tail, sizeByte - tail);
+            StreamFence();
+        }
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,71 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Takoyaki
+{
+    // Rows of a subresource in two pitched layouts, rows are numbered across slices
+    struct CopyRegion
+    {
+        uint8_t* dst;
+        const uint8_t* src;
+        size_t dstRowPitch;
+        size_t dstSlicePitch;
+        size_t srcRowPitch;
+        size_t srcSlicePitch;
+        size_t rowSizeByte;
+        uint32_t numRows;       // per slice
+        uint32_t numSlices;
+    };
+
+    // Copies into write-combined upload memory, each row is written sequentially with non-temporal stores
+    // (AVX when the CPU has it, SSE2 otherwise) so the pitch conversion is done in the same pass
+    // Large copies are split in chunks of rows run by the thread pool, the caller takes chunks too and
+    // returns once all of them are done, so it never waits on a helper that has not started
+    class CopyEngine
+    {
+        CopyEngine(const CopyEngine&) = delete;
+        CopyEngine& operator=(const CopyEngine&) = delete;
+
+    public:
+        using DispatchFunc = std::function<void(std::function<void()>)>;
+
+        CopyEngine() noexcept;
+
+        // without it every copy runs on the calling thread
+        void initialize(DispatchFunc dispatch, uint32_t numHelpers);
+
+        void copy(const CopyRegion& region);
+        void copy(uint8_t* dst, const void* src, size_t sizeByte);
+
+    private:
+        DispatchFunc dispatch_;
+        uint32_t numHelpers_;
+    };
+
+    // rows [firstRow, firstRow + count) on the calling thread, end with a fence before handing the data to the GPU
+    void StreamCopyRows(const CopyRegion& region, uint32_t firstRow, uint32_t count);
+    void StreamFence();
+}
+// namespace Takoyaki
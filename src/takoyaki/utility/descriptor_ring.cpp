@@ -0,0 +1,97 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "descriptor_ring.h"
+
+namespace Takoyaki
+{
+    DescriptorRing::DescriptorRing(uint32_t capacity)
+        : firstTicket_{ 0 }
+        , capacity_{ capacity }
+        , head_{ 0 }
+        , tail_{ 0 }
+        , used_{ 0 }
+    {
+        if (capacity == 0)
+            throw std::runtime_error{ "DescriptorRing, capacity cannot be 0" };
+    }
+
+    uint32_t DescriptorRing::allocate(uint32_t count, uint64_t& ticket)
+    {
+        if ((count == 0) || (count > capacity_)) {
+            auto fmt = boost::format{ "DescriptorRing::allocate, count %1% must be between 1 and %2%" } % count % capacity_;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        // start over from the beginning when empty to get the most contiguous space
+        if (used_ == 0) {
+            head_ = 0;
+            tail_ = 0;
+        }
+
+        uint32_t offset = head_;
+        uint32_t size = count;
+
+        // not enough room before the end, skip the remaining slots
+        if (head_ + count > capacity_) {
+            offset = 0;
+            size += capacity_ - head_;
+        }
+
+        if (size > capacity_ - used_)
+            return RING_INVALID;
+
+        head_ = (offset + count) % capacity_;
+        used_ += size;
+        ticket = firstTicket_ + blocks_.size();
+        blocks_.push_back({ size, RING_PENDING });
+
+        return offset;
+    }
+
+    void DescriptorRing::setFence(uint64_t ticket, uint64_t fence)
+    {
+        if ((ticket < firstTicket_) || (ticket - firstTicket_ >= blocks_.size())) {
+            auto fmt = boost::format{ "DescriptorRing::setFence, invalid ticket %1%" } % ticket;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        blocks_[static_cast<size_t>(ticket - firstTicket_)].fence = fence;
+    }
+
+    void DescriptorRing::retire(uint64_t completedFence)
+    {
+        while (!blocks_.empty()) {
+            auto& block = blocks_.front();
+
+            if ((block.fence == RING_PENDING) || (block.fence > completedFence))
+                break;
+
+            tail_ = (tail_ + block.size) % capacity_;
+            used_ -= block.size;
+            blocks_.pop_front();
+            ++firstTicket_;
+        }
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,63 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+namespace Takoyaki
+{
+    constexpr uint32_t RING_INVALID = UINT32_MAX;
+    constexpr uint64_t RING_PENDING = UINT64_MAX;
+
+    // FIFO allocator of contiguous blocks for transient descriptors
+    // Blocks are never split by the wraparound, each one get a ticket which must be given a fence once
+    // the work using it has been submitted. Blocks are reclaimed in order once their fence completed,
+    // so a block still being recorded holds back everything allocated after it
+    class DescriptorRing
+    {
+    public:
+        explicit DescriptorRing(uint32_t capacity);
+
+        // offset of the block, RING_INVALID when there isn't enough contiguous space
+        uint32_t allocate(uint32_t count, uint64_t& ticket);
+        void setFence(uint64_t ticket, uint64_t fence);
+        void retire(uint64_t completedFence);
+
+        inline uint32_t getCapacity() const { return capacity_; }
+        inline uint32_t getNumFree() const { return capacity_ - used_; }
+
+    private:
+        struct Block
+        {
+            uint32_t size;          // include the slots skipped on wraparound
+            uint64_t fence;
+        };
+
+        std::deque<Block> blocks_;
+        uint64_t firstTicket_;
+        uint32_t capacity_;
+        uint32_t head_;
+        uint32_t tail_;
+        uint32_t used_;
+    };
+}
+// namespace Takoyaki
@@ -0,0 +1,140 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "descriptor_table_cache.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        size_t HashBinding(const std::vector<uint64_t>& binding)
+        {
+            uint64_t res = 14695981039346656037ULL;
+
+            for (auto word : binding) {
+                res ^= word;
+                res *= 1099511628211ULL;
+            }
+
+            return static_cast<size_t>(res ^ (res >> 32));
+        }
+    }
+
+    DescriptorTableCache::DescriptorTableCache(uint32_t capacity)
+        : ranges_{ capacity }
+        , completedFence_{ 0 }
+        , nextId_{ 0 }
+    {
+    }
+
+    uint32_t DescriptorTableCache::find(const std::vector<uint64_t>& binding, uint64_t& use)
+    {
+        auto found = lookup_.equal_range(HashBinding(binding));
+
+        for (auto it = found.first; it != found.second; ++it) {
+            auto& table = tables_.find(it->second)->second;
+
+            if (table.binding == binding) {
+                lru_.splice(lru_.begin(), lru_, table.lru);
+                ++table.uses;
+                use = it->second;
+
+                return table.offset;
+            }
+        }
+
+        return TABLE_CACHE_MISS;
+    }
+
+    uint32_t DescriptorTableCache::insert(const std::vector<uint64_t>& binding, uint32_t count, uint64_t& use)
+    {
+        auto offset = ranges_.allocate(count);
+
+        while (offset == RANGE_INVALID) {
+            if (!evictOne())
+                return TABLE_CACHE_MISS;
+
+            offset = ranges_.allocate(count);
+        }
+
+        auto id = nextId_++;
+        auto& table = tables_[id];
+
+        lru_.push_front(id);
+        table.binding = binding;
+        table.lru = lru_.begin();
+        table.fence = 0;
+        table.hash = HashBinding(binding);
+        table.offset = offset;
+        table.count = count;
+        table.uses = 1;
+        lookup_.insert(std::make_pair(table.hash, id));
+        use = id;
+
+        return offset;
+    }
+
+    void DescriptorTableCache::setFence(uint64_t use, uint64_t fence)
+    {
+        auto found = tables_.find(use);
+
+        if ((found == tables_.end()) || (found->second.uses == 0)) {
+            auto fmt = boost::format{ "DescriptorTableCache::setFence, table %1% has no pending use" } % use;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        auto& table = found->second;
+
+        --table.uses;
+        table.fence = (std::max)(table.fence, fence);
+    }
+
+    bool DescriptorTableCache::evictOne()
+    {
+        // recently used tables are the ones in flight so the scan usually stops early
+        for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+            auto found = tables_.find(*it);
+            auto& table = found->second;
+
+            if ((table.uses > 0) || (table.fence > completedFence_))
+                continue;
+
+            auto range = lookup_.equal_range(table.hash);
+
+            for (auto lookupIt = range.first; lookupIt != range.second; ++lookupIt) {
+                if (lookupIt->second == found->first) {
+                    lookup_.erase(lookupIt);
+                    break;
+                }
+            }
+
+            ranges_.free(table.offset, table.count);
+            lru_.erase(table.lru);
+            tables_.erase(found);
+
+            return true;
+        }
+
+        return false;
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,82 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "range_allocator.h"
+
+namespace Takoyaki
+{
+    constexpr uint32_t TABLE_CACHE_MISS = UINT32_MAX;
+
+    // Descriptor tables already written in the shader visible heap, keyed by the binding set that produced them
+    // A binding set is any sequence of words identifying the table content, only the hash is probed
+    // and the words are compared on collision
+    // Each find or insert is a use that must be given the fence of its submission with setFence,
+    // tables are only evicted in LRU order once all their uses are done and their last fence completed
+    class DescriptorTableCache
+    {
+    public:
+        explicit DescriptorTableCache(uint32_t capacity);
+
+        // offset of the table, TABLE_CACHE_MISS if there is none for this binding
+        uint32_t find(const std::vector<uint64_t>& binding, uint64_t& use);
+
+        // offset of a new table to write, TABLE_CACHE_MISS if every table that could be evicted is still in flight
+        uint32_t insert(const std::vector<uint64_t>& binding, uint32_t count, uint64_t& use);
+
+        // fence 0 for uses that will never be submitted
+        void setFence(uint64_t use, uint64_t fence);
+        inline void retire(uint64_t completedFence) { completedFence_ = completedFence; }
+
+        inline uint32_t getCapacity() const { return ranges_.getCapacity(); }
+        inline uint32_t getNumUsed() const { return ranges_.getCapacity() - ranges_.getNumFree(); }
+        inline uint32_t getNumTables() const { return static_cast<uint32_t>(tables_.size()); }
+        inline const RangeAllocator& getRanges() const { return ranges_; }
+
+    private:
+        struct Table
+        {
+            std::vector<uint64_t> binding;
+            std::list<uint64_t>::iterator lru;
+            uint64_t fence;
+            size_t hash;
+            uint32_t offset;
+            uint32_t count;
+            uint32_t uses;      // recorded but not given a fence yet
+        };
+
+        bool evictOne();
+
+    private:
+        RangeAllocator ranges_;
+        std::unordered_map<uint64_t, Table> tables_;        // by id
+        std::unordered_multimap<size_t, uint64_t> lookup_;  // binding hash -> id
+        std::list<uint64_t> lru_;                           // ids, most recent first
+        uint64_t completedFence_;
+        uint64_t nextId_;
+    };
+}
+// namespace Takoyaki
@@ -0,0 +1,61 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "fenced_index_allocator.h"
+
+namespace Takoyaki
+{
+    FencedIndexAllocator::FencedIndexAllocator(uint32_t capacity)
+        : indices_{ capacity }
+        , released_(capacity, false)
+    {
+    }
+
+    uint32_t FencedIndexAllocator::allocate()
+    {
+        return indices_.allocate();
+    }
+
+    void FencedIndexAllocator::release(uint32_t index, uint64_t fence)
+    {
+        // indices stay allocated until retired, a second release would free them twice
+        if ((index >= indices_.getCapacity()) || indices_.isFree(index) || released_[index]) {
+            auto fmt = boost::format{ "FencedIndexAllocator::release, index %1% is not allocated or already released" } % index;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        released_[index] = true;
+        pending_.push_back({ fence, index });
+    }
+
+    void FencedIndexAllocator::retire(uint64_t completedFence)
+    {
+        while (!pending_.empty() && (pending_.front().first <= completedFence)) {
+            auto index = pending_.front().second;
+
+            released_[index] = false;
+            indices_.free(index);
+            pending_.pop_front();
+        }
+    }
+}
+// namespace Takoyaki
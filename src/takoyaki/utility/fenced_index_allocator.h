@@ -0,0 +1,56 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "bitmap_allocator.h"
+
+namespace Takoyaki
+{
+    // Index allocator for descriptors the GPU may still read after release
+    // released indices are only reused once the fence given at release has completed, fences are
+    // expected to be non-decreasing so pending indices are retired in order
+    class FencedIndexAllocator
+    {
+    public:
+        explicit FencedIndexAllocator(uint32_t capacity);
+
+        // BITMAP_INVALID when every index is used or waiting for its fence
+        uint32_t allocate();
+
+        // throw if the index is not allocated or already released
+        void release(uint32_t index, uint64_t fence);
+        void retire(uint64_t completedFence);
+
+        inline uint32_t getCapacity() const { return indices_.getCapacity(); }
+        inline uint32_t getNumUsed() const { return indices_.getCapacity() - indices_.getNumFree(); }
+        inline uint32_t getNumPending() const { return static_cast<uint32_t>(pending_.size()); }
+
+    private:
+        BitmapAllocator indices_;
+        std::deque<std::pair<uint64_t, uint32_t>> pending_;     // fence, index
+        std::vector<bool> released_;                            // index is in pending_
+    };
+}
+// namespace Takoyaki
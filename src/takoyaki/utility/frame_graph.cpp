@@ -0,0 +1,344 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "frame_graph.h"
+
+namespace Takoyaki
+{
+    FrameGraph::FrameGraph() noexcept
+        : numPhysical_{ 0 }
+    {
+    }
+
+    uint32_t FrameGraph::addPass()
+    {
+        Pass pass;
+
+        pass.position = FRAME_GRAPH_INVALID;
+        pass.alive = false;
+        passes_.push_back(std::move(pass));
+
+        return static_cast<uint32_t>(passes_.size() - 1);
+    }
+
+    uint32_t FrameGraph::addResource(uint32_t initialState, uint64_t poolKey, bool transient)
+    {
+        Resource res;
+
+        res.poolKey = poolKey;
+        res.initialState = initialState;
+        res.physical = FRAME_GRAPH_INVALID;
+        res.firstUse = FRAME_GRAPH_INVALID;
+        res.lastUse = 0;
+        res.transient = transient;
+        res.output = false;
+        resources_.push_back(res);
+
+        return static_cast<uint32_t>(resources_.size() - 1);
+    }
+
+    void FrameGraph::assignPhysical()
+    {
+        std::vector<uint32_t> transients;
+
+        for (auto& res : resources_) {
+            res.physical = FRAME_GRAPH_INVALID;
+            res.firstUse = FRAME_GRAPH_INVALID;
+            res.lastUse = 0;
+        }
+
+        for (auto& pass : passes_) {
+            if (!pass.alive)
+                continue;
+
+            for (auto& access : pass.accesses) {
+                auto& res = resources_[access.resource];
+
+                res.firstUse = (std::min)(res.firstUse, pass.position);
+                res.lastUse = (std::max)(res.lastUse, pass.position);
+            }
+        }
+
+        for (uint32_t i = 0; i < resources_.size(); ++i) {
+            auto& res = resources_[i];
+
+            if (!res.transient || (res.firstUse == FRAME_GRAPH_INVALID))
+                continue;
+
+            // outputs must survive until the end of the frame
+            if (res.output)
+                res.lastUse = FRAME_GRAPH_INVALID;
+
+            transients.push_back(i);
+        }
+
+        std::sort(transients.begin(), transients.end(), [this](uint32_t lhs, uint32_t rhs)
+        {
+            return resources_[lhs].firstUse < resources_[rhs].firstUse;
+        });
+
+        // key, last use
+        std::vector<std::pair<uint64_t, uint32_t>> slots;
+
+        for (auto index : transients) {
+            auto& res = resources_[index];
+            uint32_t found = FRAME_GRAPH_INVALID;
+
+            for (uint32_t slot = 0; slot < slots.size(); ++slot) {
+                if ((slots[slot].first == res.poolKey) && (slots[slot].second < res.firstUse)) {
+                    found = slot;
+                    break;
+                }
+            }
+
+            if (found == FRAME_GRAPH_INVALID) {
+                found = static_cast<uint32_t>(slots.size());
+                slots.push_back(std::make_pair(res.poolKey, res.lastUse));
+            } else {
+                slots[found].second = res.lastUse;
+            }
+
+            res.physical = found;
+        }
+
+        numPhysical_ = static_cast<uint32_t>(slots.size());
+    }
+
+    void FrameGraph::buildDependencies()
+    {
+        std::vector<uint32_t> lastWriter(resources_.size(), FRAME_GRAPH_INVALID);
+        std::vector<std::vector<uint32_t>> readers(resources_.size());
+
+        for (uint32_t index = 0; index < passes_.size(); ++index) {
+            auto& pass = passes_[index];
+
+            pass.dependencies.clear();
+            pass.producers.clear();
+
+            // reads first so a read-modify-write doesn't depend on itself
+            for (auto& access : pass.accesses) {
+                if (access.write)
+                    continue;
+
+                auto writer = lastWriter[access.resource];
+
+                if ((writer != FRAME_GRAPH_INVALID) && (writer != index)) {
+                    pass.dependencies.push_back(writer);
+                    pass.producers.push_back(writer);
+                }
+
+                readers[access.resource].push_back(index);
+            }
+
+            for (auto& access : pass.accesses) {
+                if (!access.write)
+                    continue;
+
+                auto writer = lastWriter[access.resource];
+
+                // write after write, the previous content may be loaded
+                if ((writer != FRAME_GRAPH_INVALID) && (writer != index)) {
+                    pass.dependencies.push_back(writer);
+                    pass.producers.push_back(writer);
+                }
+
+                // write after read only constrain the order
+                for (auto reader : readers[access.resource]) {
+                    if (reader != index)
+                        pass.dependencies.push_back(reader);
+                }
+
+                lastWriter[access.resource] = index;
+                readers[access.resource].clear();
+            }
+
+            for (auto list : { &pass.dependencies, &pass.producers }) {
+                std::sort(list->begin(), list->end());
+                list->erase(std::unique(list->begin(), list->end()), list->end());
+            }
+        }
+    }
+
+    void FrameGraph::clear()
+    {
+        passes_.clear();
+        resources_.clear();
+        order_.clear();
+        numPhysical_ = 0;
+    }
+
+    void FrameGraph::compile()
+    {
+        buildDependencies();
+        cull();
+        schedule();
+        assignPhysical();
+        computeTransitions();
+    }
+
+    void FrameGraph::computeTransitions()
+    {
+        // transients are tracked per slot since resources sharing a slot are the same texture
+        std::vector<uint32_t> slotStates(numPhysical_, FRAME_GRAPH_INVALID);
+        std::vector<uint32_t> states(resources_.size());
+
+        for (uint32_t i = 0; i < resources_.size(); ++i)
+            states[i] = resources_[i].initialState;
+
+        for (auto& pass : passes_)
+            pass.transitions.clear();
+
+        for (auto index : order_) {
+            auto& pass = passes_[index];
+
+            for (auto& access : pass.accesses) {
+                auto& res = resources_[access.resource];
+                uint32_t* current = &states[access.resource];
+
+                if (res.physical != FRAME_GRAPH_INVALID) {
+                    current = &slotStates[res.physical];
+
+                    if (*current == FRAME_GRAPH_INVALID)
+                        *current = res.initialState;
+                }
+
+                if (*current == access.state)
+                    continue;
+
+                auto found = std::find_if(pass.transitions.begin(), pass.transitions.end(), [&access](const Transition& transition) { return transition.resource == access.resource; });
+
+                if (found != pass.transitions.end()) {
+                    auto fmt = boost::format{ "FrameGraph::compile, resource %1% is used with different states in the same pass" } % access.resource;
+
+                    throw std::runtime_error{ boost::str(fmt) };
+                }
+
+                pass.transitions.push_back(Transition{ access.resource, *current, access.state });
+                *current = access.state;
+            }
+        }
+    }
+
+    void FrameGraph::cull()
+    {
+        std::vector<uint32_t> stack;
+
+        for (uint32_t index = 0; index < passes_.size(); ++index) {
+            auto& pass = passes_[index];
+
+            pass.alive = false;
+
+            for (auto& access : pass.accesses) {
+                auto& res = resources_[access.resource];
+
+                if (access.write && (!res.transient || res.output)) {
+                    stack.push_back(index);
+                    break;
+                }
+            }
+        }
+
+        // everything a root pass transitively consume is alive
+        while (!stack.empty()) {
+            auto index = stack.back();
+
+            stack.pop_back();
+
+            if (passes_[index].alive)
+                continue;
+
+            passes_[index].alive = true;
+
+            for (auto producer : passes_[index].producers) {
+                if (!passes_[producer].alive)
+                    stack.push_back(producer);
+            }
+        }
+    }
+
+    void FrameGraph::markOutput(uint32_t resource)
+    {
+        resources_[resource].output = true;
+    }
+
+    void FrameGraph::read(uint32_t pass, uint32_t resource, uint32_t state)
+    {
+        passes_[pass].accesses.push_back(Access{ resource, state, false });
+    }
+
+    void FrameGraph::schedule()
+    {
+        // a pass is ready once all its dependencies are scheduled, among the ready ones pick the
+        // one whose inputs have been produced the earliest so dependent passes end up further apart
+        using ReadyPass = std::pair<uint32_t, uint32_t>; // earliest position, index
+        std::priority_queue<ReadyPass, std::vector<ReadyPass>, std::greater<ReadyPass>> ready;
+        std::vector<uint32_t> remaining(passes_.size(), 0);
+        std::vector<std::vector<uint32_t>> dependents(passes_.size());
+
+        order_.clear();
+
+        for (uint32_t index = 0; index < passes_.size(); ++index) {
+            auto& pass = passes_[index];
+
+            pass.position = FRAME_GRAPH_INVALID;
+
+            if (!pass.alive)
+                continue;
+
+            for (auto dep : pass.dependencies) {
+                if (passes_[dep].alive) {
+                    ++remaining[index];
+                    dependents[dep].push_back(index);
+                }
+            }
+
+            if (remaining[index] == 0)
+                ready.push(std::make_pair(0, index));
+        }
+
+        while (!ready.empty()) {
+            auto index = ready.top().second;
+
+            ready.pop();
+            passes_[index].position = static_cast<uint32_t>(order_.size());
+            order_.push_back(index);
+
+            for (auto dependent : dependents[index]) {
+                if (--remaining[dependent] == 0) {
+                    uint32_t earliest = 0;
+
+                    for (auto dep : passes_[dependent].dependencies) {
+                        if (passes_[dep].alive)
+                            earliest = (std::max)(earliest, passes_[dep].position + 1);
+                    }
+
+                    ready.push(std::make_pair(earliest, dependent));
+                }
+            }
+        }
+    }
+
+    void FrameGraph::write(uint32_t pass, uint32_t resource, uint32_t state)
+    {
+        passes_[pass].accesses.push_back(Access{ resource, state, true });
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,113 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Takoyaki
+{
+    constexpr uint32_t FRAME_GRAPH_INVALID = UINT32_MAX;
+
+    // Backend independent part of the render graph, only deals with indices and opaque states
+    // Passes and accesses are declared in submission order, compile() then:
+    // - cull passes which do not contribute to an imported or output resource
+    // - order the remaining passes, keeping producers and consumers apart when possible
+    // - assign transient resources to physical slots, resources sharing a slot use the same texture in turn
+    // - compute the state transitions required before each pass
+    class FrameGraph
+    {
+    public:
+        struct Transition
+        {
+            uint32_t resource;
+            uint32_t before;
+            uint32_t after;
+        };
+
+        FrameGraph() noexcept;
+
+        void clear();
+
+        // transient resources with the same pool key and disjoint lifetimes can share a slot
+        uint32_t addResource(uint32_t initialState, uint64_t poolKey, bool transient);
+        uint32_t addPass();
+
+        // outputs and non transient resources are kept alive whatever the passes reading them
+        void markOutput(uint32_t resource);
+
+        void read(uint32_t pass, uint32_t resource, uint32_t state);
+        void write(uint32_t pass, uint32_t resource, uint32_t state);
+
+        void compile();
+
+        // valid after compile
+        inline const std::vector<uint32_t>& getOrder() const { return order_; }
+        inline bool isCulled(uint32_t pass) const { return !passes_[pass].alive; }
+        inline const std::vector<Transition>& getTransitions(uint32_t pass) const { return passes_[pass].transitions; }
+        inline uint32_t getPhysical(uint32_t resource) const { return resources_[resource].physical; }
+        inline uint32_t getNumPhysical() const { return numPhysical_; }
+        inline uint32_t getNumPasses() const { return static_cast<uint32_t>(passes_.size()); }
+        inline uint32_t getNumResources() const { return static_cast<uint32_t>(resources_.size()); }
+
+    private:
+        struct Access
+        {
+            uint32_t resource;
+            uint32_t state;
+            bool write;
+        };
+
+        struct Pass
+        {
+            std::vector<Access> accesses;
+            std::vector<uint32_t> dependencies;   // everything that must run before
+            std::vector<uint32_t> producers;      // passes whose output is consumed, used for culling
+            std::vector<Transition> transitions;
+            uint32_t position;
+            bool alive;
+        };
+
+        struct Resource
+        {
+            uint64_t poolKey;
+            uint32_t initialState;
+            uint32_t physical;
+            uint32_t firstUse;
+            uint32_t lastUse;
+            bool transient;
+            bool output;
+        };
+
+        void buildDependencies();
+        void cull();
+        void schedule();
+        void assignPhysical();
+        void computeTransitions();
+
+    private:
+        std::vector<Pass> passes_;
+        std::vector<Resource> resources_;
+        std::vector<uint32_t> order_;
+        uint32_t numPhysical_;
+    };
+}
+// namespace Takoyaki
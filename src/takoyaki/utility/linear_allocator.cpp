@@ -0,0 +1,50 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "linear_allocator.h"
+
+namespace Takoyaki
+{
+    LinearAllocator::LinearAllocator(uint64_t capacity, uint64_t alignment)
+        : offset_{ 0 }
+        , capacity_{ capacity }
+        , alignment_{ alignment }
+    {
+        if ((alignment == 0) || ((alignment & (alignment - 1)) != 0)) {
+            auto fmt = boost::format{ "LinearAllocator, alignment %1% must be a power of two" } % alignment;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+    }
+
+    uint64_t LinearAllocator::allocate(uint64_t size)
+    {
+        // sizes are rounded so that every offset stays aligned without a CAS loop
+        auto aligned = (size + alignment_ - 1) & ~(alignment_ - 1);
+        auto offset = offset_.fetch_add(aligned, std::memory_order_relaxed);
+
+        if ((aligned == 0) || (offset + aligned > capacity_))
+            return LINEAR_INVALID;
+
+        return offset;
+    }
+}
+// namespace Takoyaki
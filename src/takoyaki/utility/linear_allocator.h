@@ -0,0 +1,54 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace Takoyaki
+{
+    constexpr uint64_t LINEAR_INVALID = UINT64_MAX;
+
+    // Lock-free bump allocator over a fixed size page, alignment must be a power of two
+    // once full every allocation fails until reset, which must not overlap with allocations
+    class LinearAllocator
+    {
+        LinearAllocator(const LinearAllocator&) = delete;
+        LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+    public:
+        LinearAllocator(uint64_t capacity, uint64_t alignment);
+
+        // offset of the block, LINEAR_INVALID when the page is full
+        uint64_t allocate(uint64_t size);
+        inline void reset() { offset_.store(0, std::memory_order_relaxed); }
+
+        inline uint64_t getCapacity() const { return capacity_; }
+        inline uint64_t getNumUsed() const { return (std::min)(offset_.load(std::memory_order_relaxed), capacity_); }
+
+    private:
+        std::atomic<uint64_t> offset_;
+        uint64_t capacity_;
+        uint64_t alignment_;
+    };
+}
+// namespace Takoyaki
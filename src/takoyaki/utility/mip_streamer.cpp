@@ -0,0 +1,124 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "mip_streamer.h"
+
+namespace Takoyaki
+{
+    MipStreamer::MipStreamer(uint64_t budget)
+        : budget_{ budget }
+    {
+    }
+
+    void MipStreamer::add(uint32_t id, const std::vector<uint64_t>& mipSizes, uint32_t residentMip)
+    {
+        if (residentMip > mipSizes.size()) {
+            auto fmt = boost::format{ "MipStreamer::add, resident mip %1% is past the %2% mips of texture %3%" } % residentMip % mipSizes.size() % id;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        // nothing left to stream
+        if (residentMip == 0)
+            return;
+
+        entries_[id] = Entry{ mipSizes, residentMip, false };
+    }
+
+    void MipStreamer::remove(uint32_t id)
+    {
+        entries_.erase(id);
+    }
+
+    void MipStreamer::schedule(std::vector<Request>& requests)
+    {
+        candidates_.clear();
+
+        for (auto& pair : entries_) {
+            auto& entry = pair.second;
+
+            if (!entry.inFlight) {
+                auto mip = entry.residentMip - 1;
+
+                candidates_.push_back({ pair.first, mip, entry.mipSizes[mip] });
+            }
+        }
+
+        // ids break ties so the order doesn't depend on the hash map
+        std::sort(candidates_.begin(), candidates_.end(), [](const Request& a, const Request& b)
+        {
+            return (a.sizeByte < b.sizeByte) || ((a.sizeByte == b.sizeByte) && (a.id < b.id));
+        });
+
+        uint64_t started = 0;
+
+        for (auto& candidate : candidates_) {
+            if ((started > 0) && (started + candidate.sizeByte > budget_))
+                break;
+
+            started += candidate.sizeByte;
+            entries_[candidate.id].inFlight = true;
+            requests.push_back(candidate);
+        }
+    }
+
+    uint32_t MipStreamer::onLoaded(uint32_t id, uint32_t mip)
+    {
+        auto found = entries_.find(id);
+
+        if (found == entries_.end())
+            return MIP_INVALID;
+
+        auto& entry = found->second;
+
+        if (!entry.inFlight || (mip + 1 != entry.residentMip)) {
+            auto fmt = boost::format{ "MipStreamer::onLoaded, mip %1% of texture %2% was not requested" } % mip % id;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        entry.residentMip = mip;
+        entry.inFlight = false;
+
+        if (mip == 0)
+            entries_.erase(found);
+
+        return mip;
+    }
+
+    uint32_t MipStreamer::getTailStart(const std::vector<uint64_t>& mipSizes, uint64_t tailSize)
+    {
+        auto res = static_cast<uint32_t>(mipSizes.size());
+        uint64_t total = 0;
+
+        while (res > 0) {
+            total += mipSizes[res - 1];
+
+            // the smallest mip is always part of the tail
+            if ((total > tailSize) && (res < mipSizes.size()))
+                break;
+
+            --res;
+        }
+
+        return res;
+    }
+} // namespace Takoyaki
\ No newline at end of file
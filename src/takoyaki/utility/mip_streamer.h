@@ -0,0 +1,77 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Takoyaki
+{
+    constexpr uint32_t MIP_INVALID = UINT32_MAX;
+
+    // Progressive residency of mip chains, mip 0 being the largest
+    // A texture starts with its tail resident, then the next larger mip is requested one at a time so the
+    // resident mips are always a complete chain. The smallest requests across all textures go first so
+    // every texture gains resolution at the same pace, at most budget bytes are started per schedule
+    // Not thread-safe
+    class MipStreamer
+    {
+    public:
+        struct Request
+        {
+            uint32_t id;
+            uint32_t mip;
+            uint64_t sizeByte;
+        };
+
+        explicit MipStreamer(uint64_t budget);
+
+        // mipSizes[i] is the upload size of mip i, mips from residentMip are already resident
+        void add(uint32_t id, const std::vector<uint64_t>& mipSizes, uint32_t residentMip);
+        void remove(uint32_t id);
+
+        // the first request is always taken even when larger than the budget so large mips still load
+        void schedule(std::vector<Request>& requests);
+
+        // the copy of a requested mip is done, return the new resident mip or MIP_INVALID if the texture was removed
+        // textures are forgotten once complete
+        uint32_t onLoaded(uint32_t id, uint32_t mip);
+
+        inline bool isStreaming(uint32_t id) const { return entries_.find(id) != entries_.end(); }
+        inline size_t getNumStreaming() const { return entries_.size(); }
+
+        // first mip of the tail, the smallest mips that fit in tailSize together, at least the last one
+        static uint32_t getTailStart(const std::vector<uint64_t>& mipSizes, uint64_t tailSize);
+
+    private:
+        struct Entry
+        {
+            std::vector<uint64_t> mipSizes;
+            uint32_t residentMip;
+            bool inFlight;
+        };
+
+        std::unordered_map<uint32_t, Entry> entries_;
+        std::vector<Request> candidates_;
+        uint64_t budget_;
+    };
+} // namespace Takoyaki
\ No newline at end of file
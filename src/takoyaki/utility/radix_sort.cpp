@@ -0,0 +1,250 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "radix_sort.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        constexpr uint_fast32_t RADIX_BITS = 8;
+        constexpr uint_fast32_t RADIX_BUCKETS = 1 << RADIX_BITS;
+        constexpr uint_fast32_t RADIX_PASSES = 64 / RADIX_BITS;
+
+        // below this the dispatch and the per chunk histograms cost more than they save
+        constexpr size_t PARALLEL_THRESHOLD = 64 * 1024;
+        constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+        using Histogram = std::array<size_t, RADIX_BUCKETS>;
+
+        inline uint_fast32_t Digit(uint64_t key, uint_fast32_t pass)
+        {
+            return static_cast<uint_fast32_t>((key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1));
+        }
+
+        void SerialSort(SortItem* items, SortItem* scratch, size_t count)
+        {
+            // all histograms are built in one read of the data
+            std::array<Histogram, RADIX_PASSES> histograms = {};
+
+            for (size_t i = 0; i < count; ++i) {
+                auto key = items[i].key;
+
+                for (uint_fast32_t pass = 0; pass < RADIX_PASSES; ++pass)
+                    ++histograms[pass][Digit(key, pass)];
+            }
+
+            auto src = items;
+            auto dst = scratch;
+
+            for (uint_fast32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+                auto& histogram = histograms[pass];
+
+                // every key land in the same bucket, order is unchanged
+                if (histogram[Digit(src[0].key, pass)] == count)
+                    continue;
+
+                size_t offset = 0;
+
+                for (auto& bucket : histogram) {
+                    auto size = bucket;
+
+                    bucket = offset;
+                    offset += size;
+                }
+
+                for (size_t i = 0; i < count; ++i)
+                    dst[histogram[Digit(src[i].key, pass)]++] = src[i];
+
+                std::swap(src, dst);
+            }
+
+            if (src != items)
+                std::copy(src, src + count, items);
+        }
+
+        enum class EPhase
+        {
+            COUNT_ALL,      // histograms of every pass, the data has not moved yet
+            COUNT,
+            SCATTER
+        };
+
+        struct Job
+        {
+            const SortItem* src;
+            SortItem* dst;
+            size_t count;
+            uint32_t numChunks;
+            EPhase phase;
+            uint_fast32_t pass;
+
+            // per chunk, the scatter phase turns the histogram of the pass into write offsets
+            std::vector<std::array<Histogram, RADIX_PASSES>> histograms;
+            std::atomic<uint32_t> next;
+            std::atomic<uint32_t> done;
+
+            void runChunk(uint32_t chunk)
+            {
+                auto first = chunk * CHUNK_SIZE;
+                auto last = (std::min)(first + CHUNK_SIZE, count);
+                auto& chunkHistograms = histograms[chunk];
+
+                switch (phase) {
+                    case EPhase::COUNT_ALL:
+                        for (auto i = first; i < last; ++i) {
+                            for (uint_fast32_t p = 0; p < RADIX_PASSES; ++p)
+                                ++chunkHistograms[p][Digit(src[i].key, p)];
+                        }
+                        break;
+
+                    case EPhase::COUNT:
+                    {
+                        auto& histogram = chunkHistograms[pass];
+
+                        histogram.fill(0);
+
+                        for (auto i = first; i < last; ++i)
+                            ++histogram[Digit(src[i].key, pass)];
+                    }
+                    break;
+
+                    case EPhase::SCATTER:
+                    {
+                        auto& offsets = chunkHistograms[pass];
+
+                        for (auto i = first; i < last; ++i)
+                            dst[offsets[Digit(src[i].key, pass)]++] = src[i];
+                    }
+                    break;
+                }
+            }
+
+            // a helper starting late can run chunks of a later phase, the phase is published before next is reset
+            void run()
+            {
+                for (auto chunk = next.fetch_add(1, std::memory_order_acquire); chunk < numChunks; chunk = next.fetch_add(1, std::memory_order_acquire)) {
+                    runChunk(chunk);
+                    done.fetch_add(1, std::memory_order_release);
+                }
+            }
+        };
+    }
+
+    void RadixSort(SortItem* items, SortItem* scratch, size_t count)
+    {
+        if (count < 2)
+            return;
+
+        SerialSort(items, scratch, count);
+    }
+
+    RadixSorter::RadixSorter() noexcept
+        : numHelpers_{ 0 }
+    {
+    }
+
+    void RadixSorter::initialize(DispatchFunc dispatch, uint32_t numHelpers)
+    {
+        dispatch_ = std::move(dispatch);
+        numHelpers_ = numHelpers;
+    }
+
+    void RadixSorter::sort(SortItem* items, SortItem* scratch, size_t count)
+    {
+        if (count < PARALLEL_THRESHOLD || numHelpers_ == 0 || !dispatch_) {
+            RadixSort(items, scratch, count);
+            return;
+        }
+
+        // helpers starting after everything is taken return right away, they only hold the job alive
+        auto job = std::make_shared<Job>();
+        auto numChunks = static_cast<uint32_t>((count + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        auto numHelpers = (std::min)(numHelpers_, numChunks - 1);
+
+        job->count = count;
+        job->numChunks = numChunks;
+        job->histograms.resize(numChunks);
+        job->next = numChunks;
+        job->done = 0;
+
+        auto runPhase = [&](EPhase phase, const SortItem* src, SortItem* dst, uint_fast32_t pass)
+        {
+            job->src = src;
+            job->dst = dst;
+            job->phase = phase;
+            job->pass = pass;
+            job->done.store(0, std::memory_order_relaxed);
+            job->next.store(0, std::memory_order_release);
+
+            for (uint32_t i = 0; i < numHelpers; ++i)
+                dispatch_([job]() { job->run(); });
+
+            job->run();
+
+            // every chunk has been taken, the remaining ones are being processed
+            while (job->done.load(std::memory_order_acquire) != numChunks)
+                std::this_thread::yield();
+        };
+
+        runPhase(EPhase::COUNT_ALL, items, nullptr, 0);
+
+        auto src = items;
+        auto dst = scratch;
+        bool moved = false;
+
+        for (uint_fast32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+            // every key land in the same bucket, order is unchanged
+            // the digit counts don't depend on the order so the first histograms are still right
+            auto digit = Digit(src[0].key, pass);
+            size_t same = 0;
+
+            for (auto& chunkHistograms : job->histograms)
+                same += chunkHistograms[pass][digit];
+
+            if (same == count)
+                continue;
+
+            if (moved)
+                runPhase(EPhase::COUNT, src, nullptr, pass);
+
+            // a bucket is written by the chunks in order, which keeps the sort stable
+            size_t offset = 0;
+
+            for (uint_fast32_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+                for (auto& chunkHistograms : job->histograms) {
+                    auto size = chunkHistograms[pass][bucket];
+
+                    chunkHistograms[pass][bucket] = offset;
+                    offset += size;
+                }
+            }
+
+            runPhase(EPhase::SCATTER, src, dst, pass);
+            std::swap(src, dst);
+            moved = true;
+        }
+
+        if (src != items)
+            std::copy(src, src + count, items);
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,61 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Takoyaki
+{
+    struct SortItem
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // Stable LSD radix sort on the 64-bit key, 8 bits per pass
+    // scratch must be able to hold count items, passes where every key share the same digit are skipped
+    void RadixSort(SortItem* items, SortItem* scratch, size_t count);
+
+    // Same sort split across the thread pool for large arrays, each pass counts then scatters chunks of
+    // items with one histogram per chunk so the result is still stable
+    // The caller takes chunks too and returns once all of them are done, like CopyEngine
+    class RadixSorter
+    {
+        RadixSorter(const RadixSorter&) = delete;
+        RadixSorter& operator=(const RadixSorter&) = delete;
+
+    public:
+        using DispatchFunc = std::function<void(std::function<void()>)>;
+
+        RadixSorter() noexcept;
+
+        // without it every sort runs on the calling thread
+        void initialize(DispatchFunc dispatch, uint32_t numHelpers);
+
+        void sort(SortItem* items, SortItem* scratch, size_t count);
+
+    private:
+        DispatchFunc dispatch_;
+        uint32_t numHelpers_;
+    };
+}
+// namespace Takoyaki
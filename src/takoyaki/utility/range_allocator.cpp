@@ -0,0 +1,120 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "range_allocator.h"
+
+namespace Takoyaki
+{
+    RangeAllocator::RangeAllocator(uint32_t capacity)
+        : capacity_{ capacity }
+        , numFree_{ capacity }
+    {
+        if (capacity == 0)
+            throw std::runtime_error{ "RangeAllocator, capacity cannot be 0" };
+
+        insertBlock(0, capacity);
+    }
+
+    uint32_t RangeAllocator::allocate(uint32_t count)
+    {
+        if (count == 0)
+            throw std::runtime_error{ "RangeAllocator::allocate, count cannot be 0" };
+
+        // smallest block that fits
+        auto found = bySize_.lower_bound(count);
+
+        if (found == bySize_.end())
+            return RANGE_INVALID;
+
+        auto offset = found->second;
+        auto size = found->first;
+
+        eraseBlock(byOffset_.find(offset));
+
+        if (size > count)
+            insertBlock(offset + count, size - count);
+
+        numFree_ -= count;
+
+        return offset;
+    }
+
+    void RangeAllocator::free(uint32_t offset, uint32_t count)
+    {
+        if ((count == 0) || (offset >= capacity_) || (count > capacity_ - offset)) {
+            auto fmt = boost::format{ "RangeAllocator::free, invalid range %1%+%2%" } % offset % count;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        auto next = byOffset_.lower_bound(offset);
+        auto end = offset + count;
+
+        if ((next != byOffset_.end()) && (next->first < end)) {
+            auto fmt = boost::format{ "RangeAllocator::free, range %1%+%2% overlaps a free block" } % offset % count;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        if (next != byOffset_.begin()) {
+            auto prev = std::prev(next);
+            auto prevEnd = prev->first + prev->second->first;
+
+            if (prevEnd > offset) {
+                auto fmt = boost::format{ "RangeAllocator::free, range %1%+%2% overlaps a free block" } % offset % count;
+
+                throw std::runtime_error{ boost::str(fmt) };
+            }
+
+            // coalesce with the block before
+            if (prevEnd == offset) {
+                offset = prev->first;
+                eraseBlock(prev);
+            }
+        }
+
+        // coalesce with the block after
+        if ((next != byOffset_.end()) && (next->first == end)) {
+            end += next->second->first;
+            eraseBlock(next);
+        }
+
+        insertBlock(offset, end - offset);
+        numFree_ += count;
+    }
+
+    uint32_t RangeAllocator::getLargestFree() const
+    {
+        return bySize_.empty() ? 0 : bySize_.rbegin()->first;
+    }
+
+    void RangeAllocator::insertBlock(uint32_t offset, uint32_t count)
+    {
+        byOffset_.insert({ offset, bySize_.insert({ count, offset }) });
+    }
+
+    void RangeAllocator::eraseBlock(std::map<uint32_t, SizeMap::iterator>::iterator block)
+    {
+        bySize_.erase(block->second);
+        byOffset_.erase(block);
+    }
+}
+// namespace Takoyaki
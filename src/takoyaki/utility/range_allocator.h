@@ -0,0 +1,59 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+namespace Takoyaki
+{
+    constexpr uint32_t RANGE_INVALID = UINT32_MAX;
+
+    // Best-fit allocator of contiguous slot ranges, free blocks are indexed by offset for
+    // coalescing and by size for the best-fit search, both O(log n)
+    class RangeAllocator
+    {
+    public:
+        explicit RangeAllocator(uint32_t capacity);
+
+        // offset of the first slot, RANGE_INVALID when no free block is large enough
+        uint32_t allocate(uint32_t count);
+        void free(uint32_t offset, uint32_t count);
+
+        inline uint32_t getCapacity() const { return capacity_; }
+        inline uint32_t getNumFree() const { return numFree_; }
+        inline uint32_t getNumFreeBlocks() const { return static_cast<uint32_t>(bySize_.size()); }
+        uint32_t getLargestFree() const;
+
+    private:
+        using SizeMap = std::multimap<uint32_t, uint32_t>;
+
+        void insertBlock(uint32_t offset, uint32_t count);
+        void eraseBlock(std::map<uint32_t, SizeMap::iterator>::iterator);
+
+    private:
+        std::map<uint32_t, SizeMap::iterator> byOffset_;
+        SizeMap bySize_;                                    // size -> offset
+        uint32_t capacity_;
+        uint32_t numFree_;
+    };
+}
+// namespace Takoyaki
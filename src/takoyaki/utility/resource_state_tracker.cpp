@@ -0,0 +1,87 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "resource_state_tracker.h"
+
+namespace Takoyaki
+{
+    void ResourceStateTracker::clear()
+    {
+        entries_.clear();
+        pending_.clear();
+    }
+
+    void ResourceStateTracker::transition(void* resource, uint32_t home, uint32_t state)
+    {
+        auto found = std::find_if(entries_.begin(), entries_.end(), [resource](const Entry& entry) { return entry.resource == resource; });
+
+        if (found == entries_.end()) {
+            entries_.push_back(Entry{ resource, home, state, state });
+            return;
+        }
+
+        if (found->current == state)
+            return;
+
+        auto pending = std::find_if(pending_.begin(), pending_.end(), [resource](const ResourceTransition& barrier) { return barrier.resource == resource; });
+
+        if (pending == pending_.end()) {
+            pending_.push_back(ResourceTransition{ resource, found->current, state });
+        } else if (pending->before == state) {
+            // round trip, nothing to do
+            pending_.erase(pending);
+        } else {
+            pending->after = state;
+        }
+
+        found->current = state;
+    }
+
+    void ResourceStateTracker::flush(std::vector<ResourceTransition>& out)
+    {
+        out.insert(out.end(), pending_.begin(), pending_.end());
+        pending_.clear();
+    }
+
+    void ResourceStateResolver::resolve(const ResourceStateTracker& tracker, std::vector<ResourceTransition>& out)
+    {
+        for (auto& entry : tracker.getEntries()) {
+            auto res = states_.insert(std::make_pair(entry.resource, State{ entry.home, entry.home }));
+            auto& state = res.first->second;
+
+            if (state.current != entry.first)
+                out.push_back(ResourceTransition{ entry.resource, state.current, entry.first });
+
+            state.current = entry.current;
+        }
+    }
+
+    void ResourceStateResolver::restore(std::vector<ResourceTransition>& out)
+    {
+        for (auto& pair : states_) {
+            if (pair.second.current != pair.second.home)
+                out.push_back(ResourceTransition{ pair.first, pair.second.current, pair.second.home });
+        }
+
+        states_.clear();
+    }
+}
+// namespace Takoyaki
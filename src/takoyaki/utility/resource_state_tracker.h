@@ -0,0 +1,91 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Takoyaki
+{
+    // States are opaque 32-bit values so the planning can be done without any graphics API
+    // whole resources only, subresources are not tracked individually
+    struct ResourceTransition
+    {
+        void* resource;
+        uint32_t before;
+        uint32_t after;
+    };
+
+    // Track the state of each resource used by one command list
+    // the first use of a resource never emit a barrier since the state it will be in when
+    // the list execute is unknown, this is left to ResourceStateResolver at submission
+    class ResourceStateTracker
+    {
+    public:
+        struct Entry
+        {
+            void* resource;
+            uint32_t home;      // state the resource is created in and go back to at the end of the frame
+            uint32_t first;     // state required when the list start
+            uint32_t current;   // state when the list end
+        };
+
+        void clear();
+
+        // Request a resource to be in a given state for the next commands
+        // a transition back to a state that hasn't been flushed yet cancel the pending barrier
+        void transition(void* resource, uint32_t home, uint32_t state);
+
+        // Append merged pending transitions, should be called just before the commands that need them
+        void flush(std::vector<ResourceTransition>& out);
+
+        inline bool hasPending() const { return !pending_.empty(); }
+        inline const std::vector<Entry>& getEntries() const { return entries_; }
+
+    private:
+        // command lists only touch a handful of resources, linear search is fine
+        std::vector<Entry> entries_;
+        std::vector<ResourceTransition> pending_;
+    };
+
+    // Keep the state of every resource across the command lists of a frame, in execution order
+    class ResourceStateResolver
+    {
+    public:
+        // Append the transitions needed before the list can execute and remember its final states
+        void resolve(const ResourceStateTracker& tracker, std::vector<ResourceTransition>& out);
+
+        // Append the transitions to bring everything back to its home state and forget about it
+        // done at the end of the frame so code outside the command lists can rely on home states
+        void restore(std::vector<ResourceTransition>& out);
+
+    private:
+        struct State
+        {
+            uint32_t home;
+            uint32_t current;
+        };
+
+        std::unordered_map<void*, State> states_;
+    };
+}
+// namespace Takoyaki
@@ -0,0 +1,160 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "shadow_buffer.h"
+
+#include <emmintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Takoyaki
+{
+    namespace
+    {
+        inline uint32_t LowestBit(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+
+            _BitScanForward64(&index, value);
+
+            return static_cast<uint32_t>(index);
+#else
+            return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+        }
+    }
+
+    ShadowBuffer::ShadowBuffer(uint32_t sizeByte, uint32_t numSlots)
+        : numSlots_{ numSlots }
+        , size_{ sizeByte }
+    {
+        if ((sizeByte == 0) || (numSlots == 0))
+            throw std::runtime_error{ "ShadowBuffer, size and number of slots cannot be 0" };
+
+        auto numBlocks = (sizeByte + SHADOW_BLOCK_SIZE - 1) / SHADOW_BLOCK_SIZE;
+
+        wordsPerSlot_ = (numBlocks + 63) / 64;
+        data_.resize(numBlocks * SHADOW_BLOCK_SIZE, 0);
+        dirty_.resize(wordsPerSlot_ * numSlots, 0);
+    }
+
+    void ShadowBuffer::write(uint32_t offset, const void* data, uint32_t sizeByte)
+    {
+        if ((offset > size_) || (sizeByte > size_ - offset)) {
+            auto fmt = boost::format{ "ShadowBuffer::write, %1% bytes at offset %2% doesn't fit in %3% bytes" } % sizeByte % offset % size_;
+
+            throw std::runtime_error{ boost::str(fmt) };
+        }
+
+        if (sizeByte == 0)
+            return;
+
+        memcpy(&data_[offset], data, sizeByte);
+
+        auto first = offset / SHADOW_BLOCK_SIZE;
+        auto last = (offset + sizeByte - 1) / SHADOW_BLOCK_SIZE;
+
+        for (uint32_t slot = 0; slot < numSlots_; ++slot) {
+            auto words = &dirty_[slot * wordsPerSlot_];
+
+            for (auto block = first; block <= last; ++block)
+                words[block / 64] |= 1ULL << (block % 64);
+        }
+    }
+
+    uint32_t ShadowBuffer::flush(uint32_t slot, uint8_t* dst)
+    {
+        auto words = &dirty_[slot * wordsPerSlot_];
+        auto src = data_.data();
+        uint32_t res = 0;
+        uint32_t runStart = 0;
+        uint32_t runLength = 0;
+
+        // coalesce consecutive dirty blocks into runs so the destination is written sequentially
+        for (uint32_t w = 0; w < wordsPerSlot_; ++w) {
+            auto bits = words[w];
+
+            words[w] = 0;
+
+            while (bits != 0) {
+                auto block = w * 64 + LowestBit(bits);
+
+                bits &= bits - 1;
+
+                if ((runLength > 0) && (runStart + runLength == block)) {
+                    ++runLength;
+                } else {
+                    if (runLength > 0)
+                        StreamCopy(dst + runStart * SHADOW_BLOCK_SIZE, src + runStart * SHADOW_BLOCK_SIZE, runLength * SHADOW_BLOCK_SIZE);
+
+                    res += runLength * SHADOW_BLOCK_SIZE;
+                    runStart = block;
+                    runLength = 1;
+                }
+            }
+        }
+
+        if (runLength > 0)
+            StreamCopy(dst + runStart * SHADOW_BLOCK_SIZE, src + runStart * SHADOW_BLOCK_SIZE, runLength * SHADOW_BLOCK_SIZE);
+
+        res += runLength * SHADOW_BLOCK_SIZE;
+
+        // make the streamed data visible before the GPU is told to read it
+        _mm_sfence();
+
+        return res;
+    }
+
+    bool ShadowBuffer::isDirty(uint32_t slot) const
+    {
+        auto words = &dirty_[slot * wordsPerSlot_];
+
+        for (uint32_t w = 0; w < wordsPerSlot_; ++w) {
+            if (words[w] != 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    void StreamCopy(uint8_t* dst, const uint8_t* src, size_t bytes)
+    {
+        auto d = reinterpret_cast<__m128i*>(dst);
+        auto s = reinterpret_cast<const __m128i*>(src);
+
+        // one cache line per iteration so write-combining buffers are filled completely
+        for (size_t i = 0; i < bytes / 16; i += 4) {
+            auto a = _mm_loadu_si128(s + i);
+            auto b = _mm_loadu_si128(s + i + 1);
+            auto c = _mm_loadu_si128(s + i + 2);
+            auto e = _mm_loadu_si128(s + i + 3);
+
+            _mm_stream_si128(d + i, a);
+            _mm_stream_si128(d + i + 1, b);
+            _mm_stream_si128(d + i + 2, c);
+            _mm_stream_si128(d + i + 3, e);
+        }
+    }
+}
+// namespace Takoyaki
@@ -0,0 +1,62 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Takoyaki
+{
+    // dirty tracking granularity, a cache line so flushes are whole aligned lines
+    constexpr uint32_t SHADOW_BLOCK_SIZE = 64;
+
+    // CPU copy of a buffer mirrored in several GPU visible slots, usually one per frame
+    // Writes only touch the copy and mark the blocks dirty for every slot, a flush then copies the blocks
+    // changed since the previous flush of that slot in order with non-temporal stores, which is what
+    // write-combined memory wants, scattered writes and reads never hit it
+    // Not thread-safe
+    class ShadowBuffer
+    {
+    public:
+        ShadowBuffer(uint32_t sizeByte, uint32_t numSlots);
+
+        void write(uint32_t offset, const void* data, uint32_t sizeByte);
+
+        // dst is the start of the slot, 16 bytes aligned and with room for whole blocks
+        // return the number of bytes copied
+        uint32_t flush(uint32_t slot, uint8_t* dst);
+
+        bool isDirty(uint32_t slot) const;
+        inline const uint8_t* getData() const { return data_.data(); }
+        inline uint32_t getSize() const { return size_; }
+
+    private:
+        std::vector<uint8_t> data_;         // rounded up to whole blocks
+        std::vector<uint64_t> dirty_;       // one bit per block, numSlots * wordsPerSlot_
+        uint32_t wordsPerSlot_;
+        uint32_t numSlots_;
+        uint32_t size_;
+    };
+
+    // bytes must be a multiple of SHADOW_BLOCK_SIZE and dst 16 bytes aligned
+    void StreamCopy(uint8_t* dst, const uint8_t* src, size_t bytes);
+}
+// namespace Takoyaki
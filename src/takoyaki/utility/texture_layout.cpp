@@ -0,0 +1,81 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "pch.h"
+#include "texture_layout.h"
+
+namespace Takoyaki
+{
+    namespace
+    {
+        inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    uint32_t GetMipChainLength(uint32_t width, uint32_t height, uint32_t depth)
+    {
+        auto largest = (std::max)({ width, height, depth });
+        uint32_t res = 1;
+
+        while (largest > 1) {
+            largest >>= 1;
+            ++res;
+        }
+
+        return res;
+    }
+
+    SubresourceFootprint GetFootprint(const TextureLayoutDesc& desc, uint32_t subresource, uint32_t pitchAlignment)
+    {
+        auto mip = subresource % desc.mipLevels;
+        auto blockSize = (desc.blockSize > 0) ? desc.blockSize : 1;
+        SubresourceFootprint res;
+
+        res.offset = 0;
+        res.width = static_cast<uint32_t>(AlignUp(MipExtent(desc.width, mip), blockSize));
+        res.height = static_cast<uint32_t>(AlignUp(MipExtent(desc.height, mip), blockSize));
+        res.depth = MipExtent(desc.depth, mip);
+        res.rowSizeByte = res.width / blockSize * desc.bytesPerTexel;
+        res.rowPitch = static_cast<uint32_t>(AlignUp(res.rowSizeByte, pitchAlignment));
+        res.numRows = res.height / blockSize;
+
+        return res;
+    }
+
+    uint64_t PlaceFootprints(SubresourceFootprint* footprints, uint32_t count, uint64_t offset, uint32_t placementAlignment)
+    {
+        for (uint32_t i = 0; i < count; ++i) {
+            offset = AlignUp(offset, placementAlignment);
+            footprints[i].offset = offset;
+            offset += GetFootprintSize(footprints[i]);
+        }
+
+        return offset;
+    }
+
+    uint64_t GetMipSize(const TextureLayoutDesc& desc, uint32_t mip)
+    {
+        auto fp = GetFootprint(desc, mip);
+
+        return AlignUp(GetFootprintSize(fp), TEXTURE_PLACEMENT_ALIGNMENT) * desc.arraySize;
+    }
+} // namespace Takoyaki
\ No newline at end of file
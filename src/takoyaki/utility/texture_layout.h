@@ -0,0 +1,73 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace Takoyaki
+{
+    // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+    constexpr uint32_t TEXTURE_PITCH_ALIGNMENT = 256;
+    constexpr uint32_t TEXTURE_PLACEMENT_ALIGNMENT = 512;
+
+    // depth is 1 for array textures and arraySize 1 for volumes
+    // block compressed formats have a blockSize of 4 and bytesPerTexel is then the size of a block
+    struct TextureLayoutDesc
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth;
+        uint32_t arraySize;
+        uint32_t mipLevels;
+        uint32_t bytesPerTexel;
+        uint32_t blockSize;
+    };
+
+    // Layout of a subresource in a buffer, what GetCopyableFootprints returns
+    // width and height are rounded up to whole blocks, numRows counts rows of blocks
+    struct SubresourceFootprint
+    {
+        uint64_t offset;
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth;
+        uint32_t rowSizeByte;
+        uint32_t rowPitch;
+        uint32_t numRows;
+    };
+
+    // subresources are numbered like D3D12CalcSubresource, every mip of the first slice then the next slice
+    inline uint32_t CalcSubresource(uint32_t mip, uint32_t arraySlice, uint32_t mipLevels) { return mip + arraySlice * mipLevels; }
+    inline uint32_t MipExtent(uint32_t size, uint32_t mip) { return (size >> mip) > 0 ? (size >> mip) : 1; }
+    inline uint64_t GetFootprintSize(const SubresourceFootprint& fp) { return static_cast<uint64_t>(fp.rowPitch) * fp.numRows * fp.depth; }
+
+    // number of mips down to 1x1x1
+    uint32_t GetMipChainLength(uint32_t width, uint32_t height, uint32_t depth);
+
+    // offset is left to 0, pitchAlignment 1 gives a tightly packed layout
+    SubresourceFootprint GetFootprint(const TextureLayoutDesc& desc, uint32_t subresource, uint32_t pitchAlignment = TEXTURE_PITCH_ALIGNMENT);
+
+    // place the footprints one after the other from offset with the placement alignment, return the end
+    uint64_t PlaceFootprints(SubresourceFootprint* footprints, uint32_t count, uint64_t offset, uint32_t placementAlignment = TEXTURE_PLACEMENT_ALIGNMENT);
+
+    // bytes of a mip level across all the array slices with the copy alignments
+    uint64_t GetMipSize(const TextureLayoutDesc& desc, uint32_t mip);
+} // namespace Takoyaki
\ No newline at end of file
@@ -0,0 +1,132 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Takoyaki
+{
+    constexpr uint_fast32_t MAX_THREAD_SLOT_CACHES = 32;
+
+    // Small index given to each thread on first use, threads past MAX_THREAD_SLOT_CACHES share caches
+    uint_fast32_t GetThreadCacheIndex();
+
+    // Per thread caches of slots reserved from a shared allocator, refilled and flushed in batches so
+    // that the owner lock is only taken once every batchSize operations
+    // The owner provide the batch operations, both called with the cache lock held:
+    //   refill(std::vector<Item>& out, size_t count) must append count items
+    //   flush(const std::vector<Released>& released) must give back everything
+    template <typename Item, typename Released>
+    class ThreadSlotCaches
+    {
+        ThreadSlotCaches(const ThreadSlotCaches&) = delete;
+        ThreadSlotCaches& operator=(const ThreadSlotCaches&) = delete;
+
+    public:
+        explicit ThreadSlotCaches(size_t batchSize)
+            : batchSize_{ batchSize }
+        {
+        }
+
+        template <typename Refill>
+        Item acquire(Refill&& refill)
+        {
+            auto& cache = caches_[GetThreadCacheIndex() % MAX_THREAD_SLOT_CACHES];
+            std::lock_guard<std::mutex> lock{ cache.mutex };
+
+            if (cache.items.empty()) {
+                refill(cache.items, batchSize_);
+
+                // hand out in allocation order
+                std::reverse(cache.items.begin(), cache.items.end());
+            }
+
+            auto res = cache.items.back();
+
+            cache.items.pop_back();
+
+            return res;
+        }
+
+        template <typename Flush>
+        void release(const Released& released, Flush&& flush)
+        {
+            auto& cache = caches_[GetThreadCacheIndex() % MAX_THREAD_SLOT_CACHES];
+            std::lock_guard<std::mutex> lock{ cache.mutex };
+
+            cache.released.push_back(released);
+
+            // swap first so that a throwing flush doesn't leave the batch behind
+            if (cache.released.size() >= batchSize_) {
+                std::vector<Released> batch;
+
+                batch.swap(cache.released);
+                flush(batch);
+            }
+        }
+
+        // give back every released slot, reserved ones stay in the caches
+        template <typename Flush>
+        void flushAll(Flush&& flush)
+        {
+            for (auto& cache : caches_) {
+                std::lock_guard<std::mutex> lock{ cache.mutex };
+
+                if (!cache.released.empty()) {
+                    std::vector<Released> batch;
+
+                    batch.swap(cache.released);
+                    flush(batch);
+                }
+            }
+        }
+
+        size_t getNumReserved()
+        {
+            size_t res = 0;
+
+            for (auto& cache : caches_) {
+                std::lock_guard<std::mutex> lock{ cache.mutex };
+
+                res += cache.items.size() + cache.released.size();
+            }
+
+            return res;
+        }
+
+    private:
+        // one cache line each so that threads don't share them
+        struct alignas(64) Cache
+        {
+            std::mutex mutex;
+            std::vector<Item> items;
+            std::vector<Released> released;
+        };
+
+        std::array<Cache, MAX_THREAD_SLOT_CACHES> caches_;
+        size_t batchSize_;
+    };
+}
+// namespace Takoyaki
@@ -0,0 +1,233 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "../../takoyaki/utility/bitmap_allocator.h"
+
+using Takoyaki::BitmapAllocator;
+using Takoyaki::BITMAP_INVALID;
+
+namespace
+{
+    // descriptor heap collection before the bitmap, scan every heap freelist and map handles back to their heap
+    class ScanCollection
+    {
+    public:
+        uintptr_t allocate()
+        {
+            for (size_t i = 0;; ++i) {
+                if (i == heaps_.size()) {
+                    Heap heap;
+
+                    heap.base = (heaps_.size() + 1) * 0x100000;
+                    heap.freelist.resize(HEAP_SIZE);
+                    std::iota(heap.freelist.rbegin(), heap.freelist.rend(), 0);
+                    heaps_.push_back(std::move(heap));
+                }
+
+                auto& heap = heaps_[i];
+
+                if (!heap.freelist.empty()) {
+                    auto slot = heap.freelist.back();
+                    auto handle = heap.base + slot * 32;
+
+                    heap.freelist.pop_back();
+                    owners_.insert(std::make_pair(handle, i));
+
+                    return handle;
+                }
+            }
+        }
+
+        void release(uintptr_t handle)
+        {
+            auto found = owners_.find(handle);
+            auto& heap = heaps_[found->second];
+
+            heap.freelist.push_back(static_cast<uint32_t>((handle - heap.base) / 32));
+            owners_.erase(found);
+        }
+
+    private:
+        static constexpr uint32_t HEAP_SIZE = 128;
+
+        struct Heap
+        {
+            uintptr_t base;
+            std::vector<uint32_t> freelist;
+        };
+
+        std::vector<Heap> heaps_;
+        std::unordered_map<uintptr_t, size_t> owners_;
+    };
+
+    // same layout as DX12DescriptorHeapCollection, stack of heaps with free slots and global indices
+    class BitmapCollection
+    {
+    public:
+        explicit BitmapCollection(uint32_t capacity)
+            : capacity_{ capacity }
+        {
+        }
+
+        uint32_t allocate()
+        {
+            if (available_.empty()) {
+                heaps_.emplace_back(capacity_);
+                available_.push_back(static_cast<uint32_t>(heaps_.size() - 1));
+                listed_.push_back(true);
+            }
+
+            auto heap = available_.back();
+            auto slot = heaps_[heap].allocate();
+
+            if (heaps_[heap].getNumFree() == 0) {
+                available_.pop_back();
+                listed_[heap] = false;
+            }
+
+            return heap * capacity_ + slot;
+        }
+
+        void release(uint32_t index)
+        {
+            auto heap = index / capacity_;
+
+            heaps_[heap].free(index % capacity_);
+
+            if (!listed_[heap]) {
+                listed_[heap] = true;
+                available_.push_back(heap);
+            }
+        }
+
+    private:
+        uint32_t capacity_;
+        std::deque<BitmapAllocator> heaps_;
+        std::vector<uint32_t> available_;
+        std::vector<bool> listed_;
+    };
+
+    template <typename Collection, typename Handle>
+    void BenchCollection(const char* name, Collection& collection, const std::vector<uint32_t>& order)
+    {
+        std::vector<Handle> handles(order.size());
+
+        auto allocMs = MeasureMs([&]() { for (auto& handle : handles) handle = collection.allocate(); });
+        auto freeMs = MeasureMs([&]() { for (auto index : order) collection.release(handles[index]); });
+        auto reallocMs = MeasureMs([&]() { for (auto& handle : handles) handle = collection.allocate(); });
+
+        auto fmt = boost::format("  %1%: alloc %2$.2f ms, free %3$.2f ms, realloc %4$.2f ms") % name % allocMs % freeMs % reallocMs;
+
+        std::cout << boost::str(fmt) << std::endl;
+    }
+}
+
+void TestBitmapAllocator()
+{
+    // sizes around the word and level boundaries
+    for (uint32_t capacity : { 1, 63, 64, 65, 4096, 4097, 300000 }) {
+        BitmapAllocator allocator{ capacity };
+
+        for (uint32_t i = 0; i < capacity; ++i)
+            CORE_CHECK(allocator.allocate() == i);
+
+        CORE_CHECK(allocator.allocate() == BITMAP_INVALID);
+        CORE_CHECK(allocator.getNumFree() == 0);
+
+        // the lowest free slot comes first
+        allocator.free(capacity - 1);
+
+        if (capacity > 1) {
+            allocator.free(0);
+            CORE_CHECK(allocator.allocate() == 0);
+        }
+
+        CORE_CHECK(allocator.allocate() == capacity - 1);
+        CORE_CHECK(allocator.allocate() == BITMAP_INVALID);
+    }
+
+    // random traffic against the lowest free slot of a reference set
+    const uint32_t capacity = 5000;
+    BitmapAllocator allocator{ capacity };
+    std::set<uint32_t> free;
+    std::vector<uint32_t> used;
+    std::mt19937 rng{ 3 };
+
+    for (uint32_t i = 0; i < capacity; ++i)
+        free.insert(i);
+
+    for (int i = 0; i < 200000; ++i) {
+        if (used.empty() || (!free.empty() && (rng() % 100 < 55))) {
+            auto slot = allocator.allocate();
+
+            CORE_CHECK(slot == *free.begin());
+            free.erase(free.begin());
+            used.push_back(slot);
+        } else {
+            auto pick = rng() % used.size();
+            auto slot = used[pick];
+
+            used[pick] = used.back();
+            used.pop_back();
+            allocator.free(slot);
+            free.insert(slot);
+            CORE_CHECK(allocator.isFree(slot));
+        }
+
+        CORE_CHECK(allocator.getNumFree() == free.size());
+    }
+
+    // double free and out of range
+    auto slot = used.back();
+
+    allocator.free(slot);
+    CORE_CHECK_THROW(allocator.free(slot));
+    CORE_CHECK_THROW(allocator.free(capacity));
+}
+
+void BenchBitmapAllocator()
+{
+    // 100k descriptors allocated, released in random order then allocated again
+    const uint32_t count = 100000;
+    std::vector<uint32_t> order(count);
+    std::mt19937 rng{ 7 };
+
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    ScanCollection scan;
+    BitmapCollection small{ 128 };
+    BitmapCollection large{ 4096 };
+
+    BenchCollection<ScanCollection, uintptr_t>("freelist scan + map, 128 per heap", scan, order);
+    BenchCollection<BitmapCollection, uint32_t>("bitmap, 128 per heap", small, order);
+    BenchCollection<BitmapCollection, uint32_t>("bitmap, 4096 per heap", large, order);
+}
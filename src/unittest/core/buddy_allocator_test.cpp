@@ -0,0 +1,163 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+
+#include "../../takoyaki/utility/buddy_allocator.h"
+
+using Takoyaki::BuddyAllocator;
+using Takoyaki::BUDDY_INVALID;
+
+namespace
+{
+    constexpr uint64_t KB = 1024;
+    constexpr uint64_t MB = 1024 * KB;
+
+    // same as DX12MemoryAllocator, 64 MiB heaps and the 64 KiB placement alignment
+    constexpr uint64_t HEAP_SIZE = 64 * MB;
+    constexpr uint64_t MIN_BLOCK_SIZE = 64 * KB;
+
+    struct StressResult
+    {
+        uint64_t attempts;
+        uint64_t failed;
+        double fragmentation;       // average of 1 - largest free / free
+    };
+
+    // random allocations mostly below 256 KiB with a few up to 4 MiB, frees picked among the oldest blocks
+    // every block is checked against a reference map for alignment and overlap
+    StressResult Stress(BuddyAllocator& allocator, int numOps)
+    {
+        std::mt19937_64 rng{ 42 };
+        std::map<uint64_t, uint64_t> live;
+        StressResult res = {};
+        double fragSum = 0;
+        int fragCount = 0;
+
+        for (int i = 0; i < numOps; ++i) {
+            if (live.empty() || (rng() % 100 < 55)) {
+                uint64_t size = (rng() % 8 == 0) ? (MIN_BLOCK_SIZE + rng() % (4 * MB)) : (1 + rng() % (256 * KB));
+                uint64_t rounded = MIN_BLOCK_SIZE;
+
+                while (rounded < size)
+                    rounded <<= 1;
+
+                ++res.attempts;
+
+                auto offset = allocator.allocate(size);
+
+                if (offset == BUDDY_INVALID) {
+                    ++res.failed;
+                    continue;
+                }
+
+                CORE_CHECK(offset % rounded == 0);
+
+                auto next = live.lower_bound(offset);
+
+                CORE_CHECK((next == live.end()) || (offset + rounded <= next->first));
+                CORE_CHECK((next == live.begin()) || (std::prev(next)->first + std::prev(next)->second <= offset));
+
+                live[offset] = rounded;
+            } else {
+                auto it = live.begin();
+
+                std::advance(it, rng() % (std::min)(live.size(), size_t{ 64 }));
+                allocator.free(it->first);
+                live.erase(it);
+            }
+
+            if ((i % 1000 == 0) && (allocator.getNumFree() > 0)) {
+                fragSum += 1.0 - static_cast<double>(allocator.getLargestFree()) / allocator.getNumFree();
+                ++fragCount;
+            }
+        }
+
+        uint64_t used = 0;
+
+        for (auto& block : live)
+            used += block.second;
+
+        CORE_CHECK(used == allocator.getCapacity() - allocator.getNumFree());
+
+        // everything merges back into a single block
+        for (auto& block : live)
+            allocator.free(block.first);
+
+        CORE_CHECK(allocator.isEmpty());
+        CORE_CHECK((allocator.getLargestFree() == allocator.getCapacity()) && (allocator.getNumFreeBlocks() == 1));
+
+        res.fragmentation = (fragCount > 0) ? fragSum / fragCount : 0;
+
+        return res;
+    }
+}
+
+void TestBuddyAllocator()
+{
+    BuddyAllocator allocator{ HEAP_SIZE, MIN_BLOCK_SIZE };
+
+    CORE_CHECK((allocator.getLargestFree() == HEAP_SIZE) && (allocator.getNumFreeBlocks() == 1));
+
+    // 0-64 KiB allocated, 64-128 KiB free, 128-256 KiB allocated
+    auto first = allocator.allocate(1);
+    auto second = allocator.allocate(100 * KB);
+
+    CORE_CHECK(first == 0);
+    CORE_CHECK(second == 128 * KB);
+    CORE_CHECK(allocator.getNumFree() == HEAP_SIZE - 3 * MIN_BLOCK_SIZE);
+
+    allocator.free(first);
+    allocator.free(second);
+    CORE_CHECK(allocator.isEmpty() && (allocator.getNumFreeBlocks() == 1));
+
+    CORE_CHECK(allocator.allocate(HEAP_SIZE + 1) == BUDDY_INVALID);
+
+    auto full = allocator.allocate(HEAP_SIZE);
+
+    CORE_CHECK(full == 0);
+    CORE_CHECK(allocator.allocate(1) == BUDDY_INVALID);
+    allocator.free(full);
+
+    // freeing something which isn't the start of an allocated block
+    CORE_CHECK_THROW(allocator.free(64 * KB));
+    CORE_CHECK_THROW(BuddyAllocator(3 * MB, MIN_BLOCK_SIZE));
+
+    Stress(allocator, 200000);
+}
+
+void BenchBuddyAllocator()
+{
+    BuddyAllocator allocator{ HEAP_SIZE, MIN_BLOCK_SIZE };
+    StressResult res;
+
+    auto ms = MeasureMs([&]() { res = Stress(allocator, 2000000); });
+
+    auto fmt = boost::format("  2M operations on a 64 MiB heap: %1$.1f ms with reference checks, %2%/%3% allocations failed, average fragmentation %4$.3f") %
+        ms % res.failed % res.attempts % res.fragmentation;
+
+    std::cout << boost::str(fmt) << std::endl;
+}
@@ -0,0 +1,146 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../takoyaki/utility/constant_buffer_layout.h"
+#include "../../takoyaki/utility/shadow_buffer.h"
+
+using Takoyaki::ConstantBufferLayout;
+using Takoyaki::FIELD_INVALID;
+using Takoyaki::FieldHandle;
+using Takoyaki::ShadowBuffer;
+
+namespace
+{
+    // same path as DX12ConstantBuffer::setField
+    template <typename T>
+    void Set(const ConstantBufferLayout& layout, ShadowBuffer& shadow, FieldHandle handle, const T& value)
+    {
+        shadow.write(layout.getWriteOffset(handle, sizeof(T)), &value, sizeof(T));
+    }
+
+    template <typename T>
+    T Get(const ShadowBuffer& shadow, uint_fast32_t offset)
+    {
+        T res;
+
+        std::memcpy(&res, shadow.getData() + offset, sizeof(T));
+
+        return res;
+    }
+
+    struct Light
+    {
+        float position[3];
+        float range;
+        float color[4];
+    };
+}
+
+void TestConstantBufferLayout()
+{
+    ConstantBufferLayout layout{ 256 };
+
+    // handles are given in declaration order
+    auto world = layout.addField("world", 0, 64);
+    auto time = layout.addField("time", 64, 4);
+    auto light = layout.addField("light", 80, sizeof(Light));
+    auto last = layout.addField("last", 252, 4);
+
+    CORE_CHECK((world == 0) && (time == 1) && (light == 2) && (last == 3));
+    CORE_CHECK(layout.getNumFields() == 4);
+    CORE_CHECK((layout.getOffset(light) == 80) && (layout.getFieldSize(light) == sizeof(Light)));
+
+    // resolution by name
+    CORE_CHECK(layout.getField("time") == time);
+    CORE_CHECK(layout.getField("light") == light);
+    CORE_CHECK(layout.getField("unknown") == FIELD_INVALID);
+    CORE_CHECK(!layout.isValid(FIELD_INVALID) && !layout.isValid(4));
+
+    // names are unique and fields must fit
+    CORE_CHECK_THROW(layout.addField("time", 128, 4));
+    CORE_CHECK_THROW(layout.addField("empty", 128, 0));
+    CORE_CHECK_THROW(layout.addField("past", 253, 4));
+    CORE_CHECK_THROW(layout.addField("outside", 300, 4));
+    CORE_CHECK(layout.getNumFields() == 4);
+
+    // typed writes land at their offset
+    ShadowBuffer shadow{ static_cast<uint32_t>(layout.getSize()), 1 };
+    Light value = { { 1.f, 2.f, 3.f }, 10.f, { 0.5f, 0.5f, 0.5f, 1.f } };
+
+    Set(layout, shadow, time, 1.5f);
+    Set(layout, shadow, light, value);
+    Set(layout, shadow, last, 42u);
+
+    CORE_CHECK(Get<float>(shadow, 64) == 1.5f);
+    CORE_CHECK(Get<Light>(shadow, 80).range == 10.f);
+    CORE_CHECK(Get<Light>(shadow, 80).color[3] == 1.f);
+    CORE_CHECK(Get<uint32_t>(shadow, 252) == 42u);
+
+    // a smaller write is fine, larger than the variable or an invalid handle is not
+    Set(layout, shadow, world, 2.f);
+    CORE_CHECK(Get<float>(shadow, 0) == 2.f);
+    CORE_CHECK_THROW(Set(layout, shadow, time, 1.0));
+    CORE_CHECK_THROW(Set(layout, shadow, FIELD_INVALID, 1.f));
+    CORE_CHECK_THROW(Set(layout, shadow, 4, 1.f));
+}
+
+void BenchConstantBufferLayout()
+{
+    // 256 KiB buffer of 64 bytes variables, 100k writes spread over them
+    const uint32_t numFields = 4096;
+    const uint32_t numWrites = 100000;
+    ConstantBufferLayout layout{ numFields * 64 };
+    ShadowBuffer shadow{ static_cast<uint32_t>(layout.getSize()), 1 };
+    std::vector<std::string> names;
+    std::vector<FieldHandle> handles;
+    float value[16] = {};
+
+    for (uint32_t i = 0; i < numFields; ++i) {
+        names.push_back("field" + std::to_string(i));
+        handles.push_back(layout.addField(names.back(), i * 64, 64));
+    }
+
+    auto handleMs = MeasureMs([&]()
+    {
+        for (uint32_t i = 0; i < numWrites; ++i) {
+            value[0] = static_cast<float>(i);
+            shadow.write(layout.getWriteOffset(handles[(i * 7) % numFields], sizeof(value)), value, sizeof(value));
+        }
+    });
+
+    auto nameMs = MeasureMs([&]()
+    {
+        for (uint32_t i = 0; i < numWrites; ++i) {
+            value[0] = static_cast<float>(i);
+            shadow.write(layout.getWriteOffset(layout.getField(names[(i * 7) % numFields]), sizeof(value)), value, sizeof(value));
+        }
+    });
+
+    auto fmt = boost::format("  %1% writes of 64 bytes: handle %2$.2f ms, name lookup %3$.2f ms") % numWrites % handleMs % nameMs;
+
+    std::cout << boost::str(fmt) << std::endl;
+}
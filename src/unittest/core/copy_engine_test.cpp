@@ -0,0 +1,200 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../../takoyaki/utility/copy_engine.h"
+
+using Takoyaki::CopyEngine;
+using Takoyaki::CopyRegion;
+
+namespace
+{
+    constexpr uint8_t GUARD = 0xCD;
+
+    // helpers get their own thread, joined once the copy returned
+    class ThreadDispatch
+    {
+    public:
+        ~ThreadDispatch() { join(); }
+
+        CopyEngine::DispatchFunc get()
+        {
+            return [this](std::function<void()> func) { threads_.emplace_back(std::move(func)); };
+        }
+
+        void join()
+        {
+            for (auto& thread : threads_)
+                thread.join();
+
+            threads_.clear();
+        }
+
+    private:
+        std::vector<std::thread> threads_;
+    };
+
+    // random pitches and misalignments, the rows must match and the padding stay untouched
+    void CheckRandomRegions(CopyEngine& engine, ThreadDispatch& dispatch, std::mt19937& rng, int count, size_t maxRowSize)
+    {
+        for (int i = 0; i < count; ++i) {
+            size_t rowSize = 1 + rng() % maxRowSize;
+            size_t dstRowPitch = rowSize + rng() % 300;
+            size_t srcRowPitch = rowSize + rng() % 300;
+            uint32_t numRows = 1 + rng() % 64;
+            uint32_t numSlices = 1 + rng() % 3;
+            size_t dstSlicePitch = dstRowPitch * numRows + rng() % 64;
+            size_t srcSlicePitch = srcRowPitch * numRows + rng() % 64;
+            size_t dstOffset = rng() % 64;
+            size_t srcOffset = rng() % 64;
+
+            std::vector<uint8_t> src(srcOffset + srcSlicePitch * numSlices);
+            std::vector<uint8_t> dst(dstOffset + dstSlicePitch * numSlices, GUARD);
+            std::vector<uint8_t> expected = dst;
+
+            for (auto& byte : src)
+                byte = static_cast<uint8_t>(rng());
+
+            CopyRegion region;
+
+            region.dst = dst.data() + dstOffset;
+            region.src = src.data() + srcOffset;
+            region.dstRowPitch = dstRowPitch;
+            region.dstSlicePitch = dstSlicePitch;
+            region.srcRowPitch = srcRowPitch;
+            region.srcSlicePitch = srcSlicePitch;
+            region.rowSizeByte = rowSize;
+            region.numRows = numRows;
+            region.numSlices = numSlices;
+
+            for (uint32_t slice = 0; slice < numSlices; ++slice) {
+                for (uint32_t row = 0; row < numRows; ++row) {
+                    std::memcpy(expected.data() + dstOffset + slice * dstSlicePitch + row * dstRowPitch,
+                        src.data() + srcOffset + slice * srcSlicePitch + row * srcRowPitch, rowSize);
+                }
+            }
+
+            engine.copy(region);
+            dispatch.join();
+
+            CORE_CHECK(dst == expected);
+        }
+    }
+
+    double GBPerSecond(size_t bytes, int iterations, double ms)
+    {
+        return static_cast<double>(bytes) * iterations / (ms * 1e6);
+    }
+}
+
+void TestCopyEngine()
+{
+    std::mt19937 rng{ 5 };
+    CopyEngine engine;
+    ThreadDispatch dispatch;
+
+    // every row size around the streaming threshold and the vector widths on the calling thread
+    CheckRandomRegions(engine, dispatch, rng, 300, 1100);
+
+    // linear copies of any size and alignment
+    for (int i = 0; i < 200; ++i) {
+        size_t size = (i < 100) ? rng() % 4096 : rng() % (3 * 1024 * 1024);
+        size_t offset = rng() % 64;
+        std::vector<uint8_t> src(size);
+        std::vector<uint8_t> dst(offset + size + 64, GUARD);
+        std::vector<uint8_t> expected = dst;
+
+        for (auto& byte : src)
+            byte = static_cast<uint8_t>(rng());
+
+        std::memcpy(expected.data() + offset, src.data(), size);
+        engine.copy(dst.data() + offset, src.data(), size);
+
+        CORE_CHECK(dst == expected);
+    }
+
+    // large rows are split in chunks across helpers
+    engine.initialize(dispatch.get(), 3);
+    CheckRandomRegions(engine, dispatch, rng, 20, 300 * 1024);
+
+    std::vector<uint8_t> src(5 * 1024 * 1024 + 17);
+    std::vector<uint8_t> dst(src.size(), GUARD);
+
+    for (auto& byte : src)
+        byte = static_cast<uint8_t>(rng());
+
+    engine.copy(dst.data(), src.data(), src.size());
+    dispatch.join();
+    CORE_CHECK(dst == src);
+}
+
+void BenchCopyEngine()
+{
+    // texture rows of 4096 bytes into a 4352 bytes pitch, on the calling thread
+    const size_t rowSize = 4096;
+    const size_t dstRowPitch = 4352;
+    CopyEngine engine;
+
+    for (size_t size : { size_t{ 4 } << 10, size_t{ 64 } << 10, size_t{ 1 } << 20, size_t{ 16 } << 20, size_t{ 64 } << 20, size_t{ 256 } << 20 }) {
+        auto numRows = static_cast<uint32_t>(size / rowSize);
+        std::vector<uint8_t> src(size, 1);
+        std::vector<uint8_t> dst(numRows * dstRowPitch + 64, 0);
+        int iterations = static_cast<int>((std::max)(size_t{ 1 }, (size_t{ 256 } << 20) / size / 8));
+        CopyRegion region;
+
+        region.dst = dst.data();
+        region.src = src.data();
+        region.dstRowPitch = dstRowPitch;
+        region.dstSlicePitch = numRows * dstRowPitch;
+        region.srcRowPitch = rowSize;
+        region.srcSlicePitch = size;
+        region.rowSizeByte = rowSize;
+        region.numRows = numRows;
+        region.numSlices = 1;
+
+        // first touch of the pages out of the timings
+        engine.copy(region);
+
+        auto memcpyMs = MeasureMs([&]()
+        {
+            for (int i = 0; i < iterations; ++i) {
+                for (uint32_t row = 0; row < numRows; ++row)
+                    std::memcpy(dst.data() + row * dstRowPitch, src.data() + row * rowSize, rowSize);
+            }
+        });
+
+        auto streamMs = MeasureMs([&]() { for (int i = 0; i < iterations; ++i) engine.copy(region); });
+        auto linearMs = MeasureMs([&]() { for (int i = 0; i < iterations; ++i) engine.copy(dst.data(), src.data(), size); });
+
+        auto fmt = boost::format("  %1% KiB: memcpy rows %2$.1f GB/s, stream rows %3$.1f GB/s, stream linear %4$.1f GB/s") % (size >> 10) %
+            GBPerSecond(size, iterations, memcpyMs) % GBPerSecond(size, iterations, streamMs) % GBPerSecond(size, iterations, linearMs);
+
+        std::cout << boost::str(fmt) << std::endl;
+    }
+}
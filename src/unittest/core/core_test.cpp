@@ -0,0 +1,93 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <iostream>
+
+namespace
+{
+    struct CoreTestDesc
+    {
+        const char* name;
+        void(*func)();
+    };
+
+    const CoreTestDesc tests[] = {
+        { "BitmapAllocator", TestBitmapAllocator },
+        { "BuddyAllocator", TestBuddyAllocator },
+        { "ConstantBufferLayout", TestConstantBufferLayout },
+        { "CopyEngine", TestCopyEngine },
+        { "DescriptorRing", TestDescriptorRing },
+        { "DescriptorTableCache", TestDescriptorTableCache },
+        { "FencedIndexAllocator", TestFencedIndexAllocator },
+        { "FrameGraph", TestFrameGraph },
+        { "LinearAllocator", TestLinearAllocator },
+        { "MipStreamer", TestMipStreamer },
+        { "RadixSort", TestRadixSort },
+        { "RangeAllocator", TestRangeAllocator },
+        { "ResourceStateTracker", TestResourceStateTracker },
+        { "ShadowBuffer", TestShadowBuffer },
+        { "TextureLayout", TestTextureLayout },
+        { "ThreadSlotCache", TestThreadSlotCache }
+    };
+
+    const CoreTestDesc benchmarks[] = {
+        { "BitmapAllocator", BenchBitmapAllocator },
+        { "BuddyAllocator", BenchBuddyAllocator },
+        { "ConstantBufferLayout", BenchConstantBufferLayout },
+        { "CopyEngine", BenchCopyEngine },
+        { "RadixSort", BenchRadixSort },
+        { "ShadowBuffer", BenchShadowBuffer },
+        { "ThreadSlotCache", BenchThreadSlotCache }
+    };
+}
+
+bool RunCoreTests()
+{
+    bool res = true;
+
+    for (auto& test : tests) {
+        try {
+            test.func();
+
+            auto fmt = boost::format("[core] %1%, Passed") % test.name;
+
+            std::cout << boost::str(fmt) << std::endl;
+        } catch (const std::exception& e) {
+            auto fmt = boost::format("[core] %1%, Failed: %2%") % test.name % e.what();
+
+            std::cout << boost::str(fmt) << std::endl;
+            res = false;
+        }
+    }
+
+    return res;
+}
+
+void RunCoreBenchmarks()
+{
+    for (auto& bench : benchmarks) {
+        auto fmt = boost::format("[bench] %1%") % bench.name;
+
+        std::cout << boost::str(fmt) << std::endl;
+        bench.func();
+    }
+}
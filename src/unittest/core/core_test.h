@@ -0,0 +1,83 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <stdexcept>
+#include <boost/format.hpp>
+
+// Tests of the parts of the renderer that do not need a GPU, a failed check throws and ends the test
+#define CORE_CHECK(expr) \
+    do { \
+        if (!(expr)) \
+            throw std::runtime_error{ boost::str(boost::format{ "%1%(%2%): %3%" } % __FILE__ % __LINE__ % #expr) }; \
+    } while (false)
+
+#define CORE_CHECK_THROW(expr) \
+    do { \
+        bool thrown = false; \
+        try { expr; } catch (const std::exception&) { thrown = true; } \
+        if (!thrown) \
+            throw std::runtime_error{ boost::str(boost::format{ "%1%(%2%): %3% did not throw" } % __FILE__ % __LINE__ % #expr) }; \
+    } while (false)
+
+// run before the rendering tests, false if any of them failed
+bool RunCoreTests();
+
+// timings of the same code, only on request since they take a while
+void RunCoreBenchmarks();
+
+template <typename Func>
+double MeasureMs(Func&& func)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    func();
+
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// tests
+void TestBitmapAllocator();
+void TestBuddyAllocator();
+void TestConstantBufferLayout();
+void TestCopyEngine();
+void TestDescriptorRing();
+void TestDescriptorTableCache();
+void TestFencedIndexAllocator();
+void TestFrameGraph();
+void TestLinearAllocator();
+void TestMipStreamer();
+void TestRadixSort();
+void TestRangeAllocator();
+void TestResourceStateTracker();
+void TestShadowBuffer();
+void TestTextureLayout();
+void TestThreadSlotCache();
+
+// benchmarks
+void BenchBitmapAllocator();
+void BenchBuddyAllocator();
+void BenchConstantBufferLayout();
+void BenchCopyEngine();
+void BenchRadixSort();
+void BenchShadowBuffer();
+void BenchThreadSlotCache();
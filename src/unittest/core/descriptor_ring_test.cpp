@@ -0,0 +1,157 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "../../takoyaki/utility/descriptor_ring.h"
+
+using Takoyaki::DescriptorRing;
+using Takoyaki::RING_INVALID;
+
+namespace
+{
+    void TestWraparound()
+    {
+        DescriptorRing ring{ 10 };
+        uint64_t first, second, third, fourth;
+
+        CORE_CHECK(ring.allocate(4, first) == 0);
+        CORE_CHECK(ring.allocate(4, second) == 4);
+        CORE_CHECK(ring.allocate(3, third) == RING_INVALID);
+
+        // blocks are retired in order, a pending block holds back the ones after it
+        ring.setFence(second, 5);
+        ring.retire(100);
+        CORE_CHECK(ring.getNumFree() == 2);
+
+        ring.setFence(first, 3);
+        ring.retire(2);
+        CORE_CHECK(ring.getNumFree() == 2);
+        ring.retire(4);
+        CORE_CHECK(ring.getNumFree() == 6);
+
+        // 3 slots do not fit before the end, the 2 skipped ones are charged to the block
+        CORE_CHECK(ring.allocate(3, third) == 0);
+        CORE_CHECK(ring.getNumFree() == 1);
+        CORE_CHECK(ring.allocate(1, fourth) == 3);
+        CORE_CHECK(ring.getNumFree() == 0);
+
+        ring.setFence(third, 6);
+        ring.setFence(fourth, 6);
+        ring.retire(6);
+        CORE_CHECK(ring.getNumFree() == 10);
+
+        // an empty ring starts over so the whole capacity is contiguous again
+        CORE_CHECK(ring.allocate(10, first) == 0);
+    }
+
+    void TestErrors()
+    {
+        DescriptorRing ring{ 8 };
+        uint64_t ticket;
+
+        CORE_CHECK_THROW(DescriptorRing{ 0 });
+        CORE_CHECK_THROW(ring.allocate(0, ticket));
+        CORE_CHECK_THROW(ring.allocate(9, ticket));
+
+        CORE_CHECK(ring.allocate(2, ticket) == 0);
+        ring.setFence(ticket, 1);
+        ring.retire(1);
+
+        // retired and never given tickets
+        CORE_CHECK_THROW(ring.setFence(ticket, 2));
+        CORE_CHECK_THROW(ring.setFence(ticket + 1, 2));
+    }
+
+    void TestFrames()
+    {
+        // 3 frames in flight with random table sizes, live blocks must never overlap
+        const uint32_t capacity = 16384;
+        const uint32_t framesInFlight = 3;
+        DescriptorRing ring{ capacity };
+        std::vector<int> owner(capacity, -1);
+        std::deque<std::vector<std::pair<uint32_t, uint32_t>>> frames;
+        std::mt19937 rng{ 1 };
+        uint64_t fence = 0;
+        uint32_t failed = 0;
+
+        for (int frame = 0; frame < 5000; ++frame) {
+            std::vector<std::pair<uint32_t, uint32_t>> live;
+            std::vector<uint64_t> tickets;
+            uint32_t numTables = 50 + rng() % 300;
+
+            for (uint32_t i = 0; i < numTables; ++i) {
+                uint32_t count = 1 + rng() % 8;
+                uint64_t ticket;
+                auto offset = ring.allocate(count, ticket);
+
+                if (offset == RING_INVALID) {
+                    ++failed;
+                    break;
+                }
+
+                CORE_CHECK(offset + count <= capacity);
+
+                for (uint32_t k = 0; k < count; ++k) {
+                    CORE_CHECK(owner[offset + k] == -1);
+                    owner[offset + k] = frame;
+                }
+
+                live.push_back(std::make_pair(offset, count));
+                tickets.push_back(ticket);
+            }
+
+            ++fence;
+
+            for (auto ticket : tickets)
+                ring.setFence(ticket, fence);
+
+            frames.push_back(std::move(live));
+
+            // the gpu completed the oldest frame
+            if (frames.size() == framesInFlight) {
+                for (auto& block : frames.front()) {
+                    for (uint32_t k = 0; k < block.second; ++k)
+                        owner[block.first + k] = -1;
+                }
+
+                frames.pop_front();
+                ring.retire(fence - framesInFlight + 1);
+            }
+        }
+
+        // at most 3 * 350 * 8 slots are live, it should never run out
+        CORE_CHECK(failed == 0);
+
+        ring.retire(fence);
+        CORE_CHECK(ring.getNumFree() == capacity);
+    }
+}
+
+void TestDescriptorRing()
+{
+    TestWraparound();
+    TestErrors();
+    TestFrames();
+}
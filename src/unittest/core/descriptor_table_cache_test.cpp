@@ -0,0 +1,134 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <vector>
+
+#include "../../takoyaki/utility/descriptor_table_cache.h"
+
+using Takoyaki::DescriptorTableCache;
+using Takoyaki::TABLE_CACHE_MISS;
+
+namespace
+{
+    void TestHitMiss()
+    {
+        DescriptorTableCache cache{ 8 };
+        std::vector<uint64_t> a = { 1, 2, 3 };
+        std::vector<uint64_t> b = { 1, 2, 4 };
+        uint64_t use;
+
+        CORE_CHECK(cache.find(a, use) == TABLE_CACHE_MISS);
+
+        auto offset = cache.insert(a, 4, use);
+
+        CORE_CHECK(offset == 0);
+        cache.setFence(use, 1);
+
+        // same words hit, a single different word misses
+        uint64_t hit;
+
+        CORE_CHECK(cache.find(a, hit) == offset);
+        CORE_CHECK(hit == use);
+        cache.setFence(hit, 2);
+        CORE_CHECK(cache.find(b, use) == TABLE_CACHE_MISS);
+        CORE_CHECK(cache.find({ 1, 2 }, use) == TABLE_CACHE_MISS);
+        CORE_CHECK((cache.getNumTables() == 1) && (cache.getNumUsed() == 4));
+
+        // every use takes exactly one fence
+        CORE_CHECK_THROW(cache.setFence(hit, 3));
+        CORE_CHECK_THROW(cache.setFence(42, 3));
+    }
+
+    void TestLRU()
+    {
+        DescriptorTableCache cache{ 8 };
+        std::vector<uint64_t> a = { 1 };
+        std::vector<uint64_t> b = { 2 };
+        std::vector<uint64_t> c = { 3 };
+        uint64_t use;
+
+        CORE_CHECK(cache.insert(a, 4, use) == 0);
+        cache.setFence(use, 1);
+        CORE_CHECK(cache.insert(b, 4, use) == 4);
+        cache.setFence(use, 1);
+        cache.retire(1);
+
+        // a is used again so b is now the least recently used
+        CORE_CHECK(cache.find(a, use) == 0);
+        cache.setFence(use, 0);
+
+        CORE_CHECK(cache.insert(c, 4, use) == 4);
+        cache.setFence(use, 0);
+        CORE_CHECK(cache.find(b, use) == TABLE_CACHE_MISS);
+        CORE_CHECK(cache.find(a, use) == 0);
+        cache.setFence(use, 0);
+
+        // a larger table evicts as many as needed
+        std::vector<uint64_t> d = { 4 };
+
+        CORE_CHECK(cache.insert(d, 8, use) == 0);
+        CORE_CHECK(cache.getNumTables() == 1);
+    }
+
+    void TestInFlight()
+    {
+        DescriptorTableCache cache{ 8 };
+        std::vector<uint64_t> a = { 1, 2, 3 };
+        std::vector<uint64_t> b = { 1, 2, 4 };
+        std::vector<uint64_t> d = { 9 };
+        std::vector<uint64_t> e = { 7 };
+        uint64_t use;
+        uint64_t useB;
+
+        cache.insert(a, 4, use);
+        cache.setFence(use, 5);
+        CORE_CHECK(cache.find(a, use) == 0);
+        cache.setFence(use, 6);
+        CORE_CHECK(cache.insert(b, 4, useB) == 4);
+
+        // full, a is still read by the GPU and b is being recorded
+        CORE_CHECK(cache.insert(d, 1, use) == TABLE_CACHE_MISS);
+
+        // a only goes once its last fence completed
+        cache.retire(5);
+        CORE_CHECK(cache.insert(d, 1, use) == TABLE_CACHE_MISS);
+        cache.retire(6);
+        CORE_CHECK(cache.insert(d, 1, use) == 0);
+        cache.setFence(use, 8);
+        CORE_CHECK(cache.find(a, use) == TABLE_CACHE_MISS);
+
+        // b has a use without fence and d is in flight
+        CORE_CHECK(cache.insert(e, 4, use) == TABLE_CACHE_MISS);
+        cache.setFence(useB, 7);
+        cache.retire(7);
+        CORE_CHECK(cache.insert(e, 4, use) == 1);
+        CORE_CHECK(cache.find(b, use) == TABLE_CACHE_MISS);
+        CORE_CHECK(cache.find(d, use) == 0);
+    }
+}
+
+void TestDescriptorTableCache()
+{
+    TestHitMiss();
+    TestLRU();
+    TestInFlight();
+}
@@ -0,0 +1,129 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "../../takoyaki/utility/fenced_index_allocator.h"
+
+using Takoyaki::BITMAP_INVALID;
+using Takoyaki::FencedIndexAllocator;
+
+namespace
+{
+    void TestFenceGated()
+    {
+        FencedIndexAllocator allocator{ 4 };
+
+        for (uint32_t i = 0; i < 4; ++i)
+            CORE_CHECK(allocator.allocate() == i);
+
+        CORE_CHECK(allocator.allocate() == BITMAP_INVALID);
+
+        // released indices stay used until their fence completed
+        allocator.release(1, 10);
+        allocator.release(3, 12);
+        CORE_CHECK((allocator.getNumUsed() == 4) && (allocator.getNumPending() == 2));
+        CORE_CHECK(allocator.allocate() == BITMAP_INVALID);
+
+        allocator.retire(9);
+        CORE_CHECK(allocator.allocate() == BITMAP_INVALID);
+
+        allocator.retire(10);
+        CORE_CHECK((allocator.getNumUsed() == 3) && (allocator.getNumPending() == 1));
+        CORE_CHECK(allocator.allocate() == 1);
+        CORE_CHECK(allocator.allocate() == BITMAP_INVALID);
+
+        allocator.retire(100);
+        CORE_CHECK(allocator.getNumPending() == 0);
+        CORE_CHECK(allocator.allocate() == 3);
+    }
+
+    void TestDoubleRelease()
+    {
+        FencedIndexAllocator allocator{ 8 };
+        auto index = allocator.allocate();
+
+        allocator.release(index, 1);
+
+        // pending, retired, never allocated and out of range
+        CORE_CHECK_THROW(allocator.release(index, 2));
+        CORE_CHECK(allocator.getNumPending() == 1);
+
+        allocator.retire(1);
+        CORE_CHECK_THROW(allocator.release(index, 3));
+        CORE_CHECK_THROW(allocator.release(5, 3));
+        CORE_CHECK_THROW(allocator.release(8, 3));
+
+        // allocated again, it can be released again
+        CORE_CHECK(allocator.allocate() == index);
+        allocator.release(index, 4);
+        CORE_CHECK(allocator.getNumPending() == 1);
+    }
+
+    void TestFrames()
+    {
+        // 3 frames in flight, an index released during frame n must not come back before frame n completed
+        const uint32_t framesInFlight = 3;
+        FencedIndexAllocator allocator{ 256 };
+        std::vector<uint64_t> releasedAt(256, 0);
+        std::vector<uint32_t> live;
+        std::mt19937 rng{ 11 };
+
+        for (uint64_t frame = framesInFlight; frame < 5000; ++frame) {
+            auto completed = frame - framesInFlight;
+
+            allocator.retire(completed);
+
+            for (uint32_t i = rng() % 8; i > 0; --i) {
+                auto index = allocator.allocate();
+
+                if (index == BITMAP_INVALID)
+                    break;
+
+                CORE_CHECK(releasedAt[index] <= completed);
+                live.push_back(index);
+            }
+
+            for (uint32_t i = rng() % 8; (i > 0) && !live.empty(); --i) {
+                auto pick = rng() % live.size();
+                auto index = live[pick];
+
+                live[pick] = live.back();
+                live.pop_back();
+                allocator.release(index, frame);
+                releasedAt[index] = frame;
+            }
+        }
+
+        allocator.retire(UINT64_MAX);
+        CORE_CHECK(allocator.getNumUsed() == live.size());
+    }
+}
+
+void TestFencedIndexAllocator()
+{
+    TestFenceGated();
+    TestDoubleRelease();
+    TestFrames();
+}
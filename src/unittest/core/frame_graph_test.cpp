@@ -0,0 +1,210 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "../../takoyaki/utility/frame_graph.h"
+
+using Takoyaki::FrameGraph;
+
+namespace
+{
+    // values of D3D12_RESOURCE_STATES, the graph does not care what they mean
+    constexpr uint32_t COMMON = 0;
+    constexpr uint32_t RENDER_TARGET = 0x4;
+    constexpr uint32_t PIXEL_SHADER_RESOURCE = 0x80;
+
+    uint32_t Position(const FrameGraph& graph, uint32_t pass)
+    {
+        auto& order = graph.getOrder();
+
+        return static_cast<uint32_t>(std::find(order.begin(), order.end(), pass) - order.begin());
+    }
+
+    void TestChain()
+    {
+        FrameGraph graph;
+        auto back = graph.addResource(COMMON, 0, false);
+        auto a = graph.addResource(COMMON, 1, true);
+        auto b = graph.addResource(COMMON, 1, true);
+        auto c = graph.addResource(COMMON, 1, true);
+        auto unused = graph.addResource(COMMON, 1, true);
+
+        auto p0 = graph.addPass();
+        graph.write(p0, a, RENDER_TARGET);
+        auto p1 = graph.addPass();
+        graph.read(p1, a, PIXEL_SHADER_RESOURCE);
+        graph.write(p1, b, RENDER_TARGET);
+        auto p2 = graph.addPass();
+        graph.write(p2, unused, RENDER_TARGET);
+        auto p3 = graph.addPass();
+        graph.read(p3, b, PIXEL_SHADER_RESOURCE);
+        graph.write(p3, c, RENDER_TARGET);
+        auto p4 = graph.addPass();
+        graph.read(p4, c, PIXEL_SHADER_RESOURCE);
+        graph.write(p4, back, RENDER_TARGET);
+
+        graph.compile();
+
+        // nothing reads what p2 writes
+        CORE_CHECK(graph.isCulled(p2));
+        CORE_CHECK(!graph.isCulled(p0) && !graph.isCulled(p1) && !graph.isCulled(p3) && !graph.isCulled(p4));
+        CORE_CHECK(graph.getOrder().size() == 4);
+        CORE_CHECK(graph.getPhysical(unused) == Takoyaki::FRAME_GRAPH_INVALID);
+
+        // producers always run before their consumers
+        CORE_CHECK(Position(graph, p0) < Position(graph, p1));
+        CORE_CHECK(Position(graph, p1) < Position(graph, p3));
+        CORE_CHECK(Position(graph, p3) < Position(graph, p4));
+
+        // a is dead after p1 and c is born at p3 so they share a slot, b overlaps both
+        CORE_CHECK(graph.getNumPhysical() == 2);
+        CORE_CHECK(graph.getPhysical(a) == graph.getPhysical(c));
+        CORE_CHECK(graph.getPhysical(a) != graph.getPhysical(b));
+        CORE_CHECK(graph.getPhysical(back) == Takoyaki::FRAME_GRAPH_INVALID);
+
+        // c inherits the state a left its slot in
+        auto& transitions = graph.getTransitions(p3);
+
+        CORE_CHECK(transitions.size() == 2);
+        CORE_CHECK((transitions[0].resource == b) && (transitions[0].before == RENDER_TARGET) && (transitions[0].after == PIXEL_SHADER_RESOURCE));
+        CORE_CHECK((transitions[1].resource == c) && (transitions[1].before == PIXEL_SHADER_RESOURCE) && (transitions[1].after == RENDER_TARGET));
+        CORE_CHECK(graph.getTransitions(p0).size() == 1);
+        CORE_CHECK(graph.getTransitions(p0)[0].before == COMMON);
+    }
+
+    void TestPoolKeys()
+    {
+        FrameGraph graph;
+        auto back = graph.addResource(COMMON, 0, false);
+        auto a = graph.addResource(COMMON, 1, true);
+        auto b = graph.addResource(COMMON, 1, true);
+        auto c = graph.addResource(COMMON, 2, true);
+
+        auto p0 = graph.addPass();
+        graph.write(p0, a, RENDER_TARGET);
+        auto p1 = graph.addPass();
+        graph.read(p1, a, PIXEL_SHADER_RESOURCE);
+        graph.write(p1, b, RENDER_TARGET);
+        auto p2 = graph.addPass();
+        graph.read(p2, b, PIXEL_SHADER_RESOURCE);
+        graph.write(p2, c, RENDER_TARGET);
+        auto p3 = graph.addPass();
+        graph.read(p3, c, PIXEL_SHADER_RESOURCE);
+        graph.write(p3, back, RENDER_TARGET);
+
+        graph.compile();
+
+        // c has disjoint lifetime with a but a different description
+        CORE_CHECK(graph.getNumPhysical() == 3);
+        CORE_CHECK(graph.getPhysical(a) != graph.getPhysical(c));
+        CORE_CHECK(graph.getPhysical(b) != graph.getPhysical(c));
+    }
+
+    void TestOutputs()
+    {
+        FrameGraph graph;
+        auto a = graph.addResource(COMMON, 1, true);
+        auto b = graph.addResource(COMMON, 1, true);
+
+        auto p0 = graph.addPass();
+        graph.write(p0, a, RENDER_TARGET);
+        auto p1 = graph.addPass();
+        graph.write(p1, b, RENDER_TARGET);
+
+        // without any output everything is culled
+        graph.compile();
+        CORE_CHECK(graph.getOrder().empty());
+        CORE_CHECK(graph.getNumPhysical() == 0);
+
+        graph.markOutput(b);
+        graph.compile();
+        CORE_CHECK(graph.isCulled(p0) && !graph.isCulled(p1));
+        CORE_CHECK(graph.getNumPhysical() == 1);
+
+        // compile can be called again with the same result
+        graph.compile();
+        CORE_CHECK(graph.getOrder().size() == 1 && graph.getOrder()[0] == p1);
+
+        graph.clear();
+        CORE_CHECK((graph.getNumPasses() == 0) && (graph.getNumResources() == 0));
+    }
+
+    void TestInterleave()
+    {
+        // two independent chains, running the roots first keeps consumers away from their producers
+        FrameGraph graph;
+        auto back = graph.addResource(COMMON, 0, false);
+        auto x0 = graph.addResource(COMMON, 1, true);
+        auto x1 = graph.addResource(COMMON, 1, true);
+        auto y0 = graph.addResource(COMMON, 1, true);
+        auto y1 = graph.addResource(COMMON, 1, true);
+
+        auto a0 = graph.addPass();
+        graph.write(a0, x0, RENDER_TARGET);
+        auto a1 = graph.addPass();
+        graph.read(a1, x0, PIXEL_SHADER_RESOURCE);
+        graph.write(a1, x1, RENDER_TARGET);
+        auto b0 = graph.addPass();
+        graph.write(b0, y0, RENDER_TARGET);
+        auto b1 = graph.addPass();
+        graph.read(b1, y0, PIXEL_SHADER_RESOURCE);
+        graph.write(b1, y1, RENDER_TARGET);
+        auto last = graph.addPass();
+        graph.read(last, x1, PIXEL_SHADER_RESOURCE);
+        graph.read(last, y1, PIXEL_SHADER_RESOURCE);
+        graph.write(last, back, RENDER_TARGET);
+
+        graph.compile();
+
+        auto& order = graph.getOrder();
+
+        CORE_CHECK(order.size() == 5);
+        CORE_CHECK((order[0] == a0) && (order[1] == b0));
+        CORE_CHECK(Position(graph, a1) < Position(graph, last));
+        CORE_CHECK(Position(graph, b1) < Position(graph, last));
+        CORE_CHECK(order[4] == last);
+    }
+
+    void TestConflictingStates()
+    {
+        FrameGraph graph;
+        auto a = graph.addResource(COMMON, 1, true);
+        auto pass = graph.addPass();
+
+        graph.read(pass, a, PIXEL_SHADER_RESOURCE);
+        graph.write(pass, a, RENDER_TARGET);
+        graph.markOutput(a);
+
+        CORE_CHECK_THROW(graph.compile());
+    }
+}
+
+void TestFrameGraph()
+{
+    TestChain();
+    TestPoolKeys();
+    TestOutputs();
+    TestInterleave();
+    TestConflictingStates();
+}
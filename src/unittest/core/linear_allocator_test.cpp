@@ -0,0 +1,100 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "../../takoyaki/utility/linear_allocator.h"
+
+using Takoyaki::LinearAllocator;
+using Takoyaki::LINEAR_INVALID;
+
+void TestLinearAllocator()
+{
+    CORE_CHECK_THROW(LinearAllocator(1024, 0));
+    CORE_CHECK_THROW(LinearAllocator(1024, 48));
+
+    // every offset is aligned, sizes are rounded up
+    LinearAllocator allocator{ 1024, 256 };
+
+    CORE_CHECK(allocator.allocate(1) == 0);
+    CORE_CHECK(allocator.allocate(256) == 256);
+    CORE_CHECK(allocator.allocate(257) == 512);
+    CORE_CHECK(allocator.getNumUsed() == 1024);
+
+    // full, every allocation fails and used never goes past the capacity
+    CORE_CHECK(allocator.allocate(1) == LINEAR_INVALID);
+    CORE_CHECK(allocator.allocate(4) == LINEAR_INVALID);
+    CORE_CHECK(allocator.getNumUsed() == 1024);
+
+    // zero sized allocations are rejected rather than aliasing the next one
+    allocator.reset();
+    CORE_CHECK(allocator.allocate(0) == LINEAR_INVALID);
+
+    // one frame's page is reused from the start once reset
+    CORE_CHECK(allocator.allocate(16) == 0);
+    CORE_CHECK(allocator.getNumUsed() == 256);
+    allocator.reset();
+    CORE_CHECK(allocator.getNumUsed() == 0);
+    CORE_CHECK(allocator.allocate(1024) == 0);
+    CORE_CHECK(allocator.allocate(1) == LINEAR_INVALID);
+
+    // larger than the page
+    allocator.reset();
+    CORE_CHECK(allocator.allocate(2048) == LINEAR_INVALID);
+
+    // several threads allocating at once never get overlapping blocks
+    const uint32_t numThreads = 4;
+    const uint32_t numAllocs = 10000;
+    LinearAllocator shared{ numThreads * numAllocs * 64 / 2, 64 };
+    std::vector<std::vector<uint64_t>> offsets(numThreads);
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&shared, &offsets, t]()
+        {
+            for (uint32_t i = 0; i < numAllocs; ++i) {
+                auto offset = shared.allocate(1 + (i % 64));
+
+                if (offset != LINEAR_INVALID)
+                    offsets[t].push_back(offset);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    std::vector<uint64_t> all;
+
+    for (auto& list : offsets)
+        all.insert(all.end(), list.begin(), list.end());
+
+    std::sort(all.begin(), all.end());
+
+    CORE_CHECK(all.size() == numThreads * numAllocs / 2);
+    CORE_CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+
+    for (size_t i = 0; i < all.size(); ++i)
+        CORE_CHECK(all[i] == i * 64);
+}
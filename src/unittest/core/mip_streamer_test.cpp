@@ -0,0 +1,191 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <random>
+#include <vector>
+
+#include "../../takoyaki/utility/mip_streamer.h"
+
+using Takoyaki::MipStreamer;
+using Takoyaki::MIP_INVALID;
+
+namespace
+{
+    const std::vector<uint64_t> mipSizes = { 1 << 20, 1 << 18, 1 << 16, 1 << 14, 1 << 12, 512, 512 };
+
+    void TestTail()
+    {
+        CORE_CHECK(MipStreamer::getTailStart(mipSizes, 64 * 1024) == 3);
+        CORE_CHECK(MipStreamer::getTailStart(mipSizes, 1 << 14) == 4);
+
+        // the smallest mip is always in the tail, the whole chain when it fits
+        CORE_CHECK(MipStreamer::getTailStart(mipSizes, 0) == 6);
+        CORE_CHECK(MipStreamer::getTailStart(mipSizes, 1ull << 30) == 0);
+        CORE_CHECK(MipStreamer::getTailStart({ 1 << 20 }, 10) == 0);
+    }
+
+    void TestSchedule()
+    {
+        MipStreamer streamer{ 300000 };
+        std::vector<MipStreamer::Request> requests;
+
+        streamer.add(1, mipSizes, 3);
+        streamer.add(2, mipSizes, 4);
+
+        // fully resident textures are not tracked
+        streamer.add(3, mipSizes, 0);
+        CORE_CHECK(!streamer.isStreaming(3));
+        CORE_CHECK_THROW(streamer.add(4, mipSizes, 8));
+
+        // smallest first, one mip per texture in flight
+        streamer.schedule(requests);
+        CORE_CHECK(requests.size() == 2);
+        CORE_CHECK((requests[0].id == 2) && (requests[0].mip == 3) && (requests[0].sizeByte == 1 << 14));
+        CORE_CHECK((requests[1].id == 1) && (requests[1].mip == 2));
+
+        requests.clear();
+        streamer.schedule(requests);
+        CORE_CHECK(requests.empty());
+
+        CORE_CHECK(streamer.onLoaded(2, 3) == 3);
+        streamer.schedule(requests);
+        CORE_CHECK((requests.size() == 1) && (requests[0].id == 2) && (requests[0].mip == 2));
+
+        // only the requested mip can complete
+        CORE_CHECK_THROW(streamer.onLoaded(2, 0));
+        CORE_CHECK_THROW(streamer.onLoaded(1, 1));
+
+        // a mip over the budget still goes when it is the first one
+        streamer.onLoaded(1, 2);
+        streamer.onLoaded(2, 2);
+        requests.clear();
+        streamer.schedule(requests);
+        CORE_CHECK((requests.size() == 1) && (requests[0].id == 1) && (requests[0].mip == 1));
+
+        // each texture gains one mip per completion and is forgotten once complete
+        int frames = 0;
+
+        while ((streamer.getNumStreaming() > 0) && (frames < 100)) {
+            for (auto& request : requests)
+                streamer.onLoaded(request.id, request.mip);
+
+            requests.clear();
+            streamer.schedule(requests);
+            ++frames;
+        }
+
+        CORE_CHECK((streamer.getNumStreaming() == 0) && (frames < 10));
+    }
+
+    void TestRemove()
+    {
+        MipStreamer streamer{ 1 << 20 };
+        std::vector<MipStreamer::Request> requests;
+
+        streamer.add(5, mipSizes, 6);
+        streamer.add(6, mipSizes, 6);
+        streamer.schedule(requests);
+        CORE_CHECK(requests.size() == 2);
+
+        // removed while its upload is in flight, the completion is ignored and nothing is scheduled again
+        streamer.remove(5);
+        CORE_CHECK(!streamer.isStreaming(5));
+        CORE_CHECK(streamer.onLoaded(5, 5) == MIP_INVALID);
+        CORE_CHECK(streamer.onLoaded(6, 5) == 5);
+
+        requests.clear();
+        streamer.schedule(requests);
+        CORE_CHECK((requests.size() == 1) && (requests[0].id == 6));
+
+        // removing an unknown or already removed texture is fine
+        streamer.remove(5);
+        streamer.remove(42);
+
+        // removed before it was ever scheduled
+        CORE_CHECK(streamer.onLoaded(6, 4) == 4);
+        streamer.add(7, mipSizes, 3);
+        streamer.remove(7);
+        requests.clear();
+        streamer.schedule(requests);
+        CORE_CHECK((requests.size() == 1) && (requests[0].id == 6) && (requests[0].mip == 3));
+    }
+
+    void TestRandom()
+    {
+        // every request is the next mip of its texture and the total stays in the budget unless alone
+        const uint64_t budget = 1 << 20;
+        std::mt19937 rng{ 3 };
+        MipStreamer streamer{ budget };
+        std::vector<uint32_t> resident(200);
+        std::vector<MipStreamer::Request> inFlight;
+
+        for (uint32_t id = 0; id < resident.size(); ++id) {
+            std::vector<uint64_t> sizes;
+            uint32_t numMips = rng() % 12 + 1;
+
+            for (uint32_t mip = 0; mip < numMips; ++mip)
+                sizes.push_back(4ull << (2 * (numMips - mip)));
+
+            resident[id] = MipStreamer::getTailStart(sizes, 4096);
+            streamer.add(id, sizes, resident[id]);
+        }
+
+        for (int frame = 0; (frame < 10000) && (streamer.getNumStreaming() > 0); ++frame) {
+            std::vector<MipStreamer::Request> requests;
+            uint64_t total = 0;
+
+            streamer.schedule(requests);
+
+            for (auto& request : requests) {
+                CORE_CHECK(request.mip + 1 == resident[request.id]);
+                total += request.sizeByte;
+                inFlight.push_back(request);
+            }
+
+            CORE_CHECK((requests.size() <= 1) || (total <= budget));
+
+            // the GPU completes about half of the uploads each frame
+            for (size_t i = 0; i < inFlight.size();) {
+                if (rng() & 1) {
+                    resident[inFlight[i].id] = inFlight[i].mip;
+                    streamer.onLoaded(inFlight[i].id, inFlight[i].mip);
+                    inFlight.erase(inFlight.begin() + i);
+                } else {
+                    ++i;
+                }
+            }
+        }
+
+        CORE_CHECK(streamer.getNumStreaming() == 0);
+
+        for (auto mip : resident)
+            CORE_CHECK(mip == 0);
+    }
+}
+
+void TestMipStreamer()
+{
+    TestTail();
+    TestSchedule();
+    TestRemove();
+    TestRandom();
+}
@@ -0,0 +1,158 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../../takoyaki/utility/radix_sort.h"
+
+using Takoyaki::RadixSorter;
+using Takoyaki::SortItem;
+
+namespace
+{
+    // helpers get their own thread, joined once the sort returned
+    class ThreadDispatch
+    {
+    public:
+        ~ThreadDispatch() { join(); }
+
+        RadixSorter::DispatchFunc get()
+        {
+            return [this](std::function<void()> func) { threads_.emplace_back(std::move(func)); };
+        }
+
+        void join()
+        {
+            for (auto& thread : threads_)
+                thread.join();
+
+            threads_.clear();
+        }
+
+    private:
+        std::vector<std::thread> threads_;
+    };
+
+    // keys like the ones built from sort_key.h, few distinct values per field
+    std::vector<SortItem> MakeKeys(size_t count, uint64_t mask, uint32_t seed)
+    {
+        std::mt19937_64 rng{ seed };
+        std::vector<SortItem> res(count);
+
+        for (size_t i = 0; i < count; ++i)
+            res[i] = { rng() & mask, static_cast<uint32_t>(i) };
+
+        return res;
+    }
+
+    void StableSort(std::vector<SortItem>& items)
+    {
+        std::stable_sort(items.begin(), items.end(), [](const SortItem& lhs, const SortItem& rhs) { return lhs.key < rhs.key; });
+    }
+
+    bool Equal(const std::vector<SortItem>& lhs, const std::vector<SortItem>& rhs)
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const SortItem& l, const SortItem& r) { return (l.key == r.key) && (l.index == r.index); });
+    }
+}
+
+void TestRadixSort()
+{
+    // every byte used, only a few bytes used so passes are skipped, heavy duplicates to check stability
+    const uint64_t masks[] = { UINT64_MAX, 0xFF00000000000F00ull, 0x3ull };
+
+    for (auto mask : masks) {
+        for (size_t count : { 0, 1, 2, 17, 1000, 70000 }) {
+            auto items = MakeKeys(count, mask, static_cast<uint32_t>(count));
+            auto expected = items;
+            std::vector<SortItem> scratch(count);
+
+            StableSort(expected);
+            Takoyaki::RadixSort(items.data(), scratch.data(), count);
+
+            CORE_CHECK(Equal(items, expected));
+        }
+    }
+
+    // already sorted stays untouched
+    std::vector<SortItem> items(256);
+    std::vector<SortItem> scratch(256);
+
+    for (uint32_t i = 0; i < 256; ++i)
+        items[i] = { i, i };
+
+    auto expected = items;
+
+    Takoyaki::RadixSort(items.data(), scratch.data(), items.size());
+    CORE_CHECK(Equal(items, expected));
+
+    // split across helpers, sizes around the threshold and a partial last chunk
+    ThreadDispatch dispatch;
+    RadixSorter sorter;
+
+    sorter.initialize(dispatch.get(), 3);
+
+    for (auto mask : masks) {
+        for (size_t count : { 1000, 65535, 65536, 200001 }) {
+            auto items = MakeKeys(count, mask, static_cast<uint32_t>(count) + 1);
+            auto expected = items;
+            std::vector<SortItem> scratch(count);
+
+            StableSort(expected);
+            sorter.sort(items.data(), scratch.data(), count);
+            dispatch.join();
+
+            CORE_CHECK(Equal(items, expected));
+        }
+    }
+}
+
+void BenchRadixSort()
+{
+    ThreadDispatch dispatch;
+    RadixSorter sorter;
+    auto numHelpers = (std::max)(std::thread::hardware_concurrency(), 2u) - 1;
+
+    sorter.initialize(dispatch.get(), numHelpers);
+
+    // pass and pipeline fields set, material and depth random
+    for (size_t count : { 1000, 100000, 1000000 }) {
+        auto items = MakeKeys(count, 0xFFFF00000000FFFFull, 1);
+        auto sorted = items;
+        std::vector<SortItem> scratch(count);
+
+        auto stableMs = MeasureMs([&]() { StableSort(sorted); });
+        auto parallel = items;
+        auto radixMs = MeasureMs([&]() { Takoyaki::RadixSort(items.data(), scratch.data(), count); });
+        auto parallelMs = MeasureMs([&]() { sorter.sort(parallel.data(), scratch.data(), count); });
+
+        dispatch.join();
+
+        auto fmt = boost::format("  %1% keys: std::stable_sort %2$.2f ms, radix %3$.2f ms, radix with %4% helpers %5$.2f ms") % count % stableMs % radixMs % numHelpers % parallelMs;
+
+        std::cout << boost::str(fmt) << std::endl;
+    }
+}
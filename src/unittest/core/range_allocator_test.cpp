@@ -0,0 +1,160 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../takoyaki/utility/range_allocator.h"
+
+using Takoyaki::RangeAllocator;
+using Takoyaki::RANGE_INVALID;
+
+namespace
+{
+    void TestBestFit()
+    {
+        RangeAllocator allocator{ 128 };
+        auto x = allocator.allocate(10);
+        auto y = allocator.allocate(20);
+        auto z = allocator.allocate(30);
+
+        CORE_CHECK((x == 0) && (y == 10) && (z == 30));
+
+        // the 20 slots hole is a better fit than the tail
+        allocator.free(y, 20);
+        CORE_CHECK(allocator.getNumFreeBlocks() == 2);
+        CORE_CHECK(allocator.allocate(5) == 10);
+
+        CORE_CHECK(allocator.allocate(129) == RANGE_INVALID);
+        CORE_CHECK_THROW(allocator.allocate(0));
+    }
+
+    void TestCoalesce()
+    {
+        RangeAllocator allocator{ 128 };
+        auto a = allocator.allocate(10);
+        auto b = allocator.allocate(20);
+        auto c = allocator.allocate(30);
+
+        // with the block after
+        allocator.free(b, 20);
+        allocator.free(a, 10);
+        CORE_CHECK((allocator.getNumFreeBlocks() == 2) && (allocator.getLargestFree() == 68));
+
+        // with the blocks before and after at once
+        allocator.free(c, 30);
+        CORE_CHECK((allocator.getNumFreeBlocks() == 1) && (allocator.getNumFree() == 128) && (allocator.getLargestFree() == 128));
+
+        // double free and ranges overlapping a free block
+        CORE_CHECK_THROW(allocator.free(0, 1));
+
+        a = allocator.allocate(64);
+        CORE_CHECK_THROW(allocator.free(60, 8));
+        CORE_CHECK_THROW(allocator.free(120, 16));
+        allocator.free(a, 64);
+        CORE_CHECK(allocator.getNumFreeBlocks() == 1);
+    }
+
+    void TestFragmented()
+    {
+        // every other slot free, half the heap is free but no two slots are contiguous
+        RangeAllocator allocator{ 64 };
+
+        for (uint32_t i = 0; i < 64; ++i)
+            CORE_CHECK(allocator.allocate(1) == i);
+
+        CORE_CHECK(allocator.allocate(1) == RANGE_INVALID);
+
+        for (uint32_t i = 0; i < 64; i += 2)
+            allocator.free(i, 1);
+
+        CORE_CHECK((allocator.getNumFree() == 32) && (allocator.getNumFreeBlocks() == 32) && (allocator.getLargestFree() == 1));
+        CORE_CHECK(allocator.allocate(2) == RANGE_INVALID);
+        CORE_CHECK(allocator.allocate(1) != RANGE_INVALID);
+
+        // freeing a neighbour makes room again
+        allocator.free(3, 1);
+        CORE_CHECK(allocator.allocate(3) == 2);
+    }
+
+    void TestRandom()
+    {
+        // 1M random alloc/free of 1..16 slots in a 64k heap, checked against an occupancy map
+        const uint32_t capacity = 65536;
+        RangeAllocator allocator{ capacity };
+        std::vector<bool> used(capacity, false);
+        std::vector<std::pair<uint32_t, uint32_t>> live;
+        std::mt19937 rng{ 3 };
+        uint32_t numUsed = 0;
+
+        for (int i = 0; i < 1000000; ++i) {
+            if (live.empty() || (rng() & 1)) {
+                uint32_t count = 1 + rng() % 16;
+                auto offset = allocator.allocate(count);
+
+                if (offset == RANGE_INVALID) {
+                    CORE_CHECK(allocator.getLargestFree() < count);
+                    continue;
+                }
+
+                CORE_CHECK(offset + count <= capacity);
+
+                for (uint32_t k = 0; k < count; ++k) {
+                    CORE_CHECK(!used[offset + k]);
+                    used[offset + k] = true;
+                }
+
+                numUsed += count;
+                live.push_back(std::make_pair(offset, count));
+            } else {
+                auto pick = rng() % live.size();
+                auto range = live[pick];
+
+                live[pick] = live.back();
+                live.pop_back();
+                allocator.free(range.first, range.second);
+
+                for (uint32_t k = 0; k < range.second; ++k)
+                    used[range.first + k] = false;
+
+                numUsed -= range.second;
+            }
+
+            CORE_CHECK(allocator.getNumFree() == capacity - numUsed);
+        }
+
+        // everything coalesces back into one block
+        for (auto& range : live)
+            allocator.free(range.first, range.second);
+
+        CORE_CHECK((allocator.getNumFreeBlocks() == 1) && (allocator.getLargestFree() == capacity));
+    }
+}
+
+void TestRangeAllocator()
+{
+    TestBestFit();
+    TestCoalesce();
+    TestFragmented();
+    TestRandom();
+}
@@ -0,0 +1,127 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <vector>
+
+#include "../../takoyaki/utility/resource_state_tracker.h"
+
+using Takoyaki::ResourceStateResolver;
+using Takoyaki::ResourceStateTracker;
+using Takoyaki::ResourceTransition;
+
+namespace
+{
+    // values of D3D12_RESOURCE_STATES, the tracker does not care what they mean
+    constexpr uint32_t PRESENT = 0;
+    constexpr uint32_t RENDER_TARGET = 0x4;
+    constexpr uint32_t COPY_DEST = 0x400;
+    constexpr uint32_t COPY_SOURCE = 0x800;
+
+    bool IsTransition(const ResourceTransition& transition, void* resource, uint32_t before, uint32_t after)
+    {
+        return (transition.resource == resource) && (transition.before == before) && (transition.after == after);
+    }
+}
+
+void TestResourceStateTracker()
+{
+    int a, b;
+    void* texA = &a;
+    void* texB = &b;
+    ResourceStateTracker tracker;
+    std::vector<ResourceTransition> out;
+
+    // first use is left to the resolver, using it again in the same state is free
+    tracker.transition(texA, PRESENT, RENDER_TARGET);
+    tracker.flush(out);
+    CORE_CHECK(out.empty());
+
+    tracker.transition(texA, PRESENT, RENDER_TARGET);
+    CORE_CHECK(!tracker.hasPending());
+
+    // only the resource that actually changes gets a barrier
+    tracker.transition(texA, PRESENT, COPY_SOURCE);
+    tracker.transition(texB, COPY_DEST, COPY_DEST);
+    tracker.flush(out);
+    CORE_CHECK(out.size() == 1);
+    CORE_CHECK(IsTransition(out[0], texA, RENDER_TARGET, COPY_SOURCE));
+
+    // going somewhere and back before a flush cancels out
+    out.clear();
+    tracker.transition(texA, PRESENT, COPY_DEST);
+    tracker.transition(texA, PRESENT, COPY_SOURCE);
+    tracker.flush(out);
+    CORE_CHECK(out.empty());
+
+    // consecutive requests are merged into a single barrier
+    tracker.transition(texA, PRESENT, COPY_DEST);
+    tracker.transition(texA, PRESENT, RENDER_TARGET);
+    tracker.flush(out);
+    CORE_CHECK(out.size() == 1);
+    CORE_CHECK(IsTransition(out[0], texA, COPY_SOURCE, RENDER_TARGET));
+
+    auto& entries = tracker.getEntries();
+
+    CORE_CHECK(entries.size() == 2);
+    CORE_CHECK((entries[0].first == RENDER_TARGET) && (entries[0].current == RENDER_TARGET));
+
+    // the resolver moves the resource from its home state to what the list expects
+    ResourceStateResolver resolver;
+
+    out.clear();
+    resolver.resolve(tracker, out);
+    CORE_CHECK(out.size() == 1);
+    CORE_CHECK(IsTransition(out[0], texA, PRESENT, RENDER_TARGET));
+
+    // a second list starting in the state the first one ended with needs nothing
+    ResourceStateTracker second;
+
+    out.clear();
+    second.transition(texA, PRESENT, RENDER_TARGET);
+    resolver.resolve(second, out);
+    CORE_CHECK(out.empty());
+
+    // end of frame goes back home once
+    resolver.restore(out);
+    CORE_CHECK(out.size() == 1);
+    CORE_CHECK(IsTransition(out[0], texA, RENDER_TARGET, PRESENT));
+
+    out.clear();
+    resolver.restore(out);
+    CORE_CHECK(out.empty());
+
+    // cleared trackers start over
+    tracker.clear();
+    CORE_CHECK(tracker.getEntries().empty() && !tracker.hasPending());
+
+    // a copy within one texture would ask for both copy states before the flush, only the last one
+    // is kept since subresources are not tracked, which is why CommandImpl rejects those copies
+    tracker.transition(texA, PRESENT, RENDER_TARGET);
+    tracker.flush(out);
+    tracker.transition(texA, PRESENT, COPY_DEST);
+    tracker.transition(texA, PRESENT, COPY_SOURCE);
+    tracker.flush(out);
+    CORE_CHECK(out.size() == 1);
+    CORE_CHECK(IsTransition(out[0], texA, RENDER_TARGET, COPY_SOURCE));
+    CORE_CHECK(tracker.getEntries().size() == 1);
+    CORE_CHECK(tracker.getEntries()[0].current == COPY_SOURCE);
+}
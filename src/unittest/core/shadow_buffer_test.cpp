@@ -0,0 +1,171 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../../takoyaki/utility/shadow_buffer.h"
+
+using Takoyaki::ShadowBuffer;
+using Takoyaki::SHADOW_BLOCK_SIZE;
+
+namespace
+{
+    // flush destinations must be 16 bytes aligned, keep them on a cache line like the upload heap
+    class AlignedBytes
+    {
+    public:
+        explicit AlignedBytes(size_t size)
+            : storage_(size + SHADOW_BLOCK_SIZE, 0)
+        {
+            void* ptr = storage_.data();
+            size_t space = storage_.size();
+
+            data_ = static_cast<uint8_t*>(std::align(SHADOW_BLOCK_SIZE, size, ptr, space));
+        }
+
+        inline uint8_t* get() { return data_; }
+
+    private:
+        std::vector<uint8_t> storage_;
+        uint8_t* data_;
+    };
+}
+
+void TestShadowBuffer()
+{
+    const uint32_t value = 0xdeadbeef;
+    ShadowBuffer buffer{ 4000, 3 };
+    std::vector<AlignedBytes> slots;
+
+    for (int i = 0; i < 3; ++i)
+        slots.emplace_back(4096);
+
+    CORE_CHECK(!buffer.isDirty(0));
+
+    // blocks 1 and 2 make one run, block 15 another
+    buffer.write(100, &value, 4);
+    buffer.write(130, &value, 4);
+    buffer.write(1000, &value, 4);
+    CORE_CHECK(buffer.isDirty(0) && buffer.isDirty(1) && buffer.isDirty(2));
+
+    CORE_CHECK(buffer.flush(0, slots[0].get()) == 3 * SHADOW_BLOCK_SIZE);
+    CORE_CHECK(!buffer.isDirty(0) && buffer.isDirty(1));
+    CORE_CHECK(std::memcmp(slots[0].get() + 100, &value, 4) == 0);
+    CORE_CHECK(std::memcmp(slots[0].get() + 1000, &value, 4) == 0);
+    CORE_CHECK(buffer.flush(0, slots[0].get()) == 0);
+
+    // other slots still get everything written since their last flush
+    CORE_CHECK(buffer.flush(1, slots[1].get()) == 3 * SHADOW_BLOCK_SIZE);
+    CORE_CHECK(std::memcmp(slots[1].get(), buffer.getData(), 4000) == 0);
+
+    // zero sized writes do nothing, out of range ones throw
+    buffer.write(0, &value, 0);
+    CORE_CHECK(!buffer.isDirty(0));
+    CORE_CHECK_THROW(buffer.write(3998, &value, 4));
+
+    // random writes with interleaved flushes against a reference copy
+    const uint32_t size = 4096;
+    ShadowBuffer random{ size, 1 };
+    std::vector<uint8_t> reference(size, 0);
+    AlignedBytes out{ size };
+    std::mt19937 rng{ 1 };
+
+    for (int i = 0; i < 1000; ++i) {
+        uint32_t offset = rng() % 4000;
+        uint32_t count = (std::min)(1 + static_cast<uint32_t>(rng() % 90), size - offset);
+        std::vector<uint8_t> data(count);
+
+        for (auto& byte : data)
+            byte = static_cast<uint8_t>(rng());
+
+        random.write(offset, data.data(), count);
+        std::memcpy(&reference[offset], data.data(), count);
+
+        if (rng() % 7 == 0)
+            random.flush(0, out.get());
+    }
+
+    random.flush(0, out.get());
+    CORE_CHECK(std::memcmp(out.get(), reference.data(), size) == 0);
+
+    // whole buffer streamed in order
+    AlignedBytes copy{ size };
+
+    Takoyaki::StreamCopy(copy.get(), reference.data(), size);
+    CORE_CHECK(std::memcmp(copy.get(), reference.data(), size) == 0);
+}
+
+void BenchShadowBuffer()
+{
+    // 64 KiB constant buffer, 200 scattered 16 bytes writes per frame
+    const uint32_t size = 65536;
+    const int numFrames = 1000;
+    std::vector<uint32_t> offsets(200);
+    std::mt19937 rng{ 1 };
+    AlignedBytes dst{ size };
+    float value[4] = { 1.f, 2.f, 3.f, 4.f };
+
+    for (auto& offset : offsets)
+        offset = (rng() % (size / 16)) * 16;
+
+    auto directMs = MeasureMs([&]()
+    {
+        for (int frame = 0; frame < numFrames; ++frame) {
+            for (auto offset : offsets) {
+                value[0] = static_cast<float>(frame);
+                std::memcpy(dst.get() + offset, value, sizeof(value));
+            }
+        }
+    });
+
+    ShadowBuffer shadow{ size, 1 };
+    size_t flushed = 0;
+
+    auto shadowMs = MeasureMs([&]()
+    {
+        for (int frame = 0; frame < numFrames; ++frame) {
+            for (auto offset : offsets) {
+                value[0] = static_cast<float>(frame);
+                shadow.write(offset, value, sizeof(value));
+            }
+
+            flushed += shadow.flush(0, dst.get());
+        }
+    });
+
+    // full rewrite every frame
+    std::vector<uint8_t> src(size, 1);
+
+    auto memcpyMs = MeasureMs([&]() { for (int frame = 0; frame < numFrames; ++frame) std::memcpy(dst.get(), src.data(), size); });
+    auto streamMs = MeasureMs([&]() { for (int frame = 0; frame < numFrames; ++frame) Takoyaki::StreamCopy(dst.get(), src.data(), size); });
+
+    auto fmt = boost::format("  scattered writes: direct %1$.2f ms, shadow + flush %2$.2f ms (%3% KiB flushed)") % directMs % shadowMs % (flushed / 1024);
+    auto fmtFull = boost::format("  full 64 KiB rewrite: memcpy %1$.2f ms, stream %2$.2f ms") % memcpyMs % streamMs;
+
+    std::cout << boost::str(fmt) << std::endl;
+    std::cout << boost::str(fmtFull) << std::endl;
+}
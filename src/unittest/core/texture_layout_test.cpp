@@ -0,0 +1,108 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <vector>
+
+#include "../../takoyaki/utility/texture_layout.h"
+
+using Takoyaki::CalcSubresource;
+using Takoyaki::GetFootprint;
+using Takoyaki::GetFootprintSize;
+using Takoyaki::GetMipChainLength;
+using Takoyaki::GetMipSize;
+using Takoyaki::SubresourceFootprint;
+using Takoyaki::TextureLayoutDesc;
+
+void TestTextureLayout()
+{
+    CORE_CHECK(GetMipChainLength(1, 1, 1) == 1);
+    CORE_CHECK(GetMipChainLength(256, 256, 1) == 9);
+    CORE_CHECK(GetMipChainLength(300, 17, 1) == 9);
+    CORE_CHECK(GetMipChainLength(4, 4, 64) == 7);
+
+    // RGBA8 array of 3, rows are padded to the pitch alignment
+    TextureLayoutDesc rgba{ 100, 60, 1, 3, 7, 4, 1 };
+    auto fp = GetFootprint(rgba, CalcSubresource(0, 0, 7));
+
+    CORE_CHECK((fp.rowSizeByte == 400) && (fp.rowPitch == 512) && (fp.numRows == 60) && (fp.depth == 1));
+
+    fp = GetFootprint(rgba, CalcSubresource(3, 2, 7));
+    CORE_CHECK((fp.width == 12) && (fp.height == 7) && (fp.rowSizeByte == 48) && (fp.rowPitch == 256));
+    CORE_CHECK(GetFootprint(rgba, 3, 1).rowPitch == 48);
+
+    // odd sizes round down and never go below 1
+    TextureLayoutDesc odd{ 13, 7, 1, 1, 4, 4, 1 };
+
+    fp = GetFootprint(odd, 1);
+    CORE_CHECK((fp.width == 6) && (fp.height == 3) && (fp.numRows == 3));
+    fp = GetFootprint(odd, 2);
+    CORE_CHECK((fp.width == 3) && (fp.height == 1) && (fp.rowSizeByte == 12));
+    fp = GetFootprint(odd, 3);
+    CORE_CHECK((fp.width == 1) && (fp.height == 1));
+
+    // volumes halve the depth too
+    TextureLayoutDesc volume{ 16, 16, 8, 1, 5, 4, 1 };
+
+    fp = GetFootprint(volume, 2);
+    CORE_CHECK((fp.width == 4) && (fp.height == 4) && (fp.depth == 2));
+    CORE_CHECK(GetFootprintSize(fp) == 256 * 4 * 2);
+    fp = GetFootprint(volume, 4);
+    CORE_CHECK((fp.width == 1) && (fp.depth == 1));
+
+    // BC1, 8 bytes per 4x4 block, mips smaller than a block still take a whole one
+    TextureLayoutDesc bc1{ 100, 60, 1, 1, 7, 8, 4 };
+
+    fp = GetFootprint(bc1, 0);
+    CORE_CHECK((fp.width == 100) && (fp.height == 60) && (fp.rowSizeByte == 200) && (fp.numRows == 15));
+    fp = GetFootprint(bc1, 2);
+    CORE_CHECK((fp.width == 28) && (fp.height == 16) && (fp.rowSizeByte == 56) && (fp.numRows == 4));
+    fp = GetFootprint(bc1, 5);
+    CORE_CHECK((fp.width == 4) && (fp.height == 4) && (fp.rowSizeByte == 8) && (fp.numRows == 1));
+    CORE_CHECK(GetFootprintSize(fp) == 256);
+
+    // BC3, 16 bytes per block, odd width
+    TextureLayoutDesc bc3{ 30, 10, 1, 1, 5, 16, 4 };
+
+    fp = GetFootprint(bc3, 0);
+    CORE_CHECK((fp.width == 32) && (fp.height == 12) && (fp.rowSizeByte == 128) && (fp.numRows == 3));
+
+    // placement like GetCopyableFootprints, every subresource aligned and after the previous one
+    std::vector<SubresourceFootprint> footprints;
+
+    for (uint32_t i = 0; i < 21; ++i)
+        footprints.push_back(GetFootprint(rgba, i));
+
+    auto end = Takoyaki::PlaceFootprints(footprints.data(), 21, 0);
+
+    for (uint32_t i = 0; i < 21; ++i) {
+        CORE_CHECK(footprints[i].offset % Takoyaki::TEXTURE_PLACEMENT_ALIGNMENT == 0);
+        CORE_CHECK((i == 0) || (footprints[i].offset >= footprints[i - 1].offset + GetFootprintSize(footprints[i - 1])));
+    }
+
+    CORE_CHECK(end == footprints[20].offset + GetFootprintSize(footprints[20]));
+
+    // a mip across every slice
+    CORE_CHECK(GetMipSize(rgba, 0) == 3ull * 512 * 60);
+    CORE_CHECK(GetMipSize(rgba, 6) == 3ull * 512);
+    CORE_CHECK(GetMipSize(bc1, 0) == 4096);
+    CORE_CHECK(GetMipSize(bc1, 6) == 512);
+}
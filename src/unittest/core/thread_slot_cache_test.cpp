@@ -0,0 +1,191 @@
+// Copyright(c) 2015-2016 Kitti Vongsay
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub license, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "core_test.h"
+
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../takoyaki/utility/bitmap_allocator.h"
+#include "../../takoyaki/utility/thread_slot_cache.h"
+
+using Takoyaki::BitmapAllocator;
+using Takoyaki::ThreadSlotCaches;
+
+namespace
+{
+    constexpr size_t BATCH_SIZE = 16;
+
+    // host side of DX12DescriptorHeapCollection single descriptors, a shared bitmap behind one mutex
+    class SlotPool
+    {
+    public:
+        explicit SlotPool(uint32_t capacity)
+            : slots_{ capacity }
+            , caches_{ BATCH_SIZE }
+        {
+        }
+
+        uint32_t allocateDirect()
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            return slots_.allocate();
+        }
+
+        void releaseDirect(uint32_t index)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            slots_.free(index);
+        }
+
+        uint32_t allocateCached()
+        {
+            return caches_.acquire([this](std::vector<uint32_t>& out, size_t count)
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+
+                for (size_t i = 0; i < count; ++i)
+                    out.push_back(slots_.allocate());
+            });
+        }
+
+        void releaseCached(uint32_t index)
+        {
+            caches_.release(index, [this](const std::vector<uint32_t>& released) { releaseBatch(released); });
+        }
+
+        void flushReleased()
+        {
+            caches_.flushAll([this](const std::vector<uint32_t>& released) { releaseBatch(released); });
+        }
+
+        inline size_t getNumReserved() { return caches_.getNumReserved(); }
+        inline uint32_t getNumFree() const { return slots_.getNumFree(); }
+
+    private:
+        void releaseBatch(const std::vector<uint32_t>& released)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+
+            for (auto index : released)
+                slots_.free(index);
+        }
+
+    private:
+        std::mutex mutex_;
+        BitmapAllocator slots_;
+        ThreadSlotCaches<uint32_t, uint32_t> caches_;
+    };
+
+    // each thread keeps up to 64 descriptors alive, like a loader creating and destroying textures
+    template <typename Allocate, typename Release>
+    void RunThreads(uint32_t numThreads, uint32_t numOps, Allocate&& allocate, Release&& release)
+    {
+        std::vector<std::thread> threads;
+
+        for (uint32_t t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&]()
+            {
+                std::vector<uint32_t> live;
+
+                live.reserve(64);
+
+                for (uint32_t i = 0; i < numOps; i += 64) {
+                    for (uint32_t k = 0; k < 64; ++k)
+                        live.push_back(allocate());
+
+                    for (auto index : live)
+                        release(index);
+
+                    live.clear();
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+}
+
+void TestThreadSlotCache()
+{
+    SlotPool pool{ 1024 };
+
+    // first acquire reserves a batch and hands it out in allocation order
+    CORE_CHECK(pool.allocateCached() == 0);
+    CORE_CHECK(pool.allocateCached() == 1);
+    CORE_CHECK(pool.getNumReserved() == BATCH_SIZE - 2);
+    CORE_CHECK(pool.getNumFree() == 1024 - BATCH_SIZE);
+
+    // less than a batch of releases stays in the cache until flushed
+    pool.releaseCached(0);
+    pool.releaseCached(1);
+    CORE_CHECK(pool.getNumReserved() == BATCH_SIZE);
+    CORE_CHECK(pool.getNumFree() == 1024 - BATCH_SIZE);
+
+    pool.flushReleased();
+    CORE_CHECK(pool.getNumReserved() == BATCH_SIZE - 2);
+    CORE_CHECK(pool.getNumFree() == 1024 - BATCH_SIZE + 2);
+
+    // a full batch is given back right away
+    std::vector<uint32_t> live;
+
+    for (size_t i = 0; i < BATCH_SIZE; ++i)
+        live.push_back(pool.allocateCached());
+
+    for (auto index : live)
+        pool.releaseCached(index);
+
+    CORE_CHECK(pool.getNumReserved() == BATCH_SIZE - 2);
+    CORE_CHECK(pool.getNumFree() + pool.getNumReserved() == 1024);
+
+    // several threads, every release must be back after a flush whatever the thread count
+    RunThreads(4, 1000, [&pool]() { return pool.allocateCached(); }, [&pool](uint32_t index) { pool.releaseCached(index); });
+    pool.flushReleased();
+    CORE_CHECK(pool.getNumFree() + pool.getNumReserved() == 1024);
+}
+
+void BenchThreadSlotCache()
+{
+    const uint32_t numOps = 200000;
+
+    for (uint32_t numThreads : { 1, 4, 8 }) {
+        SlotPool pool{ 1 << 16 };
+
+        auto directMs = MeasureMs([&]()
+        {
+            RunThreads(numThreads, numOps, [&pool]() { return pool.allocateDirect(); }, [&pool](uint32_t index) { pool.releaseDirect(index); });
+        });
+
+        auto cachedMs = MeasureMs([&]()
+        {
+            RunThreads(numThreads, numOps, [&pool]() { return pool.allocateCached(); }, [&pool](uint32_t index) { pool.releaseCached(index); });
+            pool.flushReleased();
+        });
+
+        auto fmt = boost::format("  %1% threads x %2% alloc/free: global lock %3$.2f ms, thread caches %4$.2f ms") % numThreads % numOps % directMs % cachedMs;
+
+        std::cout << boost::str(fmt) << std::endl;
+    }
+}
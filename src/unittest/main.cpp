@@ -25,6 +25,7 @@
 #include <boost/program_options.hpp>
 
 #include "test_framework.h"
+#include "core/core_test.h"
 #include "tests/01_simple_cube.h"
 
 int main(int ac, char** av)
@@ -41,6 +42,15 @@ int main(int ac, char** av)
     if (!ret.first)
         return 1;
 
+    // no GPU needed, nothing is worth rendering if those fail
+    if (!RunCoreTests())
+        return 1;
+
+    if (ret.second.bench) {
+        RunCoreBenchmarks();
+        return 0;
+    }
+
     // create window
     auto hWnd = MakeWindow(ret.second);
 
@@ -128,6 +138,7 @@ std::pair<bool, Options> ParseOptions(int ac, char** av)
 
     generic.add_options()
         ("help", "produce help message")
+        ("bench", boost::program_options::value<bool>()->default_value(false), "Run the CPU benchmarks then exit")
         ("ci", boost::program_options::value<bool>()->default_value(false), "CI mode (windowless)")
         ("output,o", boost::program_options::value<std::string>(), "Output results into a file as XML");
 
@@ -158,6 +169,7 @@ std::pair<bool, Options> ParseOptions(int ac, char** av)
     res.width = vm["width"].as<uint_fast32_t>();
     res.height = vm["height"].as<uint_fast32_t>();
     res.numThreads = vm["numThreads"].as<uint_fast32_t>();
+    res.bench = vm["bench"].as<bool>();
     res.ciMode = vm["ci"].as<bool>();
 
     if (vm.count("output")) {
@@ -30,6 +30,7 @@ struct Options
     uint_fast32_t width;
     uint_fast32_t height;
     uint_fast32_t numThreads;
+    bool bench;
     bool ciMode;
     std::string outFile;
 };
@@ -20,6 +20,7 @@
 
 #include "test_framework.h"
 
+#include <algorithm>
 #include <iostream>
 #include <takoyaki.h>
 #include <boost/crc.hpp>
@@ -44,6 +45,11 @@ void TestFramework::initialize(Takoyaki::FrameworkDesc& desc, bool ciMode)
 {
     ciMode_ = ciMode;
 
+    // the whole render target is read back every test, rows are 256 bytes aligned
+    auto rowPitch = ((uint_fast32_t)desc.windowSize.x * 4 + 255) & ~255;
+
+    desc.readbackPageSize = (std::max)(desc.readbackPageSize, rowPitch * (uint_fast32_t)desc.windowSize.y);
+
     takoyaki_->initialize(desc);
 
     renderer_ = takoyaki_->getRenderer();
@@ -57,19 +63,6 @@ void TestFramework::initialize(Takoyaki::FrameworkDesc& desc, bool ciMode)
     rtDesc.usage = Takoyaki::EUsageType::GPU_ONLY;
     rtDesc.flags = Takoyaki::RF_RENDERTARGET;
 
-    // texture used to copy the render target to make a checksum
-    Takoyaki::TextureDesc texDesc;
-
-    texDesc.format = Takoyaki::EFormat::B8G8R8A8_UNORM;
-    texDesc.width = (uint_fast32_t)desc.windowSize.x;
-    texDesc.height = (uint_fast32_t)desc.windowSize.y;
-    texDesc.usage = Takoyaki::EUsageType::GPU_ONLY;
-
-    tex_ = renderer_->createTexture(texDesc);
-
-    // cpu buffer to copy the texture into so we can checksum it
-    texCopy_.resize(tex_->getSizeByte());
-
     auto fmt = boost::format("Processing %1% tests..") % descs_.size();
 
     std::cout << boost::str(fmt) << std::endl;
@@ -120,34 +113,37 @@ bool TestFramework::process()
     // render the test
     test->update(renderer_.get());
     test->render(renderer_.get());
-    takoyaki_->present();
 
-    auto end = std::chrono::high_resolution_clock::now();
+    // copy the render target back once the test is done drawing into it
+    std::future<std::vector<uint8_t>> pixels;
 
-    // copy rendertarget into texCopy
     {
         auto cmd = renderer_->createCommand();
 
-        Takoyaki::CopyTexRegionParams params;
+        cmd->setSortKey(UINT64_MAX);
+        pixels = cmd->readTexture(renderer_->getDefaultRenderTarget());
+    }
+
+    takoyaki_->present();
 
-        params.dstHandle = tex_->getHandle();
-        params.srcHandle = renderer_->getDefaultRenderTarget();
+    auto end = std::chrono::high_resolution_clock::now();
 
-        cmd->copyTextureRegion(params);
-    }
+    // the data is handed over once the GPU is done with the frame, which takes a few more frames
+    while (pixels.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+        takoyaki_->present();
 
-    //tex_->read(&texCopy_.front(), (uint_fast32_t)texCopy_.size());
+    texCopy_ = pixels.get();
 
     // compare checksums
     boost::crc_32_type crc;
 
-    crc.process_bytes(&texCopy_.front(), texCopy_.size());
+    crc.process_bytes(texCopy_.data(), texCopy_.size());
 
-    // update results
-    auto outcome = crc.checksum() == std::get<1>(descs_[current_]);
+    // update results, nothing read back is a failure rather than the checksum of nothing
+    auto outcome = !texCopy_.empty() && (crc.checksum() == std::get<1>(descs_[current_]));
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-    updateTestResult(test.get(), outcome, duration);
+    updateTestResult(test.get(), outcome, duration, crc.checksum());
 
     ++current_;
 
@@ -166,7 +162,7 @@ void TestFramework::save(const std::string& filename)
     boost::property_tree::write_xml(path.generic_string(), pt_);
 }
 
-void TestFramework::updateTestResult(Test* test, bool result, std::chrono::milliseconds duration)
+void TestFramework::updateTestResult(Test* test, bool result, std::chrono::milliseconds duration, uint_fast32_t checksum)
 {
     boost::property_tree::ptree res;
 
@@ -181,10 +177,11 @@ void TestFramework::updateTestResult(Test* test, bool result, std::chrono::milli
 
     res.add("test.outcome", outcome);
     res.add("test.duration", duration.count());
+    res.add("test.checksum", boost::str(boost::format("0x%08x") % checksum));
     pt_.add_child("tests", res);
 
-    // also output some text to the console
-    auto fmt = boost::format("[%1%] %2%, %3%") % current_ % test->getName() % ((result) ? "Passed" : "Failed");
+    // also output some text to the console, the checksum is what to put in main.cpp once the output has been checked
+    auto fmt = boost::format("[%1%] %2%, %3% (checksum 0x%4$08x)") % current_ % test->getName() % ((result) ? "Passed" : "Failed") % checksum;
 
     std::cout << boost::str(fmt) << std::endl;
 }
\ No newline at end of file
@@ -48,12 +48,11 @@ public:
     inline void setTests(std::vector<TestDesc>& descs) { std::swap(descs_, descs); }
 
 private:
-    void updateTestResult(Test*, bool, std::chrono::milliseconds);
+    void updateTestResult(Test*, bool, std::chrono::milliseconds, uint_fast32_t);
 
 private:
     std::unique_ptr<Takoyaki::Framework> takoyaki_;
     std::unique_ptr<Takoyaki::Renderer> renderer_;
-    std::unique_ptr<Takoyaki::Texture> tex_;
     boost::property_tree::ptree pt_;
     std::vector<TestDesc> descs_;
     std::vector<uint8_t> texCopy_;